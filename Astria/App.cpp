@@ -13,9 +13,17 @@
 #include "TexturedCone.h"
 #include "TexturedSphere.h"
 #include "AssImpModel.h"
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
+#include "FrameCapture.h"
+#include "Codex.h"
+#include "GeometryCache.h"
+#include "PhongPermutation.h"
+#include "Model.h"
+#include "ObjectSystems.h"
+#include "PoolAllocator.h"
+#include "FrameAllocator.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include "GpuProfiler.h"
 
 GDIPlusManager gdipm;
 
@@ -25,63 +33,70 @@ App::App()
 	wnd(1200, 800, "Astria"),
 	light(wnd.Gfx())
 {
-	Assimp::Importer imp;
-	auto model = imp.ReadFile("models\\spider.obj", aiProcess_Triangulate | aiProcess_JoinIdenticalVertices);
-
 	class Factory {
 	public:
-		Factory(Graphics& gfx): gfx(gfx){}
+		Factory(Graphics& gfx, EntityWorld& world, std::vector<Box*>& boxes): gfx(gfx), world(world), boxes(boxes){}
 
 		std::unique_ptr<Drawable> operator()() {
+			// every object is animated and drawn through its entity
+			const auto attach = [this](auto pObject) -> std::unique_ptr<Drawable>
+			{
+				pObject->Attach(world);
+				return pObject;
+			};
 			const DirectX::XMFLOAT3 mat = { cdist(rng), cdist(rng), cdist(rng) };
 			switch (typedist(rng))
 			{
 			case 0:
-				return std::make_unique<Box>(
+			{
+				auto pBox = std::make_unique<Box>(
 					gfx, rng, adist, ddist,
 					odist, rdist, bdist, mat
 					);
+				boxes.push_back(pBox.get());
+				return attach(std::move(pBox));
+			}
 			case 1:
-				return std::make_unique<Cylinder>(
+				return attach(std::make_unique<Cylinder>(
 					gfx, rng, adist, ddist, odist,
 					rdist, latDist, longDist
-					);
+					));
 
 			case 2:
-				return std::make_unique<Cone>(
+				return attach(std::make_unique<Cone>(
 					gfx, rng, adist, ddist, odist,
 					rdist, latDist
-					);
+					));
 			case 3:
-				return std::make_unique<Sphere>(
+				return attach(std::make_unique<Sphere>(
 					gfx, rng, adist, ddist, odist,
 					rdist, latDist, longDist
-					);
+					));
 			case 4:
-				return std::make_unique<SkinnedBox>(
+				return attach(std::make_unique<SkinnedBox>(
 					gfx, rng, adist, ddist,
 					odist, rdist
-					);
+					));
 			case 5:
-				return std::make_unique<Sheet>(
+				return attach(std::make_unique<Sheet>(
 					gfx, rng, adist, ddist,
-					odist, rdist);
+					odist, rdist));
 			case 6:
-				return std::make_unique<TexturedCylinder>(
+				return attach(std::make_unique<TexturedCylinder>(
 					gfx, rng, adist, ddist,
-					odist, rdist, latDist, longDist);
+					odist, rdist, latDist, longDist));
 			case 7:
-				return std::make_unique<TexturedCone>(
+				return attach(std::make_unique<TexturedCone>(
 					gfx, rng, adist, ddist,
-					odist, rdist, longDist);
+					odist, rdist, longDist));
 			case 8:
-				return std::make_unique<TexturedSphere>(
+				return attach(std::make_unique<TexturedSphere>(
 					gfx, rng, adist, ddist,
-					odist, rdist, latDist, longDist);
+					odist, rdist, latDist, longDist));
 			case 9:
-				return std::make_unique<AssImpModel>(
+				return attach(std::make_unique<AssImpModel>(
 					gfx, rng, adist, ddist,
-					odist, rdist, mat,  1.5f);
+					odist, rdist, mat,  1.5f));
 			default:
 				assert(false && "impossible drawable option in factory");
 				return {};
@@ -90,6 +105,9 @@ App::App()
 
 	private:
 		Graphics& gfx;
+		EntityWorld& world;
+		// the factory knows which objects are boxes, so they need not be found again by type
+		std::vector<Box*>& boxes;
 		std::mt19937 rng{ std::random_device{}() };
 		std::uniform_real_distribution<float> adist{ 0.0f, 3.1415f * 2.0f };
 		std::uniform_real_distribution<float> ddist{0.0f, 3.1415f * 2.0f};
@@ -102,21 +120,21 @@ App::App()
 		std::uniform_int_distribution<int> typedist{ 8, 9};
 	};
 
-	drawables.reserve(nDrawables);
-	std::generate_n(std::back_inserter(drawables), nDrawables, Factory{wnd.Gfx()});
-
-	for (auto& pd : drawables)
 	{
-		if (auto pb = dynamic_cast<Box*>(pd.get()))
-		{
-			boxes.push_back(pb);
-		}
+		// geometry, textures and shaders the objects create are charged to their own subsystems
+		MemoryTracker::Scope scope(MemoryTracker::Subsystem::Drawables);
+		drawables.reserve(nDrawables);
+		std::generate_n(std::back_inserter(drawables), nDrawables, Factory{wnd.Gfx(),world,boxes});
 	}
 
 	/*if (boxes.size() > 0) {
 		comboBoxIndex = 0;
 	}*/
 
+	// every part of the spider is its own node and mesh, the file is about 200 units across
+	pSpider = std::make_unique<Model>(wnd.Gfx(), "models\\spider.obj");
+	pSpider->SetRootTransform(DirectX::XMMatrixScaling(0.03f, 0.03f, 0.03f));
+
 	wnd.Gfx().SetProjection(DirectX::XMMatrixPerspectiveLH(1.0f, 3.0f / 4.0f, 0.5f, 40.0f));
 }
 
@@ -146,35 +164,128 @@ void App::DoFrame()
 	light.Bind(wnd.Gfx(), cam.GetMatrix());
 
 
-	for (auto& d : drawables)
+	ObjectSystems::Animate(world, wnd.kbd.KeyIsPressed(VK_SPACE) ? 0.0f : dt / 3);
 	{
-		d->Update(wnd.kbd.KeyIsPressed(VK_SPACE) ? 0.0f : dt / 3);
-		d->Draw(wnd.Gfx());
+		PROFILE_GPU_PASS(wnd.Gfx(), "Objects");
+		ObjectSystems::Draw(world, wnd.Gfx());
 	}
 
-	light.Draw(wnd.Gfx());
+	{
+		PROFILE_ZONE("Model");
+		PROFILE_GPU_PASS(wnd.Gfx(), "Model");
+		pSpider->Draw(wnd.Gfx());
+	}
+	{
+		PROFILE_ZONE("Light");
+		PROFILE_GPU_PASS(wnd.Gfx(), "Light");
+		light.Draw(wnd.Gfx());
+	}
 
 
-	SpawnSimulationWindow();
-	
-	//imgui window to control camera
-	cam.SpawnControlWindow();
-	light.SpawnControlWindow();
+	{
+		PROFILE_ZONE("ImGui");
+		SpawnSimulationWindow();
+		SpawnMemoryWindow();
+		Profiler::SpawnWindow();
+		wnd.Gfx().GetGpuProfiler().SpawnWindow();
+
+		//imgui window to control camera
+		cam.SpawnControlWindow();
+		light.SpawnControlWindow();
+		wnd.Gfx().GetShaderManager().SpawnControlWindow();
 
-	SpawnBoxWindowManagerWindow();
-	SpawnBoxWindows();
+		SpawnBoxWindowManagerWindow();
+		SpawnBoxWindows();
+	}
 
 	wnd.Gfx().EndFrame();
 } 
 
 
-void App::SpawnSimulationWindow() noexcept
+void App::SpawnSimulationWindow()
 {
 	if (ImGui::Begin("Simulation Speed"))
 	{
 		ImGui::SliderFloat("Speed Factor", &speed_factor, 0.0f, 6.0f, "%.4f", 3.2f);
 		ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
 		ImGui::Text("Status: %s", wnd.kbd.KeyIsPressed(VK_SPACE) ? "PAUSED" : "RUNNING (hold spacebar to pause)");
+		if (ImGui::Button("Capture Frame"))
+		{
+			wnd.Gfx().CaptureFrame("capture_" + std::to_string(captureCount++) + ".png");
+		}
+		// the trace is written once the capture has seen all its frames
+		if (ImGui::Button("Capture Trace") && !Profiler::IsCapturing())
+		{
+			Profiler::StartCapture(traceFrames);
+			tracePending = true;
+		}
+		if (tracePending && !Profiler::IsCapturing())
+		{
+			Profiler::ExportChromeTrace("trace_" + std::to_string(traceCount++) + ".json");
+			tracePending = false;
+		}
+		if (const auto pCapture = wnd.Gfx().GetFrameCapture())
+		{
+			const auto stats = pCapture->GetStats();
+			ImGui::Text("Captures: %zu written, %zu failed, %zu deferred", stats.written, stats.failed, stats.deferred);
+			ImGui::Text("Last encode: %.2f ms", stats.lastEncodeMs);
+		}
+		const auto codex = Codex::GetStats();
+		ImGui::Text("Codex: %zu shared binds, %zu hits, %zu misses", codex.entries, codex.hits, codex.misses);
+		ImGui::Text("Codex: %.1f KB resident, %.1f KB saved", codex.residentBytes / 1024.0f, codex.savedBytes / 1024.0f);
+		const auto geometry = GeometryCache::GetStats();
+		ImGui::Text("Geometry: %zu meshes, %zu hits, %zu builds", geometry.entries, geometry.hits, geometry.misses);
+		ImGui::Text("Geometry: %.1f KB resident, %.1f KB saved", geometry.residentBytes / 1024.0f, geometry.savedBytes / 1024.0f);
+		const auto phong = PhongPermutation::GetStats();
+		ImGui::Text("Phong: %zu permutations, %zu VS, %zu PS", phong.permutations, phong.vertexShaders, phong.pixelShaders);
+		const auto entities = world.GetStats();
+		ImGui::Text("Entities: %zu in %zu archetypes, %zu chunks", entities.entities, entities.archetypes, entities.chunks);
+		const auto pools = PoolAllocator::GetTotals();
+		ImGui::Text("Pools: %zu objects live in %zu pools, %.1f KB reserved", pools.live, pools.pools, pools.reservedBytes / 1024.0f);
+		const auto frame = FrameAllocator::GetStats();
+		ImGui::Text("Heap: %zu allocations last frame", frame.heapAllocations);
+		ImGui::Text("Scratch: %.1f KB last frame, %.1f KB overflowed", frame.scratchBytes / 1024.0f, frame.overflowBytes / 1024.0f);
+	}
+	ImGui::End();
+}
+
+void App::SpawnMemoryWindow()
+{
+	if (ImGui::Begin("Memory"))
+	{
+		using Tracker = MemoryTracker;
+		const auto cell = [](const char* format, auto value)
+		{
+			ImGui::Text(format, value);
+			ImGui::NextColumn();
+		};
+		ImGui::Columns(5, "memory");
+		for (const auto header : { "Subsystem","CPU KB","CPU peak KB","GPU KB","GPU peak KB" })
+		{
+			cell("%s", header);
+		}
+		ImGui::Separator();
+		for (size_t s = 0; s < Tracker::subsystemCount; s++)
+		{
+			const auto subsystem = Tracker::Subsystem(s);
+			const auto cpu = Tracker::GetUsage(subsystem, Tracker::Kind::Cpu);
+			const auto gpu = Tracker::GetUsage(subsystem, Tracker::Kind::Gpu);
+			cell("%s", Tracker::GetName(subsystem));
+			cell("%.1f", cpu.bytes / 1024.0f);
+			cell("%.1f", cpu.peak / 1024.0f);
+			cell("%.1f", gpu.bytes / 1024.0f);
+			cell("%.1f", gpu.peak / 1024.0f);
+		}
+		ImGui::Columns(1);
+		if (ImGui::Button("Export CSV"))
+		{
+			Tracker::ExportCsv("memory_" + std::to_string(memoryExportCount++) + ".csv");
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Export JSON"))
+		{
+			Tracker::ExportJson("memory_" + std::to_string(memoryExportCount++) + ".json");
+		}
 	}
 	ImGui::End();
 }
@@ -4,6 +4,7 @@
 #include "ImguiManager.h"
 #include "Camera.h"
 #include "PointLight.h"
+#include "EntityWorld.h"
 #include <set>
 
 class App
@@ -15,19 +16,28 @@ public:
 	~App();
 private:
 	void DoFrame();
-	void SpawnSimulationWindow() noexcept;
+	void SpawnSimulationWindow();
+	void SpawnMemoryWindow();
 	void SpawnBoxWindowManagerWindow() noexcept;
 	void SpawnBoxWindows() noexcept;
 private:
 	ImguiManager imgui;
 	Window wnd;
 	AstriaTimer timer;
+	// declared before the drawables, which remove their entities when destroyed
+	EntityWorld world;
 	std::vector<std::unique_ptr<class Drawable>> drawables;
 	std::vector<class Box*> boxes;
+	std::unique_ptr<class Model> pSpider;
 	static constexpr size_t nDrawables = 20;
 	float speed_factor = 1.0f;
 	Camera cam;
 	PointLight light;
 	std::optional<int> comboBoxIndex;
 	std::set<int> boxControlIds;
+	unsigned int captureCount = 0u;
+	unsigned int memoryExportCount = 0u;
+	unsigned int traceCount = 0u;
+	bool tracePending = false;
+	static constexpr size_t traceFrames = 120u;
 };
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "AssImpModel.h"
 #include "BindableBase.h"
+#include "PhongPermutation.h"
+#include "VertexQuantizer.h"
+#include "FrameAllocator.h"
 #include "GraphicsThrowMacros.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -36,13 +39,14 @@ AssImpModel::AssImpModel(Graphics& gfx, std::mt19937& rng,
 		);
 		const auto pMesh = pModel->mMeshes[0];
 
-		for (unsigned int i = 0; i < pMesh->mNumVertices; i++)
+		// one allocation, then whole attribute arrays streamed into their slots
+		vbuf.Resize(pMesh->mNumVertices);
+		vbuf.GenerateStream<VertexLayout::Position3D>(pMesh->mNumVertices, [pMesh, scale](size_t i)
 		{
-			vbuf.EmplaceBack(
-				dx::XMFLOAT3{ pMesh->mVertices[i].x * scale,pMesh->mVertices[i].y * scale,pMesh->mVertices[i].z * scale },
-				*reinterpret_cast<dx::XMFLOAT3*>(&pMesh->mNormals[i])
-			);
-		}
+			return dx::XMFLOAT3{ pMesh->mVertices[i].x * scale,pMesh->mVertices[i].y * scale,pMesh->mVertices[i].z * scale };
+		});
+		static_assert(sizeof(aiVector3D) == sizeof(dx::XMFLOAT3), "aiVector3D must be 3 packed floats");
+		vbuf.WriteStream<VertexLayout::Normal>(reinterpret_cast<const dx::XMFLOAT3*>(pMesh->mNormals), pMesh->mNumVertices);
 
 		std::vector<unsigned short> indices;
 		indices.reserve(pMesh->mNumFaces * 3);
@@ -55,19 +59,19 @@ AssImpModel::AssImpModel(Graphics& gfx, std::mt19937& rng,
 			indices.push_back(face.mIndices[2]);
 		}
 
-		AddStaticBind(std::make_unique<VertexBuffer>(gfx, vbuf));
+		// snorm16 positions and 10:10:10:2 normals, 24 bytes per vertex down to 12
+		const auto packed = VertexQuantizer::Quantize(vbuf);
+		AddStaticBind(std::make_unique<VertexBuffer>(gfx, packed.vertices));
+		AddStaticBind(std::make_unique<VertexConstantBuffer<VertexQuantizer::Dequantization>>(gfx, packed.dequantization, 1u));
 
 		AddStaticIndexBuffer(std::make_unique<IndexBuffer>(gfx, indices));
 
-		auto pvs = std::make_unique<VertexShader>(gfx, L"PhongVS.cso");
-		auto pvsbc = pvs->GetBytecode();
-		AddStaticBind(std::move(pvs));
-
-		AddStaticBind(std::make_unique<PixelShader>(gfx, L"PhongPS.cso"));
-
-		AddStaticBind(std::make_unique<InputLayout>(gfx, vbuf.GetLayout().GetD3DLayout(), pvsbc));
+		const auto& phong = PhongPermutation::Resolve(gfx, PhongPermutation::FeaturesFromLayout(packed.vertices.GetLayout()));
+		AddStaticBind(phong.pVertexShader);
+		AddStaticBind(phong.pPixelShader);
+		AddStaticBind(Codex::Resolve<InputLayout>(gfx, packed.vertices.GetLayout().GetD3DLayout(FrameAllocator::Get()), phong.pVertexShader->GetBytecode()));
 
-		AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		AddStaticBind(Codex::Resolve<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
 
 		struct PSMaterialConstant
 		{
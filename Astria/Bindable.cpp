@@ -1,4 +1,23 @@
 #include "Bindable.h"
+#include "PoolAllocator.h"
+
+void* Bindable::operator new(size_t size)
+{
+	const auto pPool = PoolAllocator::ForSize(size);
+	return pPool != nullptr ? pPool->Allocate() : ::operator new(size);
+}
+
+void Bindable::operator delete(void* p, size_t size) noexcept
+{
+	if (const auto pPool = PoolAllocator::ForSize(size))
+	{
+		pPool->Free(p);
+	}
+	else
+	{
+		::operator delete(p);
+	}
+}
 
 ID3D11DeviceContext* Bindable::GetContext(Graphics& gfx) noexcept
 {
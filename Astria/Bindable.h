@@ -6,6 +6,9 @@ class Bindable
 public:
 	virtual void Bind(Graphics& gfx) noexcept = 0;
 	virtual ~Bindable() = default;
+	// small bindables (constant buffers, per instance binds) come from size class pools
+	static void* operator new(size_t size);
+	static void operator delete(void* p, size_t size) noexcept;
 protected:
 	static ID3D11DeviceContext* GetContext(Graphics& gfx) noexcept;
 	static ID3D11Device* GetDevice(Graphics& gfx) noexcept;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Codex.h"
 #include "ConstantBuffers.h"
 #include "IndexBuffer.h"
 #include "InputLayout.h"
@@ -0,0 +1,21 @@
+#include "BindableSet.h"
+
+std::atomic<unsigned int> BindableSet::typeCount = 0u;
+
+void BindableSet::Bind(Graphics& gfx) const noexcept
+{
+	for (const auto& b : binds)
+	{
+		b->Bind(gfx);
+	}
+}
+
+bool BindableSet::Empty() const noexcept
+{
+	return binds.empty();
+}
+
+size_t BindableSet::Size() const noexcept
+{
+	return binds.size();
+}
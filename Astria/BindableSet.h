@@ -0,0 +1,50 @@
+#pragma once
+#include "Bindable.h"
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// bindables of a drawable in a dense array for binding, plus a slot per bindable type for lookups
+// every type gets a small id the first time it is stored, Get<T> is an index into the slots instead of a
+// dynamic_cast over the array; types are matched exactly, a bindable is not found through a base class
+class BindableSet
+{
+public:
+	template<class T>
+	void Add(std::shared_ptr<T> bind) noexcept(!IS_DEBUG)
+	{
+		static_assert(std::is_base_of<Bindable, T>::value, "Can only store classes derived from Bindable");
+		const auto id = TypeId<T>();
+		if (id >= slots.size())
+		{
+			slots.resize(size_t(id) + 1u, nullptr);
+		}
+		// the first bindable of a type keeps the slot, as the first match of the old scan did
+		if (slots[id] == nullptr)
+		{
+			slots[id] = bind.get();
+		}
+		binds.push_back(std::move(bind));
+	}
+	template<class T>
+	T* Get() const noexcept
+	{
+		const auto id = TypeId<T>();
+		return id < slots.size() ? static_cast<T*>(slots[id]) : nullptr;
+	}
+	void Bind(Graphics& gfx) const noexcept;
+	bool Empty() const noexcept;
+	size_t Size() const noexcept;
+	template<class T>
+	static unsigned int TypeId() noexcept
+	{
+		static const unsigned int id = typeCount++;
+		return id;
+	}
+private:
+	std::vector<std::shared_ptr<Bindable>> binds;
+	// per type id, the first bindable of that type or nullptr
+	std::vector<Bindable*> slots;
+	static std::atomic<unsigned int> typeCount;
+};
@@ -1,5 +1,6 @@
 #include "Box.h"
 #include "BindableBase.h"
+#include "PhongPermutation.h"
 #include "GraphicsThrowMacros.h"
 #include "Cube.h"
 #include "imgui/imgui.h"
@@ -23,12 +24,6 @@ Box::Box(Graphics& gfx, std::mt19937& rng, std::uniform_real_distribution<float>
 
 		AddStaticBind(std::make_unique<VertexBuffer>(gfx, model.vertices));
 
-		auto pvs = std::make_unique<VertexShader>(gfx, L"PhongVS.cso");
-		auto pvsbc = pvs->GetBytecode();
-		AddStaticBind(std::move(pvs));
-
-		AddStaticBind(std::make_unique<PixelShader>(gfx, L"PhongPS.cso"));
-
 		AddStaticIndexBuffer(std::make_unique<IndexBuffer>(gfx, model.indices));
 		
 		const std::vector<D3D11_INPUT_ELEMENT_DESC> ied =
@@ -37,9 +32,12 @@ Box::Box(Graphics& gfx, std::mt19937& rng, std::uniform_real_distribution<float>
 			{ "Normal",0,DXGI_FORMAT_R32G32B32_FLOAT,0,12,D3D11_INPUT_PER_VERTEX_DATA,0 },
 		};
 
-		AddStaticBind(std::make_unique<InputLayout>(gfx, ied, pvsbc));
+		const auto& phong = PhongPermutation::Resolve(gfx, PhongPermutation::FeaturesFromLayout(ied));
+		AddStaticBind(phong.pVertexShader);
+		AddStaticBind(phong.pPixelShader);
+		AddStaticBind(Codex::Resolve<InputLayout>(gfx, ied, phong.pVertexShader->GetBytecode()));
 
-		AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		AddStaticBind(Codex::Resolve<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
 	}
 	else
 	{
@@ -79,14 +77,15 @@ bool Box::SpawnControlWindow(int id, Graphics& gfx) noexcept
 		const auto spd = ImGui::SliderFloat("Specular Power", &materialConstants.specularPower, 1.0f, 200.0f, "%.2f", 2);
 		dirty = cd || sid || spd;
 
+		auto& orbit = GetOrbit();
 		ImGui::Text("Position");
-		ImGui::SliderFloat("R", &r, 0.0f, 80.0f, "%.1f");
-		ImGui::SliderAngle("Theta", &theta, -180.0f, 180.0f);
-		ImGui::SliderAngle("Phi", &phi, -180.0f, 180.0f);
+		ImGui::SliderFloat("R", &orbit.r, 0.0f, 80.0f, "%.1f");
+		ImGui::SliderAngle("Theta", &orbit.theta, -180.0f, 180.0f);
+		ImGui::SliderAngle("Phi", &orbit.phi, -180.0f, 180.0f);
 		ImGui::Text("Orientation");
-		ImGui::SliderAngle("Roll", &roll, -180.0f, 180.0f);
-		ImGui::SliderAngle("Pitch", &pitch, -180.0f, 180.0f);
-		ImGui::SliderAngle("Yaw", &yaw, -180.0f, 180.0f);
+		ImGui::SliderAngle("Roll", &orbit.roll, -180.0f, 180.0f);
+		ImGui::SliderAngle("Pitch", &orbit.pitch, -180.0f, 180.0f);
+		ImGui::SliderAngle("Yaw", &orbit.yaw, -180.0f, 180.0f);
 	}
 	ImGui::End();
 
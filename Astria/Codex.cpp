@@ -0,0 +1,52 @@
+#include "Codex.h"
+
+Codex::Stats Codex::GetStats() noexcept
+{
+	auto& codex = Get();
+	std::lock_guard<std::mutex> lock(codex.mutex);
+	return codex.stats;
+}
+
+void Codex::Prune() noexcept
+{
+	auto& codex = Get();
+	std::lock_guard<std::mutex> lock(codex.mutex);
+	for (auto i = codex.binds.begin(); i != codex.binds.end();)
+	{
+		if (i->second.pBind.use_count() == 1)
+		{
+			codex.stats.entries--;
+			codex.stats.residentBytes -= i->second.bytes;
+			i = codex.binds.erase(i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+std::string Codex::Narrow(const std::wstring& s)
+{
+	// shader paths are plain ascii, anything wider just has to stay unique
+	std::string out;
+	out.reserve(s.size());
+	for (const auto c : s)
+	{
+		if (c < 0x80)
+		{
+			out.push_back(char(c));
+		}
+		else
+		{
+			out += "\\u" + std::to_string(unsigned(c));
+		}
+	}
+	return out;
+}
+
+Codex& Codex::Get() noexcept
+{
+	static Codex codex;
+	return codex;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Bindable.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+// registry of shareable bindables keyed by (type, construction parameters)
+// a bindable opts in by providing static std::string GenerateUID(params...) matching its constructor
+class Codex
+{
+public:
+	struct Stats
+	{
+		size_t hits = 0u;
+		size_t misses = 0u;
+		size_t entries = 0u;
+		// estimated bytes held once by the codex (object + shader bytecode)
+		size_t residentBytes = 0u;
+		// estimated bytes a private copy per request would have cost on top of that
+		size_t savedBytes = 0u;
+	};
+public:
+	template<class T, typename...Params>
+	static std::shared_ptr<T> Resolve(Graphics& gfx, Params&&...p)
+	{
+		static_assert(std::is_base_of<Bindable, T>::value, "Can only resolve classes derived from Bindable");
+		return Get().ResolveImpl<T>(gfx, std::forward<Params>(p)...);
+	}
+	static Stats GetStats() noexcept;
+	// drops every entry the codex is the last owner of
+	static void Prune() noexcept;
+	static std::string Narrow(const std::wstring& s);
+private:
+	struct Entry
+	{
+		std::shared_ptr<Bindable> pBind;
+		size_t bytes;
+	};
+private:
+	template<class T, typename...Params>
+	std::shared_ptr<T> ResolveImpl(Graphics& gfx, Params&&...p)
+	{
+		const auto key = std::string(typeid(T).name()) + "#" + T::GenerateUID(p...);
+		std::lock_guard<std::mutex> lock(mutex);
+		const auto i = binds.find(key);
+		if (i != binds.end())
+		{
+			stats.hits++;
+			stats.savedBytes += i->second.bytes;
+			return std::static_pointer_cast<T>(i->second.pBind);
+		}
+		auto pBind = std::make_shared<T>(gfx, std::forward<Params>(p)...);
+		size_t bytes = sizeof(T);
+		if constexpr (requires(const T& t) { t.GetBytecode(); })
+		{
+			bytes += pBind->GetBytecode()->GetBufferSize();
+		}
+		binds.emplace(key, Entry{ pBind,bytes });
+		stats.misses++;
+		stats.entries++;
+		stats.residentBytes += bytes;
+		return pBind;
+	}
+	static Codex& Get() noexcept;
+private:
+	std::mutex mutex;
+	std::unordered_map<std::string, Entry> binds;
+	Stats stats;
+};
@@ -1,6 +1,8 @@
 #include "Cone.h"
 #include "ConeVertices.h"
 #include "BindableBase.h"
+#include "PhongPermutation.h"
+#include "GeometryCache.h"
 #include "GraphicsThrowMacros.h"
 #include <array>
 
@@ -11,12 +13,6 @@ Cone::Cone(Graphics& gfx, std::mt19937& rng, std::uniform_real_distribution<floa
 	namespace dx = DirectX;
 	if (!IsStaticInitialized()) {
 
-		auto pvs = std::make_unique<VertexShader>(gfx, L"BlendedPhongVS.cso");
-		auto pvsbc = pvs->GetBytecode();
-		AddStaticBind(std::move(pvs));
-
-		AddStaticBind(std::make_unique<PixelShader>(gfx, L"BlendedPhongPS.cso"));
-
 		
 		const std::vector<D3D11_INPUT_ELEMENT_DESC> ied =
 		{
@@ -25,9 +21,12 @@ Cone::Cone(Graphics& gfx, std::mt19937& rng, std::uniform_real_distribution<floa
 			{ "Color",0,DXGI_FORMAT_R8G8B8A8_UNORM,0,24,D3D11_INPUT_PER_VERTEX_DATA,0}
 		};
 
-		AddStaticBind(std::make_unique<InputLayout>(gfx, ied, pvsbc));
+		const auto& phong = PhongPermutation::Resolve(gfx, PhongPermutation::FeaturesFromLayout(ied));
+		AddStaticBind(phong.pVertexShader);
+		AddStaticBind(phong.pPixelShader);
+		AddStaticBind(Codex::Resolve<InputLayout>(gfx, ied, phong.pVertexShader->GetBytecode()));
 
-		AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		AddStaticBind(Codex::Resolve<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
 
 		struct PSMaterialConstant {
 			float specularIntensity = 0.6f;
@@ -47,21 +46,23 @@ Cone::Cone(Graphics& gfx, std::mt19937& rng, std::uniform_real_distribution<floa
 	};
 
 	int tessalations = longDist(rng);
-	auto model = ConeVertices::MakeTesselatedIndependentFaces<Vertex>(tessalations);
-
-	for (auto& vertex : model.vertices) {
-		vertex.color = { (char)10,(char)10,(char)255 };
-	}
-
+	const auto mesh = GeometryCache::Resolve<Vertex>(gfx, "Cone.IndependentFaces.Colored", [](int longDiv)
+	{
+		auto model = ConeVertices::MakeTesselatedIndependentFaces<Vertex>(longDiv);
 
-	model.vertices[model.vertices.size()-1].color = { (char)255,(char)10,(char)10 };
+		for (auto& vertex : model.vertices) {
+			vertex.color = { (char)10,(char)10,(char)255 };
+		}
 
+		model.vertices[model.vertices.size()-1].color = { (char)255,(char)10,(char)10 };
 
-	/*model.SetNormalsIndependentFlat();*/
+		/*model.SetNormalsIndependentFlat();*/
+		return model;
+	}, tessalations);
 
-	AddBind(std::make_unique<VertexBuffer>(gfx, model.vertices));
+	AddBind(mesh.pVertexBuffer);
 
-	AddIndexBuffer(std::make_unique<IndexBuffer>(gfx, model.indices));
+	AddIndexBuffer(mesh.pIndexBuffer);
 
 	AddBind(std::make_unique<TransformCbuf>(gfx, *this));
 }
@@ -2,216 +2,147 @@
 #include "IndexedTriangleList.h"
 #include <DirectXMath.h>
 #include "AstriaMath.h"
+#include <cmath>
+#include <span>
 
-
+// the base ring is walked by incremental rotation instead of building a rotation matrix per vertex
+// the Fill* variants write into caller provided storage sized with the *VertexCount/*IndexCount helpers
 class ConeVertices
 {
 public:
-	template<class V>
-	static IndexedTriangleList<V> MakeTesselated(int longDiv)
+	static size_t TesselatedVertexCount(int longDiv) noexcept
 	{
-		namespace dx = DirectX;
-		assert(longDiv >= 3);
-
-		const auto base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
-		const float longitudeAngle = 2.0f * PI / longDiv;
-
-		// base vertices
-		std::vector<V> vertices;
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-		}
-		// the center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,-1.0f };
-		const auto iCenter = (unsigned short)(vertices.size() - 1);
-		// the tip :darkness:
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,1.0f };
-		const auto iTip = (unsigned short)(vertices.size() - 1);
-
-
-		// base indices
-		std::vector<unsigned short> indices;
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
-		{
-			indices.push_back(iCenter);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iLong);
-		}
+		return size_t(longDiv) + 2u;
+	}
+	// the independent variants duplicate the base ring so the sides get their own normals
+	static size_t TesselatedIndependentVertexCount(int longDiv) noexcept
+	{
+		return size_t(longDiv) * 2u + 2u;
+	}
+	static size_t TesselatedIndexCount(int longDiv) noexcept
+	{
+		return size_t(longDiv) * 6u;
+	}
 
-		// cone indices
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
-		{
-			indices.push_back(iLong);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iTip);
-		}
+	template<class V>
+	static void FillTesselated(int longDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		Fill<V, false, false>(longDiv, vertices, indices);
+	}
+	template<class V>
+	static void FillTesselatedIndependentFaces(int longDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		Fill<V, true, false>(longDiv, vertices, indices);
+	}
+	template<class V>
+	static void FillTesselatedIndependentTextureFaces(int longDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		Fill<V, true, true>(longDiv, vertices, indices);
+	}
 
-		return { std::move(vertices),std::move(indices) };
+	template<class V>
+	static IndexedTriangleList<V> MakeTesselated(int longDiv)
+	{
+		return Make<V, false, false>(longDiv);
 	}
 
 	template<class V>
 	static IndexedTriangleList<V> MakeTesselatedIndependentFaces(int longDiv)
 	{
-		namespace dx = DirectX;
-		assert(longDiv >= 3);
-
-		const auto base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
-		const float longitudeAngle = 2.0f * PI / longDiv;
-
-		// base vertices
-		std::vector<V> vertices;
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-			vertices.back().n = { 0.0f,0.0f,-1.0f };
-		}
-
-		////duplicate base for outwards normals
-		const auto iBase2 = (unsigned short)(vertices.size());
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-			vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,0.0f };
-		}
-
-		// the center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,-1.0f };
-		vertices.back().n = { 0.0f,0.0f,-1.0f };
-		const auto iCenter = (unsigned short)(vertices.size() - 1);
-		// the tip :darkness:
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,1.0f };
-		vertices.back().n = { 0.0f,0.0f,1.0f };
-		const auto iTip = (unsigned short)(vertices.size() - 1);
-
-
-		// base indices
-		std::vector<unsigned short> indices;
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
-		{
-			indices.push_back(iCenter);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iLong);
-		}
-
-		// cone indices
-		for (unsigned short iLong = iBase2; iLong < longDiv+ iBase2; iLong++)
-		{
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv)+iBase2);
-			indices.push_back(iTip);
-		}
-
-		return { std::move(vertices),std::move(indices) };
+		return Make<V, true, false>(longDiv);
 	}
 
 	template<class V>
 	static IndexedTriangleList<V> MakeTesselatedIndependentTextureFaces(int longDiv)
 	{
-		namespace dx = DirectX;
-		assert(longDiv >= 3);
-
-		const auto base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
-		const float longitudeAngle = 2.0f * PI / longDiv;
-
-		const auto txc_center = dx::XMVectorSet(0.5f, 0.5f, 0.0f, 0.0f);
-		const auto txc_base = dx::XMVectorSet(1, 0.5f, 0.0f, 0.0f);
-
-		// base vertices
-		std::vector<V> vertices;
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-
-			auto t = dx::XMVectorAdd(
-				dx::XMVector2Transform(dx::XMVectorSubtract(txc_base, txc_center), dx::XMMatrixRotationZ(longitudeAngle * iLong)),
-				txc_center);
+		return Make<V, true, true>(longDiv);
+	}
 
-			vertices.back().n = { 0.0f,0.0f,-1.0f };
-			dx::XMStoreFloat2(&vertices.back().tc, t);
-		}
+	template<class V>
+	static IndexedTriangleList<V> Make()
+	{
+		return MakeTesselated<V>(24);
+	}
+private:
+	template<class V, bool independent, bool texcoords>
+	static IndexedTriangleList<V> Make(int longDiv)
+	{
+		std::vector<V> vertices(independent ? TesselatedIndependentVertexCount(longDiv) : TesselatedVertexCount(longDiv));
+		std::vector<unsigned short> indices(TesselatedIndexCount(longDiv));
+		Fill<V, independent, texcoords>(longDiv, vertices, indices);
+		return { std::move(vertices),std::move(indices) };
+	}
 
-		////duplicate base for outwards normals
-		const auto iBase2 = (unsigned short)(vertices.size());
-		for (int iLong = 0; iLong < longDiv; iLong++)
+	template<class V, bool independent, bool texcoords>
+	static void Fill(int longDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		assert(longDiv >= 3);
+		assert(vertices.size() == (independent ? TesselatedIndependentVertexCount(longDiv) : TesselatedVertexCount(longDiv)));
+		assert(indices.size() == TesselatedIndexCount(longDiv));
+		assert("Too many vertices for 16-bit indices" && vertices.size() <= 0x10000u);
+
+		const auto ring = size_t(longDiv);
+		const double longitudeAngle = 2.0 * PI_D / longDiv;
+		const double cosStep = std::cos(longitudeAngle);
+		const double sinStep = std::sin(longitudeAngle);
+
+		// base vertices, plus the duplicate facing outwards for the independent variants
+		// double keeps the drift of the incremental rotation far below float precision
+		double c = 1.0;
+		double s = 0.0;
+		for (size_t iLong = 0u; iLong < ring; iLong++)
 		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-
-			auto t = dx::XMVectorAdd(
-				dx::XMVector2Transform(dx::XMVectorSubtract(txc_base, txc_center), dx::XMMatrixRotationZ(longitudeAngle * iLong)),
-				txc_center);
-
-			vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,0.0f };
-			dx::XMStoreFloat2(&vertices.back().tc, t);
+			auto& v = vertices[iLong];
+			v.pos = { float(c),float(s),-1.0f };
+			if constexpr (texcoords)
+			{
+				v.tc = { 0.5f + 0.5f * float(c),0.5f + 0.5f * float(s) };
+			}
+			if constexpr (independent)
+			{
+				v.n = { 0.0f,0.0f,-1.0f };
+				auto& side = vertices[ring + iLong];
+				side = v;
+				side.n = { float(c),float(s),0.0f };
+			}
+			const double next = c * cosStep - s * sinStep;
+			s = s * cosStep + c * sinStep;
+			c = next;
 		}
+		const size_t iBase2 = independent ? ring : 0u;
 
 		// the center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,-1.0f };
-		vertices.back().n = { 0.0f,0.0f,-1.0f };
-		vertices.back().tc = { 0.5f, 0.5f };
-		const auto iCenter = (unsigned short)(vertices.size() - 1);
+		const auto iCenter = (unsigned short)(iBase2 + ring);
+		vertices[iCenter].pos = { 0.0f,0.0f,-1.0f };
 		// the tip :darkness:
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,1.0f };
-		vertices.back().n = { 0.0f,0.0f,1.0f };
-		vertices.back().tc = { 0.5f, 0.5f };
-		const auto iTip = (unsigned short)(vertices.size() - 1);
-
+		const auto iTip = (unsigned short)(iBase2 + ring + 1u);
+		vertices[iTip].pos = { 0.0f,0.0f,1.0f };
+		if constexpr (independent)
+		{
+			vertices[iCenter].n = { 0.0f,0.0f,-1.0f };
+			vertices[iTip].n = { 0.0f,0.0f,1.0f };
+		}
+		if constexpr (texcoords)
+		{
+			vertices[iCenter].tc = { 0.5f,0.5f };
+			vertices[iTip].tc = { 0.5f,0.5f };
+		}
 
+		size_t i = 0u;
 		// base indices
-		std::vector<unsigned short> indices;
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
+		for (size_t iLong = 0u; iLong < ring; iLong++)
 		{
-			indices.push_back(iCenter);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iLong);
+			indices[i++] = iCenter;
+			indices[i++] = (unsigned short)((iLong + 1u) % ring);
+			indices[i++] = (unsigned short)iLong;
 		}
 
 		// cone indices
-		for (unsigned short iLong = iBase2; iLong < longDiv + iBase2; iLong++)
+		for (size_t iLong = 0u; iLong < ring; iLong++)
 		{
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + iBase2);
-			indices.push_back(iTip);
+			indices[i++] = (unsigned short)(iBase2 + iLong);
+			indices[i++] = (unsigned short)(iBase2 + (iLong + 1u) % ring);
+			indices[i++] = iTip;
 		}
-
-		return { std::move(vertices),std::move(indices) };
-	}
-
-
-	template<class V>
-	static IndexedTriangleList<V> Make()
-	{
-		return MakeTesselated<V>(24);
 	}
-};
\ No newline at end of file
+};
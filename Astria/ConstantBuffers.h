@@ -1,6 +1,7 @@
 #pragma once
 #include "Bindable.h"
 #include "GraphicsThrowMacros.h"
+#include "MemoryTracker.h"
 
 template<typename C>
 class ConstantBuffer : public Bindable {
@@ -29,6 +30,7 @@ public:
 		csd.pSysMem = &consts;
 
 		GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&cbd, &csd, &pConstantBuffer));
+		gpuMemory.Set(cbd.ByteWidth);
 	}
 
 	ConstantBuffer(Graphics& gfx, UINT slot = 0u) : slot(slot) {
@@ -43,11 +45,13 @@ public:
 		cbd.StructureByteStride = 0u;
 
 		GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&cbd, nullptr, &pConstantBuffer));
+		gpuMemory.Set(cbd.ByteWidth);
 	}
 
 protected:
 	Microsoft::WRL::ComPtr<ID3D11Buffer> pConstantBuffer;
 	UINT slot = 0u;
+	MemoryTracker::GpuAllocation gpuMemory{ MemoryTracker::Subsystem::Constants };
 };
 
 
@@ -3,360 +3,172 @@
 #include "AstriaMath.h"
 #include "IndexedTriangleList.h"
 #include <DirectXMath.h>
+#include <cmath>
+#include <span>
 
+// latDiv rings evenly spaced from z = -1 to z = 1, each walked by incremental rotation instead of rotation matrices
+// the Fill* variants write into caller provided storage sized with TesselatedVertexCount/TesselatedIndexCount
 class CylinderVertices
 {
 public:
-	template<class V>
-	static IndexedTriangleList<V> MakeTesselated(int longDiv, int latDiv)
+	static size_t TesselatedVertexCount(int longDiv, int latDiv) noexcept
 	{
-		namespace dx = DirectX;
-		assert(longDiv >= 3 && longDiv >= 2);
-
-		const auto l_base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
-		const auto u_base = dx::XMVectorSet(1.0f, 0.0f,  1.0f, 0.0f);
-
-		const float longitudeAngle = 2.0f * PI / longDiv;
-
-		// l_base vertices
-		std::vector<V> vertices;
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				l_base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-		}
-
-
-		// center rings
-		auto base = l_base;
-
-		for (int iLat = 0; iLat < latDiv - 2; iLat++) {
-			base = dx::XMVector3Transform(base, dx::XMMatrixTranslation(0.0f, 0.0f, 2.0f / (latDiv - 1 )));
-			for (int iLong = 0; iLong < longDiv; iLong++) {
-				vertices.emplace_back();
-				auto v = dx::XMVector3Transform(
-					base,
-					dx::XMMatrixRotationZ(longitudeAngle * iLong)
-				);
-				dx::XMStoreFloat3(&vertices.back().pos, v);
-			}
-		}
-
-
-		// u_base vertices
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				u_base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-		}
-		
-		// the l center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,-1.0f };
-		const auto ilCenter = (unsigned short)(vertices.size() - 1);
-
-		// the u center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,1.0f };
-		const auto iuCenter = (unsigned short)(vertices.size() - 1);
-
-
-		// l base indices
-		std::vector<unsigned short> indices;
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
-		{
-			indices.push_back(ilCenter);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iLong);
-		}
-
-		unsigned short end = longDiv + (latDiv-2)*longDiv;
-
-		unsigned short n = 0;
-
-		// cylinder indices
-		for (unsigned short iLong = 0; iLong < end; iLong++)
-		{
-			if (iLong != 0 && iLong % longDiv == 0) {
-				n += 1;
-			}
-
-			unsigned short factor = n * longDiv;
-
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(iLong+longDiv);
-
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(((iLong + 1) % longDiv)+longDiv + factor);
-			indices.push_back(iLong + longDiv);
-
-		}
+		return size_t(longDiv) * size_t(latDiv) + 2u;
+	}
+	static size_t TesselatedIndexCount(int longDiv, int latDiv) noexcept
+	{
+		return size_t(longDiv) * 6u * size_t(latDiv);
+	}
 
-		// u base indices
-		for (unsigned short iLong = end; iLong < longDiv+end; iLong++)
-		{
-			indices.push_back(iuCenter);
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv)+ end);
-		}
+	template<class V>
+	static void FillTesselated(int longDiv, int latDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		Fill<V, false, false>(longDiv, latDiv, vertices, indices);
+	}
+	// the end rings carry the cap normals, the rings between point outwards
+	template<class V>
+	static void FillTesselatedIndependentCapNormals(int longDiv, int latDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		Fill<V, true, false>(longDiv, latDiv, vertices, indices);
+	}
+	template<class V>
+	static void FillTesselatedTextureIndependentCapNormals(int longDiv, int latDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		Fill<V, true, true>(longDiv, latDiv, vertices, indices);
+	}
 
-		return { std::move(vertices),std::move(indices) };
-	
+	template<class V>
+	static IndexedTriangleList<V> MakeTesselated(int longDiv, int latDiv)
+	{
+		return Make<V, false, false>(longDiv, latDiv);
 	}
 
 	template<class V>
 	static IndexedTriangleList<V> MakeTesselatedIndependentCapNormals(int longDiv, int latDiv)
 	{
-		namespace dx = DirectX;
-		assert(longDiv >= 3 && longDiv >= 2);
-
-		const auto l_base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
-		const auto u_base = dx::XMVectorSet(1.0f, 0.0f, 1.0f, 0.0f);
-
-		const float longitudeAngle = 2.0f * PI / longDiv;
-
-		// l_base vertices
-		std::vector<V> vertices;
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				l_base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-			vertices.back().n = { 0.0f,0.0f,-1.0f };
-		}
+		return Make<V, true, false>(longDiv, latDiv);
+	}
 
+	template<class V>
+	static IndexedTriangleList<V> MakeTesselatedTextureIndependentCapNormals(int longDiv, int latDiv)
+	{
+		return Make<V, true, true>(longDiv, latDiv);
+	}
 
-		// center rings
-		auto base = l_base;
+	template<class V>
+	static IndexedTriangleList<V> Make()
+	{
+		return MakeTesselated<V>(24, 4);
+	}
+private:
+	template<class V, bool normals, bool texcoords>
+	static IndexedTriangleList<V> Make(int longDiv, int latDiv)
+	{
+		std::vector<V> vertices(TesselatedVertexCount(longDiv, latDiv));
+		std::vector<unsigned short> indices(TesselatedIndexCount(longDiv, latDiv));
+		Fill<V, normals, texcoords>(longDiv, latDiv, vertices, indices);
+		return { std::move(vertices),std::move(indices) };
+	}
 
-		for (int iLat = 0; iLat < latDiv - 2; iLat++) {
-			base = dx::XMVector3Transform(base, dx::XMMatrixTranslation(0.0f, 0.0f, 2.0f / (latDiv - 1)));
-			for (int iLong = 0; iLong < longDiv; iLong++) {
-				vertices.emplace_back();
-				auto v = dx::XMVector3Transform(
-					base,
-					dx::XMMatrixRotationZ(longitudeAngle * iLong)
-				);
-				dx::XMStoreFloat3(&vertices.back().pos, v);
-				vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,0.0f };
-			}
-		}
+	template<class V, bool normals, bool texcoords>
+	static void Fill(int longDiv, int latDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		assert(longDiv >= 3 && latDiv >= 2);
+		assert(vertices.size() == TesselatedVertexCount(longDiv, latDiv));
+		assert(indices.size() == TesselatedIndexCount(longDiv, latDiv));
+		assert("Too many vertices for 16-bit indices" && vertices.size() <= 0x10000u);
 
+		const double longitudeAngle = 2.0 * PI_D / longDiv;
+		const double cosStep = std::cos(longitudeAngle);
+		const double sinStep = std::sin(longitudeAngle);
 
-		// u_base vertices
-		for (int iLong = 0; iLong < longDiv; iLong++)
+		size_t i = 0u;
+		for (int iRing = 0; iRing < latDiv; iRing++)
 		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				u_base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-			vertices.back().n = { 0.0f,0.0f, 1.0f };
+			const bool lCap = iRing == 0;
+			const bool uCap = iRing == latDiv - 1;
+			const float z = lCap ? -1.0f : uCap ? 1.0f : -1.0f + iRing * (2.0f / (latDiv - 1));
+			// double keeps the drift of the incremental rotation far below float precision
+			double c = 1.0;
+			double s = 0.0;
+			for (int iLong = 0; iLong < longDiv; iLong++, i++)
+			{
+				auto& v = vertices[i];
+				v.pos = { float(c),float(s),z };
+				if constexpr (normals)
+				{
+					v.n = lCap ? DirectX::XMFLOAT3{ 0.0f,0.0f,-1.0f } : uCap ? DirectX::XMFLOAT3{ 0.0f,0.0f,1.0f } : DirectX::XMFLOAT3{ float(c),float(s),0.0f };
+				}
+				if constexpr (texcoords)
+				{
+					v.tc = lCap || uCap
+						? DirectX::XMFLOAT2{ 0.5f + 0.5f * float(c),0.5f + 0.5f * float(s) }
+						: DirectX::XMFLOAT2{ iLong / (longDiv * 1.0f),(iRing - 1) / (longDiv * 1.0f) };
+				}
+				const double next = c * cosStep - s * sinStep;
+				s = s * cosStep + c * sinStep;
+				c = next;
+			}
 		}
 
 		// the l center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,-1.0f };
-		vertices.back().n = { 0.0f,0.0f,-1.0f };
-		const auto ilCenter = (unsigned short)(vertices.size() - 1);
-
+		vertices[i].pos = { 0.0f,0.0f,-1.0f };
 		// the u center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,1.0f };
-		vertices.back().n = { 0.0f,0.0f,1.0f };
-		const auto iuCenter = (unsigned short)(vertices.size() - 1);
-
-
-		// l base indices
-		std::vector<unsigned short> indices;
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
-		{
-			indices.push_back(ilCenter);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iLong);
-		}
-
-		unsigned short end = longDiv + (latDiv - 2) * longDiv;
-
-		unsigned short n = 0;
-
-		// cylinder indices
-		for (unsigned short iLong = 0; iLong < end; iLong++)
+		vertices[i + 1u].pos = { 0.0f,0.0f,1.0f };
+		if constexpr (normals)
 		{
-			if (iLong != 0 && iLong % longDiv == 0) {
-				n += 1;
-			}
-
-			unsigned short factor = n * longDiv;
-
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(iLong + longDiv);
-
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(((iLong + 1) % longDiv) + longDiv + factor);
-			indices.push_back(iLong + longDiv);
-
+			vertices[i].n = { 0.0f,0.0f,-1.0f };
+			vertices[i + 1u].n = { 0.0f,0.0f,1.0f };
 		}
-
-		// u base indices
-		for (unsigned short iLong = end; iLong < longDiv + end; iLong++)
+		if constexpr (texcoords)
 		{
-			indices.push_back(iuCenter);
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + end);
+			vertices[i].tc = { 0.5f,0.5f };
+			vertices[i + 1u].tc = { 0.5f,0.5f };
 		}
 
-		return { std::move(vertices),std::move(indices) };
-
+		FillIndices(longDiv, latDiv, indices);
 	}
 
-	template<class V>
-	static IndexedTriangleList<V> MakeTesselatedTextureIndependentCapNormals(int longDiv, int latDiv)
+	// fans from the two centers (stored after the rings) and a quad strip between each pair of rings
+	static void FillIndices(int longDiv, int rings, std::span<unsigned short> indices) noexcept
 	{
-		namespace dx = DirectX;
-		assert(longDiv >= 3 && longDiv >= 2);
-
-		const auto l_base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
-		const auto u_base = dx::XMVectorSet(1.0f, 0.0f, 1.0f, 0.0f);
-
-		const float longitudeAngle = 2.0f * PI / longDiv;
-
-		const auto txc_center = dx::XMVectorSet(0.5f, 0.5f, 0.0f, 0.0f);
-		const auto txc_base = dx::XMVectorSet(1, 0.5f, 0.0f, 0.0f);
-
-		// l_base vertices
-		std::vector<V> vertices;
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				l_base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-
-			auto t = dx::XMVectorAdd(
-				dx::XMVector2Transform(dx::XMVectorSubtract(txc_base, txc_center), dx::XMMatrixRotationZ(longitudeAngle * iLong)),
-				txc_center);
-			
-			vertices.back().n = { 0.0f,0.0f,-1.0f };
-			dx::XMStoreFloat2(&vertices.back().tc, t);
-		}
-
-
-		// center rings
-		auto base = l_base;
-
-		for (int iLat = 0; iLat < latDiv - 2; iLat++) {
-			base = dx::XMVector3Transform(base, dx::XMMatrixTranslation(0.0f, 0.0f, 2.0f / (latDiv - 1)));
-			for (int iLong = 0; iLong < longDiv; iLong++) {
-				vertices.emplace_back();
-				auto v = dx::XMVector3Transform(
-					base,
-					dx::XMMatrixRotationZ(longitudeAngle * iLong)
-				);
-				dx::XMStoreFloat3(&vertices.back().pos, v);
-				vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,0.0f };
-				vertices.back().tc = { iLong / (longDiv*1.0f), iLat / (longDiv*1.0f) };
-			}
-		}
-
-
-		// u_base vertices
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				u_base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-
-			auto t = dx::XMVectorAdd(
-				dx::XMVector2Transform(dx::XMVectorSubtract(txc_base, txc_center), dx::XMMatrixRotationZ(longitudeAngle * iLong)),
-				txc_center);
-
-			vertices.back().n = { 0.0f,0.0f, 1.0f };
-			dx::XMStoreFloat2(&vertices.back().tc, t);
-		}
-
-		// the l center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,-1.0f };
-		vertices.back().n = { 0.0f,0.0f,-1.0f };
-		vertices.back().tc = { 0.5f, 0.5f};
-		const auto ilCenter = (unsigned short)(vertices.size() - 1);
-
-		// the u center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,1.0f };
-		vertices.back().n = { 0.0f,0.0f,1.0f };
-		vertices.back().tc = { 0.5f, 0.5f};
-		const auto iuCenter = (unsigned short)(vertices.size() - 1);
-
+		const auto ring = size_t(longDiv);
+		const auto ilCenter = (unsigned short)(ring * rings);
+		const auto iuCenter = (unsigned short)(ring * rings + 1u);
+		const size_t end = ring * (rings - 1);
+		size_t i = 0u;
 
 		// l base indices
-		std::vector<unsigned short> indices;
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
+		for (size_t iLong = 0u; iLong < ring; iLong++)
 		{
-			indices.push_back(ilCenter);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iLong);
+			indices[i++] = ilCenter;
+			indices[i++] = (unsigned short)((iLong + 1u) % ring);
+			indices[i++] = (unsigned short)iLong;
 		}
 
-		unsigned short end = longDiv + (latDiv - 2) * longDiv;
-
-		unsigned short n = 0;
-
 		// cylinder indices
-		for (unsigned short iLong = 0; iLong < end; iLong++)
+		for (size_t iRing = 0u; iRing < end; iRing += ring)
 		{
-			if (iLong != 0 && iLong % longDiv == 0) {
-				n += 1;
+			for (size_t iLong = 0u; iLong < ring; iLong++)
+			{
+				const auto a = (unsigned short)(iRing + iLong);
+				const auto b = (unsigned short)(iRing + (iLong + 1u) % ring);
+				indices[i++] = a;
+				indices[i++] = b;
+				indices[i++] = (unsigned short)(a + ring);
+
+				indices[i++] = b;
+				indices[i++] = (unsigned short)(b + ring);
+				indices[i++] = (unsigned short)(a + ring);
 			}
-
-			unsigned short factor = n * longDiv;
-
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(iLong + longDiv);
-
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(((iLong + 1) % longDiv) + longDiv + factor);
-			indices.push_back(iLong + longDiv);
-
 		}
 
 		// u base indices
-		for (unsigned short iLong = end; iLong < longDiv + end; iLong++)
+		for (size_t iLong = 0u; iLong < ring; iLong++)
 		{
-			indices.push_back(iuCenter);
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + end);
+			indices[i++] = iuCenter;
+			indices[i++] = (unsigned short)(end + iLong);
+			indices[i++] = (unsigned short)(end + (iLong + 1u) % ring);
 		}
-
-		return { std::move(vertices),std::move(indices) };
-
-	}
-
-
-	template<class V>
-	static IndexedTriangleList<V> Make()
-	{
-		return MakeTesselated<V>(24, 4);
 	}
-};
\ No newline at end of file
+};
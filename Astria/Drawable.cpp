@@ -2,31 +2,18 @@
 #include "GraphicsThrowMacros.h"
 #include "IndexBuffer.h"
 #include <cassert>
-#include <typeinfo>
 
 void Drawable::Draw(Graphics& gfx)
 {
-	for (auto& b : binds) {
-		b->Bind(gfx);
-	}
-
-	for (auto& b : GetStaticBinds())
-	{
-		b->Bind(gfx);
-	}
+	binds.Bind(gfx);
+	GetStaticBinds().Bind(gfx);
 
 	gfx.DrawIndexed(pIndexBuffer->GetCount());
 }
 
-void Drawable::AddBind(std::unique_ptr<Bindable> bind) noexcept(!IS_DEBUG)
-{
-	assert("*Must* use AddIndexBuffer to bind index buffer" && typeid(*bind) != typeid(IndexBuffer));
-	binds.push_back(std::move(bind));
-}
-
-void Drawable::AddIndexBuffer(std::unique_ptr<class IndexBuffer> ibuf) noexcept
+void Drawable::AddIndexBuffer(std::shared_ptr<class IndexBuffer> ibuf) noexcept
 {
 	assert("Attempting to add index buffer a second time" && pIndexBuffer == nullptr);
 	pIndexBuffer = ibuf.get();
-	binds.push_back(std::move(ibuf));
+	binds.Add(std::move(ibuf));
 }
@@ -1,8 +1,10 @@
 #pragma once
 #include <DirectXMath.h>
 #include "Graphics.h"
+#include "BindableSet.h"
+#include <type_traits>
 
-class Bindable;
+class IndexBuffer;
 
 class Drawable
 {
@@ -19,21 +21,21 @@ protected:
 	template<class T>
 	T* QueryBindable() noexcept
 	{
-		for (auto& pb : binds)
-		{
-			if (auto pt = dynamic_cast<T*>(pb.get()))
-			{
-				return pt;
-			}
-		}
-		return nullptr;
+		return binds.Get<T>();
 	}
-	void AddBind(std::unique_ptr<Bindable> bind) noexcept(!IS_DEBUG);
-	void AddIndexBuffer(std::unique_ptr<class IndexBuffer> ibuf) noexcept;
+	// takes a shared_ptr or unique_ptr to the concrete bindable type, which is what QueryBindable finds it by
+	template<class P>
+	void AddBind(P&& bind) noexcept(!IS_DEBUG)
+	{
+		using T = typename std::remove_reference_t<P>::element_type;
+		static_assert(!std::is_same_v<T, IndexBuffer>, "*Must* use AddIndexBuffer to bind index buffer");
+		binds.Add(std::shared_ptr<T>(std::forward<P>(bind)));
+	}
+	void AddIndexBuffer(std::shared_ptr<class IndexBuffer> ibuf) noexcept;
 private:
-	virtual const std::vector<std::unique_ptr<Bindable>>& GetStaticBinds() const noexcept = 0;
+	virtual const BindableSet& GetStaticBinds() const noexcept = 0;
 private:
 	const IndexBuffer* pIndexBuffer = nullptr;
-	std::vector<std::unique_ptr<Bindable>> binds;
+	BindableSet binds;
 };
 
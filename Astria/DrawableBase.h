@@ -1,50 +1,63 @@
 #pragma once
 #include "Drawable.h"
 #include "IndexBuffer.h"
+#include "PoolAllocator.h"
 
 template<class T>
 class DrawableBase : public Drawable
 {
+public:
+	// drawables of one type are pooled together, a class deriving further from T falls back to the heap
+	static void* operator new(size_t size)
+	{
+		return size == sizeof(T) ? PoolAllocator::For<T>().Allocate() : ::operator new(size);
+	}
+	static void operator delete(void* p, size_t size) noexcept
+	{
+		if (size == sizeof(T))
+		{
+			PoolAllocator::For<T>().Free(p);
+		}
+		else
+		{
+			::operator delete(p);
+		}
+	}
 protected:
 	static bool IsStaticInitialized() noexcept
 	{
-		return !staticBinds.empty();
+		return !staticBinds.Empty();
 	}
 
-	static void AddStaticBind(std::unique_ptr<Bindable> bind) noexcept(!IS_DEBUG)
+	template<class P>
+	static void AddStaticBind(P&& bind) noexcept(!IS_DEBUG)
 	{
-		assert("*Must* use AddStaticIndexBuffer to bind index buffer" && typeid(*bind) != typeid(IndexBuffer));
-		staticBinds.push_back(std::move(bind));
+		using B = typename std::remove_reference_t<P>::element_type;
+		static_assert(!std::is_same_v<B, IndexBuffer>, "*Must* use AddStaticIndexBuffer to bind index buffer");
+		staticBinds.Add(std::shared_ptr<B>(std::forward<P>(bind)));
 	}
 
-	void AddStaticIndexBuffer(std::unique_ptr<IndexBuffer> ibuf) noexcept(!IS_DEBUG)
+	void AddStaticIndexBuffer(std::shared_ptr<IndexBuffer> ibuf) noexcept(!IS_DEBUG)
 	{
 		assert("Attempting to add index buffer a second time" && pIndexBuffer == nullptr);
 		pIndexBuffer = ibuf.get();
-		staticBinds.push_back(std::move(ibuf));
+		staticBinds.Add(std::move(ibuf));
 	}
 
 	void SetIndexFromStatic() noexcept(!IS_DEBUG)
 	{
 		assert("Attempting to add index buffer a second time" && pIndexBuffer == nullptr);
-		for (const auto& b : staticBinds)
-		{
-			if (const auto p = dynamic_cast<IndexBuffer*>(b.get()))
-			{
-				pIndexBuffer = p;
-				return;
-			}
-		}
+		pIndexBuffer = staticBinds.Get<IndexBuffer>();
 		assert("Failed to find index buffer in static binds" && pIndexBuffer != nullptr);
 	}
 private:
-	const std::vector<std::unique_ptr<Bindable>>& GetStaticBinds() const noexcept override
+	const BindableSet& GetStaticBinds() const noexcept override
 	{
 		return staticBinds;
 	}
 private:
-	static std::vector<std::unique_ptr<Bindable>> staticBinds;
+	static BindableSet staticBinds;
 };
 
 template<class T>
-std::vector<std::unique_ptr<Bindable>> DrawableBase<T>::staticBinds;
\ No newline at end of file
+BindableSet DrawableBase<T>::staticBinds;
\ No newline at end of file
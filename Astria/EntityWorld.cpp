@@ -0,0 +1,194 @@
+#include "EntityWorld.h"
+
+std::array<EntityWorld::ComponentType, EntityWorld::maxComponentTypes> EntityWorld::types;
+std::atomic<unsigned int> EntityWorld::typeCount = 0u;
+
+EntityWorld::~EntityWorld()
+{
+	for (const auto pArchetype : archetypeList)
+	{
+		for (auto& chunk : pArchetype->chunks)
+		{
+			for (const auto type : pArchetype->types)
+			{
+				auto p = chunk.memory.get() + pArchetype->offsets[type];
+				for (size_t row = 0; row < chunk.count; row++, p += types[type].size)
+				{
+					types[type].destroy(p);
+				}
+			}
+		}
+	}
+}
+
+void EntityWorld::Destroy(Entity entity) noexcept(!IS_DEBUG)
+{
+	assert(IsAlive(entity));
+	auto& record = records[entity.index];
+	for (const auto type : record.pArchetype->types)
+	{
+		types[type].destroy(Component(record, type));
+	}
+	Free(record);
+	record.pArchetype = nullptr;
+	record.generation++;
+	freeIndices.push_back(entity.index);
+	entityCount--;
+	structuralChanges++;
+}
+
+bool EntityWorld::IsAlive(Entity entity) const noexcept
+{
+	return entity.index < records.size() &&
+		records[entity.index].pArchetype != nullptr &&
+		records[entity.index].generation == entity.generation;
+}
+
+size_t EntityWorld::GetEntityCount() const noexcept
+{
+	return entityCount;
+}
+
+EntityWorld::Stats EntityWorld::GetStats() const noexcept
+{
+	Stats stats;
+	stats.entities = entityCount;
+	stats.archetypes = archetypeList.size();
+	for (const auto pArchetype : archetypeList)
+	{
+		stats.chunks += pArchetype->chunks.size();
+	}
+	stats.structuralChanges = structuralChanges;
+	return stats;
+}
+
+unsigned int EntityWorld::Register(const ComponentType& type) noexcept(!IS_DEBUG)
+{
+	// only called from the initialization of a function local static, the count hands out every slot once
+	const auto id = typeCount++;
+	assert("Too many component types for the archetype mask" && id < maxComponentTypes);
+	types[id] = type;
+	return id;
+}
+
+EntityWorld::Archetype& EntityWorld::GetArchetype(Mask mask)
+{
+	auto& pArchetype = archetypes[mask];
+	if (pArchetype)
+	{
+		return *pArchetype;
+	}
+	pArchetype = std::make_unique<Archetype>();
+	auto& archetype = *pArchetype;
+	archetype.mask = mask;
+	archetype.offsets.fill(~size_t(0u));
+	size_t stride = sizeof(Entity);
+	size_t padding = 0u;
+	for (unsigned int type = 0u; type < maxComponentTypes; type++)
+	{
+		if (mask & (Mask(1u) << type))
+		{
+			archetype.types.push_back(type);
+			stride += types[type].size;
+			padding += types[type].align;
+		}
+	}
+	// as many rows as fit in a chunk after the worst case alignment padding between the arrays, at least one
+	archetype.capacity = std::max(chunkBytes > padding ? (chunkBytes - padding) / stride : size_t(0u), size_t(1u));
+	size_t offset = archetype.capacity * sizeof(Entity);
+	for (const auto type : archetype.types)
+	{
+		offset = (offset + types[type].align - 1u) / types[type].align * types[type].align;
+		archetype.offsets[type] = offset;
+		offset += archetype.capacity * types[type].size;
+	}
+	archetype.bytes = offset;
+	archetypeList.push_back(&archetype);
+	return archetype;
+}
+
+Entity EntityWorld::NewEntity()
+{
+	Entity entity;
+	if (!freeIndices.empty())
+	{
+		entity.index = freeIndices.back();
+		freeIndices.pop_back();
+	}
+	else
+	{
+		entity.index = (unsigned int)records.size();
+		records.emplace_back();
+	}
+	entity.generation = records[entity.index].generation;
+	entityCount++;
+	structuralChanges++;
+	return entity;
+}
+
+void EntityWorld::Allocate(Archetype& archetype, Entity entity)
+{
+	if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity)
+	{
+		archetype.chunks.emplace_back();
+		archetype.chunks.back().memory = std::make_unique<std::byte[]>(archetype.bytes);
+	}
+	auto& chunk = archetype.chunks.back();
+	auto& record = records[entity.index];
+	record.pArchetype = &archetype;
+	record.chunk = (unsigned int)(archetype.chunks.size() - 1u);
+	record.row = (unsigned int)chunk.count;
+	reinterpret_cast<Entity*>(chunk.memory.get())[chunk.count++] = entity;
+}
+
+void EntityWorld::Free(const Record& record) noexcept
+{
+	auto& archetype = *record.pArchetype;
+	auto& last = archetype.chunks.back();
+	const auto lastRow = (unsigned int)(last.count - 1u);
+	const auto lastChunk = (unsigned int)(archetype.chunks.size() - 1u);
+	// swap removal keeps the chunks dense, the last row of the archetype moves into the hole
+	if (record.chunk != lastChunk || record.row != lastRow)
+	{
+		const Record from = { record.pArchetype,lastChunk,lastRow };
+		for (const auto type : archetype.types)
+		{
+			const auto pLast = Component(from, type);
+			types[type].moveConstruct(Component(record, type), pLast);
+			types[type].destroy(pLast);
+		}
+		const auto moved = reinterpret_cast<Entity*>(last.memory.get())[lastRow];
+		reinterpret_cast<Entity*>(archetype.chunks[record.chunk].memory.get())[record.row] = moved;
+		records[moved.index].chunk = record.chunk;
+		records[moved.index].row = record.row;
+	}
+	if (--last.count == 0u)
+	{
+		archetype.chunks.pop_back();
+	}
+}
+
+void EntityWorld::Move(Entity entity, Mask mask)
+{
+	auto& record = records[entity.index];
+	const auto old = record;
+	auto& archetype = GetArchetype(mask);
+	Allocate(archetype, entity);
+	for (const auto type : old.pArchetype->types)
+	{
+		const auto pOld = Component(old, type);
+		if (mask & (Mask(1u) << type))
+		{
+			types[type].moveConstruct(Component(record, type), pOld);
+		}
+		types[type].destroy(pOld);
+	}
+	Free(old);
+	structuralChanges++;
+}
+
+void* EntityWorld::Component(const Record& record, unsigned int type) noexcept
+{
+	const auto& archetype = *record.pArchetype;
+	return archetype.chunks[record.chunk].memory.get() + archetype.offsets[type] + record.row * types[type].size;
+}
@@ -0,0 +1,238 @@
+#pragma once
+#include "FrameAllocator.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// handle of an entity in an EntityWorld, the generation tells a reused index apart from the entity that held it before
+struct Entity
+{
+	unsigned int index = ~0u;
+	unsigned int generation = 0u;
+	bool operator==(const Entity&) const = default;
+};
+
+// archetype based entity-component store
+// entities with the same set of component types share an archetype, which keeps them in fixed size chunks holding
+// one array per component type, so a query walks plain arrays of exactly the components it asks for
+// adding or removing a component moves the entity to another archetype (a structural change), component references
+// stay valid only until the next structural change and structural changes are not allowed inside ForEach
+class EntityWorld
+{
+public:
+	using Mask = uint64_t;
+	static constexpr size_t maxComponentTypes = 64u;
+	static constexpr size_t chunkBytes = 16u * 1024u;
+	struct Stats
+	{
+		size_t entities = 0u;
+		size_t archetypes = 0u;
+		size_t chunks = 0u;
+		// creations, destructions and archetype moves since the world was made
+		size_t structuralChanges = 0u;
+	};
+public:
+	EntityWorld() = default;
+	EntityWorld(const EntityWorld&) = delete;
+	EntityWorld& operator=(const EntityWorld&) = delete;
+	~EntityWorld();
+	template<typename... Cs>
+	Entity Create(Cs&&... components)
+	{
+		const Mask mask = (Mask(0u) | ... | Bit<std::decay_t<Cs>>());
+		assert("Component types of an entity must be distinct" && std::popcount(mask) == sizeof...(Cs));
+		auto& archetype = GetArchetype(mask);
+		const auto entity = NewEntity();
+		auto& record = records[entity.index];
+		Allocate(archetype, entity);
+		(new(Component(record, TypeId<std::decay_t<Cs>>())) std::decay_t<Cs>(std::forward<Cs>(components)), ...);
+		return entity;
+	}
+	void Destroy(Entity entity) noexcept(!IS_DEBUG);
+	bool IsAlive(Entity entity) const noexcept;
+	template<typename C>
+	bool Has(Entity entity) const noexcept(!IS_DEBUG)
+	{
+		assert(IsAlive(entity));
+		return (records[entity.index].pArchetype->mask & Bit<C>()) != 0u;
+	}
+	template<typename C>
+	C& Get(Entity entity) noexcept(!IS_DEBUG)
+	{
+		assert("Entity does not have the component" && Has<C>(entity));
+		return *static_cast<C*>(Component(records[entity.index], TypeId<C>()));
+	}
+	template<typename C>
+	const C& Get(Entity entity) const noexcept(!IS_DEBUG)
+	{
+		return const_cast<EntityWorld*>(this)->Get<C>(entity);
+	}
+	template<typename C>
+	std::decay_t<C>& Add(Entity entity, C&& component)
+	{
+		using T = std::decay_t<C>;
+		assert("Entity already has the component" && !Has<T>(entity));
+		auto& record = records[entity.index];
+		Move(entity, record.pArchetype->mask | Bit<T>());
+		return *new(Component(record, TypeId<T>())) T(std::forward<C>(component));
+	}
+	template<typename C>
+	void Remove(Entity entity)
+	{
+		assert("Entity does not have the component" && Has<C>(entity));
+		Move(entity, records[entity.index].pArchetype->mask & ~Bit<C>());
+	}
+	// calls f(Cs&...) or f(Entity, Cs&...) for every entity having all of Cs, a chunk at a time
+	template<typename... Cs, typename F>
+	void ForEach(F&& f)
+	{
+		const Mask mask = (Mask(0u) | ... | Bit<std::remove_const_t<Cs>>());
+		for (const auto pArchetype : archetypeList)
+		{
+			if ((pArchetype->mask & mask) != mask)
+			{
+				continue;
+			}
+			for (size_t c = 0; c < pArchetype->chunks.size(); c++)
+			{
+				RunChunk<Cs...>(*pArchetype, c, f);
+			}
+		}
+	}
+	// like ForEach with the chunks split across threads, f must only touch the entity it is handed
+	template<typename... Cs, typename F>
+	void ParallelForEach(F&& f)
+	{
+		const Mask mask = (Mask(0u) | ... | Bit<std::remove_const_t<Cs>>());
+		std::pmr::vector<std::pair<Archetype*, size_t>> work(FrameAllocator::Get());
+		size_t count = 0u;
+		for (const auto pArchetype : archetypeList)
+		{
+			if ((pArchetype->mask & mask) != mask)
+			{
+				continue;
+			}
+			for (size_t c = 0; c < pArchetype->chunks.size(); c++)
+			{
+				work.emplace_back(pArchetype, c);
+				count += pArchetype->chunks[c].count;
+			}
+		}
+		if (count < parallelThreshold)
+		{
+			for (const auto& [pArchetype, c] : work)
+			{
+				RunChunk<Cs...>(*pArchetype, c, f);
+			}
+			return;
+		}
+		std::for_each(std::execution::par, work.begin(), work.end(), [&f](const std::pair<Archetype*, size_t>& w)
+		{
+			RunChunk<Cs...>(*w.first, w.second, f);
+		});
+	}
+	size_t GetEntityCount() const noexcept;
+	Stats GetStats() const noexcept;
+	// dense id of a component type, assigned on first use
+	template<typename C>
+	static unsigned int TypeId() noexcept(!IS_DEBUG)
+	{
+		static_assert(std::is_nothrow_move_constructible_v<C>, "Components are moved between chunks and must not throw doing so");
+		static_assert(alignof(C) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Component alignment exceeds the chunk alignment");
+		static const unsigned int id = Register({ sizeof(C),alignof(C),
+			[](void* pDst, void* pSrc) noexcept { new(pDst) C(std::move(*static_cast<C*>(pSrc))); },
+			[](void* p) noexcept { static_cast<C*>(p)->~C(); }
+		});
+		return id;
+	}
+private:
+	struct ComponentType
+	{
+		size_t size;
+		size_t align;
+		void(*moveConstruct)(void* pDst, void* pSrc) noexcept;
+		void(*destroy)(void* p) noexcept;
+	};
+	struct Chunk
+	{
+		std::unique_ptr<std::byte[]> memory;
+		size_t count = 0u;
+	};
+	struct Archetype
+	{
+		Mask mask = 0u;
+		// ids of the component types, ascending
+		std::vector<unsigned int> types;
+		// byte offset of the array of every component type in a chunk, the entity array starts at 0
+		std::array<size_t, maxComponentTypes> offsets;
+		size_t capacity = 0u;
+		size_t bytes = 0u;
+		// every chunk but the last is full
+		std::vector<Chunk> chunks;
+	};
+	struct Record
+	{
+		Archetype* pArchetype = nullptr;
+		unsigned int chunk = 0u;
+		unsigned int row = 0u;
+		unsigned int generation = 0u;
+	};
+private:
+	template<typename C>
+	static Mask Bit() noexcept(!IS_DEBUG)
+	{
+		return Mask(1u) << TypeId<C>();
+	}
+	template<typename... Cs, typename F>
+	static void RunChunk(Archetype& archetype, size_t c, F& f)
+	{
+		auto& chunk = archetype.chunks[c];
+		const auto pEntities = reinterpret_cast<const Entity*>(chunk.memory.get());
+		const auto columns = std::make_tuple(
+			reinterpret_cast<Cs*>(chunk.memory.get() + archetype.offsets[TypeId<std::remove_const_t<Cs>>()])...
+		);
+		for (size_t row = 0; row < chunk.count; row++)
+		{
+			if constexpr (std::is_invocable_v<F&, Entity, Cs&...>)
+			{
+				f(pEntities[row], std::get<Cs*>(columns)[row]...);
+			}
+			else
+			{
+				f(std::get<Cs*>(columns)[row]...);
+			}
+		}
+	}
+	static unsigned int Register(const ComponentType& type) noexcept(!IS_DEBUG);
+	Archetype& GetArchetype(Mask mask);
+	Entity NewEntity();
+	// appends a row for the entity to the archetype and points its record at it
+	void Allocate(Archetype& archetype, Entity entity);
+	// fills the row of the entity, whose components are already destroyed or moved out, with the last row
+	void Free(const Record& record) noexcept;
+	// moves the entity to the archetype of the mask, destroying the components it leaves behind
+	void Move(Entity entity, Mask mask);
+	void* Component(const Record& record, unsigned int type) noexcept;
+private:
+	std::vector<Record> records;
+	std::vector<unsigned int> freeIndices;
+	std::unordered_map<Mask, std::unique_ptr<Archetype>> archetypes;
+	// in order of creation, so iteration does not depend on the hashing
+	std::vector<Archetype*> archetypeList;
+	size_t entityCount = 0u;
+	size_t structuralChanges = 0u;
+	static std::array<ComponentType, maxComponentTypes> types;
+	static std::atomic<unsigned int> typeCount;
+	static constexpr size_t parallelThreshold = 1u << 12u;
+};
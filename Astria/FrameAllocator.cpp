@@ -0,0 +1,82 @@
+#include "FrameAllocator.h"
+#include <algorithm>
+#include <cstdint>
+
+std::atomic<size_t> FrameAllocator::frame = 0u;
+std::atomic<size_t> FrameAllocator::frameBytes = 0u;
+std::atomic<size_t> FrameAllocator::frameOverflowBytes = 0u;
+std::atomic<size_t> FrameAllocator::heapAllocations = 0u;
+std::atomic<size_t> FrameAllocator::frameStartHeapAllocations = 0u;
+FrameAllocator::Stats FrameAllocator::lastFrame;
+
+std::pmr::memory_resource* FrameAllocator::Get() noexcept
+{
+	thread_local FrameAllocator allocator;
+	return &allocator;
+}
+
+void FrameAllocator::NextFrame() noexcept
+{
+	const auto heap = heapAllocations.load(std::memory_order_relaxed);
+	lastFrame.frame = frame.load(std::memory_order_relaxed);
+	lastFrame.scratchBytes = frameBytes.exchange(0u, std::memory_order_relaxed);
+	lastFrame.overflowBytes = frameOverflowBytes.exchange(0u, std::memory_order_relaxed);
+	lastFrame.heapAllocations = heap - frameStartHeapAllocations.exchange(heap, std::memory_order_relaxed);
+	frame.fetch_add(1u, std::memory_order_release);
+}
+
+FrameAllocator::Stats FrameAllocator::GetStats() noexcept
+{
+	return lastFrame;
+}
+
+void FrameAllocator::CountHeapAllocation() noexcept
+{
+	heapAllocations.fetch_add(1u, std::memory_order_relaxed);
+}
+
+FrameAllocator::Arena& FrameAllocator::Current()
+{
+	const auto now = frame.load(std::memory_order_acquire);
+	auto& arena = arenas[now & 1u];
+	if (arena.frame != now)
+	{
+		// an arena that overflowed grows to what it needed, so a steady workload stops touching the heap
+		if (arena.pBuffer == nullptr || arena.overflowBytes > 0u)
+		{
+			arena.capacity = std::max(arena.capacity + arena.overflowBytes, initialCapacity);
+			arena.pBuffer = std::make_unique<std::byte[]>(arena.capacity);
+		}
+		arena.overflow.clear();
+		arena.overflowBytes = 0u;
+		arena.used = 0u;
+		arena.frame = now;
+	}
+	return arena;
+}
+
+void* FrameAllocator::do_allocate(size_t bytes, size_t alignment)
+{
+	auto& arena = Current();
+	frameBytes.fetch_add(bytes, std::memory_order_relaxed);
+	const auto base = reinterpret_cast<uintptr_t>(arena.pBuffer.get());
+	const auto offset = (base + arena.used + alignment - 1u) / alignment * alignment - base;
+	if (offset + bytes <= arena.capacity)
+	{
+		arena.used = offset + bytes;
+		return arena.pBuffer.get() + offset;
+	}
+	// padded for the alignment, new[] only guarantees the default new alignment
+	const auto padded = bytes + alignment;
+	arena.overflow.push_back(std::make_unique<std::byte[]>(padded));
+	arena.overflowBytes += padded;
+	frameOverflowBytes.fetch_add(bytes, std::memory_order_relaxed);
+	const auto p = reinterpret_cast<uintptr_t>(arena.overflow.back().get());
+	return reinterpret_cast<void*>((p + alignment - 1u) / alignment * alignment);
+}
+
+bool FrameAllocator::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// per thread linear scratch memory for data that does not outlive the frame after the one it was made in
+// every thread bumps through one of two arenas, NextFrame (called by Graphics::BeginFrame) flips to the other
+// one and the arena a thread switches to is emptied on its first allocation of the new frame
+// containers opt in through std::pmr, e.g. std::pmr::vector<T> v(FrameAllocator::Get())
+class FrameAllocator : public std::pmr::memory_resource
+{
+public:
+	struct Stats
+	{
+		size_t frame = 0u;
+		// scratch bytes handed out during the last frame, over all threads
+		size_t scratchBytes = 0u;
+		// of those, bytes that did not fit the arenas and came from the heap
+		size_t overflowBytes = 0u;
+		// calls to the global operator new during the last frame, over all threads
+		size_t heapAllocations = 0u;
+	};
+public:
+	// scratch resource of the calling thread
+	static std::pmr::memory_resource* Get() noexcept;
+	static void NextFrame() noexcept;
+	static Stats GetStats() noexcept;
+	// counted by the replaced global operator new
+	static void CountHeapAllocation() noexcept;
+private:
+	struct Arena
+	{
+		std::unique_ptr<std::byte[]> pBuffer;
+		size_t capacity = 0u;
+		size_t used = 0u;
+		// allocations that did not fit, freed when the arena is emptied
+		std::vector<std::unique_ptr<std::byte[]>> overflow;
+		size_t overflowBytes = 0u;
+		size_t frame = ~size_t(0u);
+	};
+private:
+	FrameAllocator() = default;
+	Arena& Current();
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	// scratch memory is only released all at once
+	void do_deallocate(void*, size_t, size_t) noexcept override {}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+private:
+	Arena arenas[2];
+	static std::atomic<size_t> frame;
+	static std::atomic<size_t> frameBytes;
+	static std::atomic<size_t> frameOverflowBytes;
+	static std::atomic<size_t> heapAllocations;
+	static std::atomic<size_t> frameStartHeapAllocations;
+	static Stats lastFrame;
+	static constexpr size_t initialCapacity = 256u * 1024u;
+};
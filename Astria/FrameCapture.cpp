@@ -0,0 +1,205 @@
+#include "FrameCapture.h"
+#include "GraphicsThrowMacros.h"
+#include <chrono>
+#include <cstring>
+
+namespace wrl = Microsoft::WRL;
+
+FrameCapture::FrameCapture(Graphics& gfx)
+{
+	HRESULT hr;
+#ifndef NDEBUG
+	DxgiInfoManager& infoManager = gfx.infoManager;
+#endif
+
+	wrl::ComPtr<ID3D11Texture2D> pBackBuffer;
+	GFX_THROW_INFO(gfx.pSwap->GetBuffer(0, __uuidof(ID3D11Texture2D), &pBackBuffer));
+	D3D11_TEXTURE2D_DESC desc;
+	pBackBuffer->GetDesc(&desc);
+	width = desc.Width;
+	height = desc.Height;
+
+	// staging copies of the back buffer that the cpu can map
+	desc.Usage = D3D11_USAGE_STAGING;
+	desc.BindFlags = 0u;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+	desc.MiscFlags = 0u;
+	for (auto& s : slots)
+	{
+		GFX_THROW_INFO(gfx.pDevice->CreateTexture2D(&desc, nullptr, &s.pStaging));
+	}
+
+	worker = std::thread([this] { WorkerLoop(); });
+}
+
+FrameCapture::~FrameCapture()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	jobCv.notify_all();
+	worker.join();
+}
+
+void FrameCapture::Request(std::string filename)
+{
+	requests.push_back(std::move(filename));
+	std::lock_guard<std::mutex> lock(mutex);
+	stats.requested++;
+}
+
+void FrameCapture::OnEndFrame(Graphics& gfx)
+{
+	frame++;
+	// pick up copies from earlier frames first so their slots can be reused this frame
+	Readback(gfx, false);
+	if (requests.empty())
+	{
+		return;
+	}
+
+	HRESULT hr;
+#ifndef NDEBUG
+	DxgiInfoManager& infoManager = gfx.infoManager;
+#endif
+	wrl::ComPtr<ID3D11Resource> pBackBuffer;
+	GFX_THROW_INFO(gfx.pSwap->GetBuffer(0, __uuidof(ID3D11Resource), &pBackBuffer));
+
+	// one capture per frame, every request wants a different frame
+	for (auto& s : slots)
+	{
+		if (!s.busy)
+		{
+			gfx.pContext->CopyResource(s.pStaging.Get(), pBackBuffer.Get());
+			s.filename = std::move(requests.front());
+			s.frame = frame;
+			s.busy = true;
+			requests.pop_front();
+			std::lock_guard<std::mutex> lock(mutex);
+			stats.copied++;
+			return;
+		}
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	stats.deferred++;
+}
+
+void FrameCapture::Flush(Graphics& gfx)
+{
+	Readback(gfx, true);
+	std::unique_lock<std::mutex> lock(mutex);
+	idleCv.wait(lock, [this] { return jobs.empty() && !encoding; });
+}
+
+FrameCapture::Stats FrameCapture::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+void FrameCapture::Readback(Graphics& gfx, bool wait)
+{
+	HRESULT hr;
+#ifndef NDEBUG
+	DxgiInfoManager& infoManager = gfx.infoManager;
+#endif
+
+	// oldest copies first so files come out in request order
+	while (true)
+	{
+		Slot* pSlot = nullptr;
+		for (auto& s : slots)
+		{
+			if (s.busy && (pSlot == nullptr || s.frame < pSlot->frame))
+			{
+				pSlot = &s;
+			}
+		}
+		if (pSlot == nullptr)
+		{
+			return;
+		}
+
+		D3D11_MAPPED_SUBRESOURCE msr;
+		hr = gfx.pContext->Map(pSlot->pStaging.Get(), 0u, D3D11_MAP_READ, wait ? 0u : D3D11_MAP_FLAG_DO_NOT_WAIT, &msr);
+		if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+		{
+			// later copies cannot be done before this one
+			return;
+		}
+		if (FAILED(hr))
+		{
+			throw GFX_EXCEPT(hr);
+		}
+
+		Surface surface(width, height);
+		const auto pSrc = static_cast<const unsigned char*>(msr.pData);
+		for (unsigned int y = 0u; y < height; y++)
+		{
+			std::memcpy(surface.GetBufferPtr() + size_t(y) * width, pSrc + size_t(y) * msr.RowPitch, size_t(width) * sizeof(Surface::Color));
+		}
+		gfx.pContext->Unmap(pSlot->pStaging.Get(), 0u);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push_back({ std::move(surface),std::move(pSlot->filename) });
+		}
+		jobCv.notify_one();
+		pSlot->busy = false;
+	}
+}
+
+void FrameCapture::WorkerLoop() noexcept
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		jobCv.wait(lock, [this] { return quit || !jobs.empty(); });
+		if (jobs.empty())
+		{
+			// quit only once everything queued has been written
+			return;
+		}
+		Job job = std::move(jobs.front());
+		jobs.pop_front();
+		encoding = true;
+		lock.unlock();
+
+		const auto start = std::chrono::steady_clock::now();
+		bool ok = false;
+		try
+		{
+			// the back buffer alpha is whatever the blend state left behind
+			auto pPixels = reinterpret_cast<unsigned int*>(job.surface.GetBufferPtr());
+			const size_t count = size_t(job.surface.GetWidth()) * job.surface.GetHeight();
+			for (size_t i = 0u; i < count; i++)
+			{
+				pPixels[i] |= 0xFF000000u;
+			}
+			job.surface.Save(job.filename);
+			ok = true;
+		}
+		catch (...)
+		{
+		}
+		const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		lock.lock();
+		encoding = false;
+		if (ok)
+		{
+			stats.written++;
+		}
+		else
+		{
+			stats.failed++;
+		}
+		stats.lastEncodeMs = ms;
+		stats.totalEncodeMs += ms;
+		if (jobs.empty())
+		{
+			idleCv.notify_all();
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Graphics.h"
+#include "Surface.h"
+#include <array>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+// copies the back buffer into a ring of staging textures and encodes the frames on a worker thread
+// slots are only mapped once the gpu is done with them, so capturing never stalls the frame
+class FrameCapture
+{
+public:
+	struct Stats
+	{
+		size_t requested = 0u;
+		size_t copied = 0u;
+		size_t written = 0u;
+		size_t failed = 0u;
+		// frames where every staging slot was still in flight and the request had to wait
+		size_t deferred = 0u;
+		float lastEncodeMs = 0.0f;
+		float totalEncodeMs = 0.0f;
+	};
+public:
+	FrameCapture(Graphics& gfx);
+	FrameCapture(const FrameCapture&) = delete;
+	FrameCapture& operator=(const FrameCapture&) = delete;
+	~FrameCapture();
+	// captures the next presented frame, the format is taken from the extension (.png .qoi .bmp)
+	void Request(std::string filename);
+	// called by Graphics between the last draw and Present
+	void OnEndFrame(Graphics& gfx);
+	// blocks until every copied frame has been read back and written
+	void Flush(Graphics& gfx);
+	Stats GetStats() const;
+private:
+	struct Slot
+	{
+		Microsoft::WRL::ComPtr<ID3D11Texture2D> pStaging;
+		std::string filename;
+		unsigned long long frame = 0u;
+		bool busy = false;
+	};
+	struct Job
+	{
+		Surface surface;
+		std::string filename;
+	};
+private:
+	void Readback(Graphics& gfx, bool wait);
+	void WorkerLoop() noexcept;
+private:
+	static constexpr size_t nSlots = 3u;
+	std::array<Slot, nSlots> slots;
+	std::deque<std::string> requests;
+	unsigned long long frame = 0u;
+	unsigned int width;
+	unsigned int height;
+	// worker state
+	mutable std::mutex mutex;
+	std::condition_variable jobCv;
+	std::condition_variable idleCv;
+	std::deque<Job> jobs;
+	bool encoding = false;
+	bool quit = false;
+	Stats stats;
+	std::thread worker;
+};
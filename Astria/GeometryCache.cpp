@@ -0,0 +1,34 @@
+#include "GeometryCache.h"
+
+GeometryCache::Stats GeometryCache::GetStats() noexcept
+{
+	auto& cache = Get();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	return cache.stats;
+}
+
+void GeometryCache::Prune() noexcept
+{
+	auto& cache = Get();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	for (auto i = cache.meshes.begin(); i != cache.meshes.end();)
+	{
+		const auto& mesh = i->second.mesh;
+		if (mesh.pVertexBuffer.use_count() == 1 && mesh.pIndexBuffer.use_count() == 1)
+		{
+			cache.stats.entries--;
+			cache.stats.residentBytes -= i->second.bytes;
+			i = cache.meshes.erase(i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+GeometryCache& GeometryCache::Get() noexcept
+{
+	static GeometryCache cache;
+	return cache;
+}
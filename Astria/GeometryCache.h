@@ -0,0 +1,81 @@
+#pragma once
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "IndexedTriangleList.h"
+#include "MemoryTracker.h"
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+// procedural meshes shared between drawables, keyed by (generator, vertex type, generator parameters)
+// the first request builds and uploads the mesh, every later one with the same key gets the same gpu buffers
+class GeometryCache
+{
+public:
+	struct Mesh
+	{
+		std::shared_ptr<VertexBuffer> pVertexBuffer;
+		std::shared_ptr<IndexBuffer> pIndexBuffer;
+	};
+	struct Stats
+	{
+		size_t hits = 0u;
+		size_t misses = 0u;
+		size_t entries = 0u;
+		// vertex + index bytes uploaded once
+		size_t residentBytes = 0u;
+		// bytes the hits would have uploaded as private copies
+		size_t savedBytes = 0u;
+	};
+public:
+	// build(params...) returns an IndexedTriangleList<V>, generator names the recipe including any
+	// post processing build does, so two recipes over the same vertex type need different names
+	template<class V, typename Build, typename...Params>
+	static Mesh Resolve(Graphics& gfx, const char* generator, Build&& build, const Params&...params)
+	{
+		std::ostringstream key;
+		key << generator << '#' << typeid(V).name();
+		((key << '#' << params), ...);
+		return Get().ResolveImpl<V>(gfx, key.str(), [&]() -> IndexedTriangleList<V> { return build(params...); });
+	}
+	static Stats GetStats() noexcept;
+	// drops every mesh no drawable uses anymore
+	static void Prune() noexcept;
+private:
+	struct Entry
+	{
+		Mesh mesh;
+		size_t bytes;
+	};
+private:
+	template<class V, typename Build>
+	Mesh ResolveImpl(Graphics& gfx, const std::string& key, Build&& build)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		const auto i = meshes.find(key);
+		if (i != meshes.end())
+		{
+			stats.hits++;
+			stats.savedBytes += i->second.bytes;
+			return i->second.mesh;
+		}
+		MemoryTracker::Scope scope(MemoryTracker::Subsystem::Geometry);
+		const IndexedTriangleList<V> model = build();
+		Entry entry = {
+			{ std::make_shared<VertexBuffer>(gfx, model.vertices),std::make_shared<IndexBuffer>(gfx, model.indices) },
+			model.vertices.size() * sizeof(V) + model.indices.size() * sizeof(unsigned short)
+		};
+		stats.misses++;
+		stats.entries++;
+		stats.residentBytes += entry.bytes;
+		return meshes.emplace(key, std::move(entry)).first->second.mesh;
+	}
+	static GeometryCache& Get() noexcept;
+private:
+	std::mutex mutex;
+	std::unordered_map<std::string, Entry> meshes;
+	Stats stats;
+};
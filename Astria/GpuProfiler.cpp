@@ -0,0 +1,264 @@
+#include "GpuProfiler.h"
+#include "imgui/imgui.h"
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+	// false while the gpu has not finished the query, a failed read counts as done and reads zero
+	bool Fetch(ID3D11DeviceContext& context, ID3D11Query* pQuery, void* pData, UINT size) noexcept
+	{
+		const auto hr = context.GetData(pQuery, pData, size, D3D11_ASYNC_GETDATA_DONOTFLUSH);
+		if (hr == S_FALSE)
+		{
+			return false;
+		}
+		if (FAILED(hr))
+		{
+			std::memset(pData, 0, size);
+		}
+		return true;
+	}
+}
+
+GpuProfiler::Pass::Pass(Graphics& gfx, const char* name) noexcept(!IS_DEBUG)
+	:
+	gfx(gfx)
+{
+	gfx.GetGpuProfiler().BeginPass(gfx, name);
+}
+
+GpuProfiler::Pass::~Pass()
+{
+	gfx.GetGpuProfiler().EndPass(gfx);
+}
+
+GpuProfiler::GpuProfiler(Graphics& gfx) noexcept
+{
+	const auto create = [&gfx, this](D3D11_QUERY type, Microsoft::WRL::ComPtr<ID3D11Query>& pQuery)
+	{
+		D3D11_QUERY_DESC desc = {};
+		desc.Query = type;
+		if (available && FAILED(gfx.pDevice->CreateQuery(&desc, &pQuery)))
+		{
+			available = false;
+		}
+	};
+	for (auto& s : slots)
+	{
+		create(D3D11_QUERY_TIMESTAMP_DISJOINT, s.pDisjoint);
+		create(D3D11_QUERY_TIMESTAMP, s.pBegin);
+		create(D3D11_QUERY_TIMESTAMP, s.pEnd);
+		for (auto& p : s.passes)
+		{
+			create(D3D11_QUERY_TIMESTAMP, p.pBegin);
+			create(D3D11_QUERY_TIMESTAMP, p.pEnd);
+			create(D3D11_QUERY_PIPELINE_STATISTICS, p.pStatistics);
+		}
+	}
+	if (!available)
+	{
+		slots = {};
+	}
+}
+
+void GpuProfiler::BeginFrame(Graphics& gfx) noexcept
+{
+	if (!available)
+	{
+		return;
+	}
+	Readback(gfx);
+	frame++;
+	auto& slot = slots[frame % nSlots];
+	if (slot.busy)
+	{
+		stats.skipped++;
+		pRecording = nullptr;
+		return;
+	}
+	slot.frame = frame;
+	slot.passCount = 0u;
+	slot.cpuStart = Profiler::Now();
+	gfx.pContext->Begin(slot.pDisjoint.Get());
+	gfx.pContext->End(slot.pBegin.Get());
+	pRecording = &slot;
+}
+
+void GpuProfiler::EndFrame(Graphics& gfx) noexcept(!IS_DEBUG)
+{
+	assert("A GPU pass is still open at the end of the frame" && !passOpen);
+	if (pRecording == nullptr)
+	{
+		return;
+	}
+	gfx.pContext->End(pRecording->pEnd.Get());
+	gfx.pContext->End(pRecording->pDisjoint.Get());
+	pRecording->busy = true;
+	pRecording = nullptr;
+}
+
+void GpuProfiler::BeginPass(Graphics& gfx, const char* name) noexcept(!IS_DEBUG)
+{
+	assert("GPU passes must not nest" && !passOpen);
+	passOpen = true;
+	if (pRecording == nullptr)
+	{
+		return;
+	}
+	if (pRecording->passCount == maxPasses)
+	{
+		stats.droppedPasses++;
+		return;
+	}
+	auto& pass = pRecording->passes[pRecording->passCount];
+	pass.name = name;
+	gfx.pContext->End(pass.pBegin.Get());
+	gfx.pContext->Begin(pass.pStatistics.Get());
+}
+
+void GpuProfiler::EndPass(Graphics& gfx) noexcept(!IS_DEBUG)
+{
+	assert("No GPU pass is open" && passOpen);
+	passOpen = false;
+	if (pRecording == nullptr || pRecording->passCount == maxPasses)
+	{
+		return;
+	}
+	auto& pass = pRecording->passes[pRecording->passCount++];
+	gfx.pContext->End(pass.pStatistics.Get());
+	gfx.pContext->End(pass.pEnd.Get());
+}
+
+bool GpuProfiler::IsAvailable() const noexcept
+{
+	return available;
+}
+
+const GpuProfiler::FrameResult& GpuProfiler::GetLastFrame() const noexcept
+{
+	return lastFrame;
+}
+
+GpuProfiler::Stats GpuProfiler::GetStats() const noexcept
+{
+	return stats;
+}
+
+void GpuProfiler::SpawnWindow() noexcept
+{
+	if (ImGui::Begin("GPU"))
+	{
+		if (!available)
+		{
+			ImGui::Text("GPU queries are not supported by the device, every result reads zero");
+		}
+		// the gpu runs behind the cpu, so its busy time is compared with the cpu frame time it has to keep up with
+		const float cpuMs = 1000.0f / ImGui::GetIO().Framerate;
+		ImGui::Text("Frame %llu: %.3f ms on the GPU, %.3f ms per frame", lastFrame.frame, lastFrame.gpuMs, cpuMs);
+		ImGui::Text("GPU busy %.0f%% of the frame%s", 100.0f * lastFrame.gpuMs / cpuMs, lastFrame.disjoint ? " (disjoint, times invalid)" : "");
+		ImGui::Text("%zu frames measured, %zu skipped, %zu passes dropped", stats.measured, stats.skipped, stats.droppedPasses);
+		const auto cell = [](const char* format, auto value)
+		{
+			ImGui::Text(format, value);
+			ImGui::NextColumn();
+		};
+		ImGui::Columns(5, "gpu passes");
+		for (const auto header : { "Pass","GPU ms","Vertices","Primitives","PS invocations" })
+		{
+			cell("%s", header);
+		}
+		ImGui::Separator();
+		for (const auto& p : lastFrame.passes)
+		{
+			cell("%s", p.name);
+			cell("%.3f", p.gpuMs);
+			cell("%llu", (unsigned long long)p.vertices);
+			cell("%llu", (unsigned long long)p.primitives);
+			cell("%llu", (unsigned long long)p.pixelInvocations);
+		}
+		ImGui::Columns(1);
+	}
+	ImGui::End();
+}
+
+void GpuProfiler::Readback(Graphics& gfx) noexcept
+{
+	auto& context = *gfx.pContext.Get();
+	while (true)
+	{
+		Slot* pSlot = nullptr;
+		for (auto& s : slots)
+		{
+			if (s.busy && (pSlot == nullptr || s.frame < pSlot->frame))
+			{
+				pSlot = &s;
+			}
+		}
+		if (pSlot == nullptr)
+		{
+			return;
+		}
+
+		// the disjoint query ends last, but the driver may still retire the others separately
+		D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+		UINT64 frameBegin;
+		UINT64 frameEnd;
+		if (!Fetch(context, pSlot->pDisjoint.Get(), &disjoint, sizeof(disjoint)) ||
+			!Fetch(context, pSlot->pBegin.Get(), &frameBegin, sizeof(frameBegin)) ||
+			!Fetch(context, pSlot->pEnd.Get(), &frameEnd, sizeof(frameEnd)))
+		{
+			// later frames cannot be done before this one
+			return;
+		}
+		struct PassData
+		{
+			UINT64 begin;
+			UINT64 end;
+			D3D11_QUERY_DATA_PIPELINE_STATISTICS statistics;
+		};
+		std::array<PassData, maxPasses> passData;
+		for (size_t i = 0u; i < pSlot->passCount; i++)
+		{
+			const auto& queries = pSlot->passes[i];
+			auto& data = passData[i];
+			if (!Fetch(context, queries.pBegin.Get(), &data.begin, sizeof(data.begin)) ||
+				!Fetch(context, queries.pEnd.Get(), &data.end, sizeof(data.end)) ||
+				!Fetch(context, queries.pStatistics.Get(), &data.statistics, sizeof(data.statistics)))
+			{
+				return;
+			}
+		}
+
+		// ticks are only comparable while the counter frequency held
+		const bool valid = !disjoint.Disjoint && disjoint.Frequency > 0u;
+		const auto ms = [&](UINT64 begin, UINT64 end)
+		{
+			return valid && end >= begin ? float(double(end - begin) * 1000.0 / double(disjoint.Frequency)) : 0.0f;
+		};
+		// gpu ticks are placed on the profiler clock as if the frame started on the gpu when the cpu began it
+		const auto toProfiler = [&](UINT64 ticks)
+		{
+			return pSlot->cpuStart + (valid && ticks >= frameBegin ? int64_t(double(ticks - frameBegin) * 1e9 / double(disjoint.Frequency)) : int64_t(0));
+		};
+		lastFrame.frame = pSlot->frame;
+		lastFrame.gpuMs = ms(frameBegin, frameEnd);
+		lastFrame.disjoint = disjoint.Disjoint != FALSE;
+		lastFrame.passes.clear();
+		Profiler::RecordGpu({ "GPU Frame",toProfiler(frameBegin),toProfiler(frameEnd),0u,0u,0u });
+		for (size_t i = 0u; i < pSlot->passCount; i++)
+		{
+			const auto& data = passData[i];
+			PassResult result;
+			result.name = pSlot->passes[i].name;
+			result.gpuMs = ms(data.begin, data.end);
+			result.vertices = data.statistics.IAVertices;
+			result.primitives = data.statistics.IAPrimitives;
+			result.pixelInvocations = data.statistics.PSInvocations;
+			lastFrame.passes.push_back(result);
+			Profiler::RecordGpu({ result.name,toProfiler(data.begin),toProfiler(data.end),result.vertices,result.primitives,result.pixelInvocations });
+		}
+		stats.measured++;
+		pSlot->busy = false;
+	}
+}
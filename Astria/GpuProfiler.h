@@ -0,0 +1,105 @@
+#pragma once
+#include "Graphics.h"
+#include "Profiler.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// times passes on the gpu with timestamp queries inside a disjoint query per frame, and counts their work with
+// pipeline statistics queries
+// the queries of a frame are read back frames later from a ring, a frame is only left unmeasured when the whole
+// ring is still in flight, so nothing ever waits on the gpu
+// when the device cannot make the queries every result reads zero
+class GpuProfiler
+{
+public:
+	struct PassResult
+	{
+		const char* name;
+		float gpuMs = 0.0f;
+		uint64_t vertices = 0u;
+		uint64_t primitives = 0u;
+		uint64_t pixelInvocations = 0u;
+	};
+	struct FrameResult
+	{
+		unsigned long long frame = 0u;
+		float gpuMs = 0.0f;
+		// the counter changed frequency during the frame, so its times are meaningless
+		bool disjoint = false;
+		std::vector<PassResult> passes;
+	};
+	struct Stats
+	{
+		size_t measured = 0u;
+		// frames not measured because every slot of the ring was still in flight
+		size_t skipped = 0u;
+		// passes beyond maxPasses in a frame
+		size_t droppedPasses = 0u;
+	};
+	// times the gpu work issued during its lifetime as one pass
+	class Pass
+	{
+	public:
+		Pass(Graphics& gfx, const char* name) noexcept(!IS_DEBUG);
+		Pass(const Pass&) = delete;
+		Pass& operator=(const Pass&) = delete;
+		~Pass();
+	private:
+		Graphics& gfx;
+	};
+public:
+	GpuProfiler(Graphics& gfx) noexcept;
+	GpuProfiler(const GpuProfiler&) = delete;
+	GpuProfiler& operator=(const GpuProfiler&) = delete;
+	// called by Graphics, BeginFrame also collects the finished frames of the ring
+	void BeginFrame(Graphics& gfx) noexcept;
+	void EndFrame(Graphics& gfx) noexcept(!IS_DEBUG);
+	// passes must not nest, the name must outlive the profiler
+	void BeginPass(Graphics& gfx, const char* name) noexcept(!IS_DEBUG);
+	void EndPass(Graphics& gfx) noexcept(!IS_DEBUG);
+	bool IsAvailable() const noexcept;
+	// the most recent frame read back, a few frames behind the one being drawn
+	const FrameResult& GetLastFrame() const noexcept;
+	Stats GetStats() const noexcept;
+	void SpawnWindow() noexcept;
+private:
+	struct PassQueries
+	{
+		const char* name = nullptr;
+		Microsoft::WRL::ComPtr<ID3D11Query> pBegin;
+		Microsoft::WRL::ComPtr<ID3D11Query> pEnd;
+		Microsoft::WRL::ComPtr<ID3D11Query> pStatistics;
+	};
+	static constexpr size_t maxPasses = 16u;
+	struct Slot
+	{
+		Microsoft::WRL::ComPtr<ID3D11Query> pDisjoint;
+		Microsoft::WRL::ComPtr<ID3D11Query> pBegin;
+		Microsoft::WRL::ComPtr<ID3D11Query> pEnd;
+		std::array<PassQueries, maxPasses> passes;
+		size_t passCount = 0u;
+		unsigned long long frame = 0u;
+		// Profiler clock when the frame began, gpu times are placed relative to it in traces
+		int64_t cpuStart = 0;
+		bool busy = false;
+	};
+private:
+	// reads back every finished slot, oldest first, returns at the first one still in flight
+	void Readback(Graphics& gfx) noexcept;
+private:
+	static constexpr size_t nSlots = 5u;
+	std::array<Slot, nSlots> slots;
+	Slot* pRecording = nullptr;
+	bool passOpen = false;
+	bool available = true;
+	unsigned long long frame = 0u;
+	FrameResult lastFrame;
+	Stats stats;
+};
+
+#if PROFILE_ENABLED
+#define PROFILE_GPU_PASS(gfx,name) GpuProfiler::Pass PROFILE_CONCAT(gpuPass,__LINE__)((gfx),(name))
+#else
+#define PROFILE_GPU_PASS(gfx,name)
+#endif
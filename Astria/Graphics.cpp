@@ -4,6 +4,11 @@
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
 #include "GraphicsThrowMacros.h"
+#include "FrameCapture.h"
+#include "FrameAllocator.h"
+#include "GpuProfiler.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
 #include "imgui/imgui_impl_dx11.h"
 #include "imgui/imgui_impl_win32.h"
 
@@ -115,10 +120,25 @@ Graphics::Graphics(HWND hWnd)
 
 	// init imgui d3d impl
 	ImGui_ImplDX11_Init(pDevice.Get(), pContext.Get());
+
+	pShaderManager = std::make_unique<ShaderManager>();
+	pGpuProfiler = std::make_unique<GpuProfiler>(*this);
 }
 
 Graphics::~Graphics()
 {
+	// finish writing any captures still in flight
+	if (pFrameCapture)
+	{
+		try
+		{
+			pFrameCapture->Flush(*this);
+		}
+		catch (...)
+		{
+		}
+		pFrameCapture.reset();
+	}
 	ImGui_ImplDX11_Shutdown();
 }
 
@@ -129,10 +149,19 @@ void Graphics::EndFrame()
 	// imgui frame end
 	if (imguiEnabled)
 	{
+		PROFILE_ZONE("ImGui Render");
+		PROFILE_GPU_PASS(*this, "ImGui");
 		ImGui::Render();
 		ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 	}
 
+	if (pFrameCapture)
+	{
+		pFrameCapture->OnEndFrame(*this);
+	}
+	pGpuProfiler->EndFrame(*this);
+
+	PROFILE_ZONE("Present");
 	HRESULT hr;
 #ifndef NDEBUG
 	infoManager.Set();
@@ -152,6 +181,15 @@ void Graphics::EndFrame()
 
 void Graphics::BeginFrame(float red, float green, float blue) noexcept
 {
+	// scratch memory of the frame before last is free again from here on
+	FrameAllocator::NextFrame();
+	MemoryTracker::NextFrame();
+	Profiler::NextFrame();
+	pGpuProfiler->BeginFrame(*this);
+
+	// swap in shaders that finished recompiling since last frame
+	pShaderManager->Update(*this);
+
 	// imgui begin frame
 	if (imguiEnabled)
 	{
@@ -206,6 +244,30 @@ bool Graphics::IsImguiEnabled() const noexcept
 	return imguiEnabled;
 }
 
+void Graphics::CaptureFrame(std::string filename)
+{
+	if (!pFrameCapture)
+	{
+		pFrameCapture = std::make_unique<FrameCapture>(*this);
+	}
+	pFrameCapture->Request(std::move(filename));
+}
+
+const FrameCapture* Graphics::GetFrameCapture() const noexcept
+{
+	return pFrameCapture.get();
+}
+
+ShaderManager& Graphics::GetShaderManager() noexcept
+{
+	return *pShaderManager;
+}
+
+GpuProfiler& Graphics::GetGpuProfiler() noexcept
+{
+	return *pGpuProfiler;
+}
+
 
 
 // Graphics exception stuff
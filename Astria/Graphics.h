@@ -10,11 +10,14 @@
 #include <DirectXMath.h>
 #include <memory>
 #include <random>
+#include "ShaderManager.h"
 
 
 class Graphics
 {
 	friend class Bindable;
+	friend class FrameCapture;
+	friend class GpuProfiler;
 
 public:
 	class Exception : public AstriaException
@@ -69,6 +72,12 @@ public:
 	void EnableImgui() noexcept;
 	void DisableImgui() noexcept;
 	bool IsImguiEnabled() const noexcept;
+	// writes the next presented frame to disk without stalling, the format follows the extension
+	void CaptureFrame(std::string filename);
+	const class FrameCapture* GetFrameCapture() const noexcept;
+	ShaderManager& GetShaderManager() noexcept;
+	// gpu time and pipeline statistics of the passes drawn, see PROFILE_GPU_PASS
+	class GpuProfiler& GetGpuProfiler() noexcept;
 
 
 private:
@@ -83,6 +92,9 @@ private:
 	Microsoft::WRL::ComPtr<ID3D11DeviceContext> pContext;
 	Microsoft::WRL::ComPtr<ID3D11RenderTargetView> pTarget;
 	Microsoft::WRL::ComPtr<ID3D11DepthStencilView> pDSV;
+	std::unique_ptr<class FrameCapture> pFrameCapture;
+	std::unique_ptr<ShaderManager> pShaderManager;
+	std::unique_ptr<class GpuProfiler> pGpuProfiler;
 
 
 };
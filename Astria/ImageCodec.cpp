@@ -0,0 +1,654 @@
+#include "ImageCodec.h"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+namespace
+{
+	// ---------------------------------------------------------------- byte helpers
+	void PutU32BE(std::vector<unsigned char>& out, unsigned int v)
+	{
+		out.push_back((unsigned char)(v >> 24u));
+		out.push_back((unsigned char)(v >> 16u));
+		out.push_back((unsigned char)(v >> 8u));
+		out.push_back((unsigned char)v);
+	}
+
+	void PutU32LE(std::vector<unsigned char>& out, unsigned int v)
+	{
+		out.push_back((unsigned char)v);
+		out.push_back((unsigned char)(v >> 8u));
+		out.push_back((unsigned char)(v >> 16u));
+		out.push_back((unsigned char)(v >> 24u));
+	}
+
+	void PutU16LE(std::vector<unsigned char>& out, unsigned int v)
+	{
+		out.push_back((unsigned char)v);
+		out.push_back((unsigned char)(v >> 8u));
+	}
+
+	unsigned int GetU32BE(const unsigned char* p) noexcept
+	{
+		return ((unsigned int)p[0] << 24u) | ((unsigned int)p[1] << 16u) | ((unsigned int)p[2] << 8u) | p[3];
+	}
+
+	// ---------------------------------------------------------------- checksums
+	const std::array<unsigned int, 256>& Crc32Table() noexcept
+	{
+		static const auto table = []()
+		{
+			std::array<unsigned int, 256> t = {};
+			for (unsigned int n = 0; n < 256u; n++)
+			{
+				unsigned int c = n;
+				for (int k = 0; k < 8; k++)
+				{
+					c = (c & 1u) ? 0xEDB88320u ^ (c >> 1u) : c >> 1u;
+				}
+				t[n] = c;
+			}
+			return t;
+		}();
+		return table;
+	}
+
+	unsigned int Crc32(const unsigned char* p, size_t size, unsigned int crc = 0u) noexcept
+	{
+		const auto& table = Crc32Table();
+		crc = ~crc;
+		for (size_t i = 0; i < size; i++)
+		{
+			crc = table[(crc ^ p[i]) & 0xFFu] ^ (crc >> 8u);
+		}
+		return ~crc;
+	}
+
+	unsigned int Adler32(const unsigned char* p, size_t size) noexcept
+	{
+		constexpr unsigned int mod = 65521u;
+		unsigned int a = 1u;
+		unsigned int b = 0u;
+		while (size > 0)
+		{
+			// 5552 is the largest block that cannot overflow before the modulo
+			const size_t block = std::min<size_t>(size, 5552u);
+			for (size_t i = 0; i < block; i++)
+			{
+				a += p[i];
+				b += a;
+			}
+			a %= mod;
+			b %= mod;
+			p += block;
+			size -= block;
+		}
+		return (b << 16u) | a;
+	}
+
+	// ---------------------------------------------------------------- deflate
+	class BitWriter
+	{
+	public:
+		BitWriter(std::vector<unsigned char>& out) noexcept
+			:
+			out(out)
+		{}
+		void Put(unsigned int bits, int count)
+		{
+			acc |= (unsigned long long)bits << nBits;
+			nBits += count;
+			while (nBits >= 8)
+			{
+				out.push_back((unsigned char)acc);
+				acc >>= 8u;
+				nBits -= 8;
+			}
+		}
+		// huffman codes are defined msb first but the stream is packed lsb first
+		void PutReversed(unsigned int code, int count)
+		{
+			unsigned int r = 0u;
+			for (int i = 0; i < count; i++)
+			{
+				r = (r << 1u) | ((code >> i) & 1u);
+			}
+			Put(r, count);
+		}
+		void Flush()
+		{
+			if (nBits > 0)
+			{
+				out.push_back((unsigned char)acc);
+			}
+			acc = 0u;
+			nBits = 0;
+		}
+	private:
+		std::vector<unsigned char>& out;
+		unsigned long long acc = 0u;
+		int nBits = 0;
+	};
+
+	constexpr unsigned short lengthBase[29] = {
+		3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258
+	};
+	constexpr unsigned char lengthExtra[29] = {
+		0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0
+	};
+	constexpr unsigned short distanceBase[30] = {
+		1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577
+	};
+	constexpr unsigned char distanceExtra[30] = {
+		0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13
+	};
+
+	void PutFixedLiteral(BitWriter& bw, unsigned int sym)
+	{
+		if (sym < 144u)
+		{
+			bw.PutReversed(0x30u + sym, 8);
+		}
+		else if (sym < 256u)
+		{
+			bw.PutReversed(0x190u + sym - 144u, 9);
+		}
+		else if (sym < 280u)
+		{
+			bw.PutReversed(sym - 256u, 7);
+		}
+		else
+		{
+			bw.PutReversed(0xC0u + sym - 280u, 8);
+		}
+	}
+
+	void PutMatch(BitWriter& bw, int length, int distance)
+	{
+		int li = 28;
+		while (lengthBase[li] > length)
+		{
+			li--;
+		}
+		PutFixedLiteral(bw, 257u + li);
+		bw.Put(length - lengthBase[li], lengthExtra[li]);
+
+		int di = 29;
+		while (distanceBase[di] > distance)
+		{
+			di--;
+		}
+		bw.PutReversed(di, 5);
+		bw.Put(distance - distanceBase[di], distanceExtra[di]);
+	}
+
+	void DeflateStored(std::vector<unsigned char>& out, const unsigned char* p, size_t size)
+	{
+		do
+		{
+			const size_t block = std::min<size_t>(size, 65535u);
+			out.push_back(block == size ? 1u : 0u);
+			PutU16LE(out, (unsigned int)block);
+			PutU16LE(out, (unsigned int)~block & 0xFFFFu);
+			out.insert(out.end(), p, p + block);
+			p += block;
+			size -= block;
+		} while (size > 0);
+	}
+
+	void DeflateFixed(std::vector<unsigned char>& out, const unsigned char* p, size_t size)
+	{
+		constexpr int hashBits = 15;
+		constexpr int window = 32768;
+		constexpr int maxMatch = 258;
+		std::vector<int> head(size_t(1) << hashBits, -1);
+		const auto Hash = [p](size_t i)
+		{
+			const unsigned int v = p[i] | ((unsigned int)p[i + 1] << 8u) | ((unsigned int)p[i + 2] << 16u);
+			return (v * 2654435761u) >> (32 - hashBits);
+		};
+
+		BitWriter bw(out);
+		// single final block with the fixed code tables
+		bw.Put(1u, 1);
+		bw.Put(1u, 2);
+		size_t i = 0;
+		while (i < size)
+		{
+			int bestLength = 0;
+			if (i + 3 <= size)
+			{
+				const auto h = Hash(i);
+				const int candidate = head[h];
+				head[h] = int(i);
+				if (candidate >= 0 && int(i) - candidate <= window)
+				{
+					const int limit = int(std::min<size_t>(maxMatch, size - i));
+					const unsigned char* a = p + candidate;
+					const unsigned char* b = p + i;
+					while (bestLength < limit && a[bestLength] == b[bestLength])
+					{
+						bestLength++;
+					}
+					if (bestLength >= 3)
+					{
+						PutMatch(bw, bestLength, int(i) - candidate);
+						// seed the hash table with the positions the match skipped
+						const size_t end = std::min(i + bestLength, size - 2);
+						for (size_t j = i + 1; j < end; j++)
+						{
+							head[Hash(j)] = int(j);
+						}
+						i += bestLength;
+						continue;
+					}
+				}
+			}
+			PutFixedLiteral(bw, p[i]);
+			i++;
+		}
+		PutFixedLiteral(bw, 256u);
+		bw.Flush();
+	}
+
+	std::vector<unsigned char> ZlibCompress(const std::vector<unsigned char>& data, int level)
+	{
+		std::vector<unsigned char> out;
+		out.reserve(data.size() / 2 + 64);
+		out.push_back(0x78u);
+		out.push_back(0x01u);
+		if (level <= 0)
+		{
+			DeflateStored(out, data.data(), data.size());
+		}
+		else
+		{
+			DeflateFixed(out, data.data(), data.size());
+		}
+		PutU32BE(out, Adler32(data.data(), data.size()));
+		return out;
+	}
+
+	void PutPngChunk(std::vector<unsigned char>& out, const char* type, const unsigned char* pData, size_t size)
+	{
+		PutU32BE(out, (unsigned int)size);
+		const size_t start = out.size();
+		out.insert(out.end(), type, type + 4);
+		if (size > 0)
+		{
+			out.insert(out.end(), pData, pData + size);
+		}
+		PutU32BE(out, Crc32(out.data() + start, size + 4));
+	}
+
+	// ---------------------------------------------------------------- qoi
+	constexpr unsigned char qoiOpIndex = 0x00u;
+	constexpr unsigned char qoiOpDiff = 0x40u;
+	constexpr unsigned char qoiOpLuma = 0x80u;
+	constexpr unsigned char qoiOpRun = 0xC0u;
+	constexpr unsigned char qoiOpRgb = 0xFEu;
+	constexpr unsigned char qoiOpRgba = 0xFFu;
+	constexpr unsigned char qoiMask2 = 0xC0u;
+	constexpr unsigned char qoiPadding[8] = { 0,0,0,0,0,0,0,1 };
+
+	struct QoiRgba
+	{
+		unsigned char r, g, b, a;
+		bool operator==(const QoiRgba& rhs) const noexcept
+		{
+			return r == rhs.r && g == rhs.g && b == rhs.b && a == rhs.a;
+		}
+	};
+
+	int QoiHash(const QoiRgba& c) noexcept
+	{
+		return (c.r * 3 + c.g * 5 + c.b * 7 + c.a * 11) % 64;
+	}
+
+	QoiRgba QoiFromDword(unsigned int x) noexcept
+	{
+		return { (unsigned char)(x >> 16u), (unsigned char)(x >> 8u), (unsigned char)x, (unsigned char)(x >> 24u) };
+	}
+}
+
+ImageCodec::Format ImageCodec::FormatFromFilename(const std::string& filename) noexcept
+{
+	const auto dot = filename.find_last_of('.');
+	if (dot == std::string::npos)
+	{
+		return Format::Unknown;
+	}
+	std::string ext = filename.substr(dot + 1);
+	std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+	if (ext == "bmp")
+	{
+		return Format::BMP;
+	}
+	if (ext == "png")
+	{
+		return Format::PNG;
+	}
+	if (ext == "qoi")
+	{
+		return Format::QOI;
+	}
+	return Format::Unknown;
+}
+
+std::vector<unsigned char> ImageCodec::Encode(Format format, const unsigned int* pPixels, unsigned int width, unsigned int height)
+{
+	switch (format)
+	{
+	case Format::BMP:
+		return EncodeBMP(pPixels, width, height);
+	case Format::PNG:
+		return EncodePNG(pPixels, width, height);
+	case Format::QOI:
+		return EncodeQOI(pPixels, width, height);
+	default:
+		return {};
+	}
+}
+
+std::vector<unsigned char> ImageCodec::EncodeBMP(const unsigned int* pPixels, unsigned int width, unsigned int height)
+{
+	const unsigned int imageSize = width * height * 4u;
+	std::vector<unsigned char> out;
+	out.reserve(54u + imageSize);
+	// file header
+	out.push_back('B');
+	out.push_back('M');
+	PutU32LE(out, 54u + imageSize);
+	PutU32LE(out, 0u);
+	PutU32LE(out, 54u);
+	// info header
+	PutU32LE(out, 40u);
+	PutU32LE(out, width);
+	PutU32LE(out, height);
+	PutU16LE(out, 1u);
+	PutU16LE(out, 32u);
+	PutU32LE(out, 0u);
+	PutU32LE(out, imageSize);
+	PutU32LE(out, 2835u);
+	PutU32LE(out, 2835u);
+	PutU32LE(out, 0u);
+	PutU32LE(out, 0u);
+	// rows go bottom up, a little endian dword already is b g r a
+	const size_t start = out.size();
+	out.resize(start + imageSize);
+	for (unsigned int y = 0; y < height; y++)
+	{
+		memcpy(out.data() + start + size_t(height - 1u - y) * width * 4u, pPixels + size_t(y) * width, size_t(width) * 4u);
+	}
+	return out;
+}
+
+std::vector<unsigned char> ImageCodec::EncodePNG(const unsigned int* pPixels, unsigned int width, unsigned int height, int level)
+{
+	const size_t rowBytes = size_t(width) * 4u;
+	std::vector<unsigned char> filtered((rowBytes + 1u) * height);
+	std::vector<unsigned char> row(rowBytes);
+	std::vector<unsigned char> prev(rowBytes, 0u);
+	std::array<std::vector<unsigned char>, 3> candidates;
+	for (auto& c : candidates)
+	{
+		c.resize(rowBytes);
+	}
+
+	for (unsigned int y = 0; y < height; y++)
+	{
+		const unsigned int* pRow = pPixels + size_t(y) * width;
+		for (unsigned int x = 0; x < width; x++)
+		{
+			const auto c = QoiFromDword(pRow[x]);
+			row[x * 4u + 0u] = c.r;
+			row[x * 4u + 1u] = c.g;
+			row[x * 4u + 2u] = c.b;
+			row[x * 4u + 3u] = c.a;
+		}
+		// none / sub / up, pick the one with the smallest sum of absolute residuals
+		std::array<unsigned long long, 3> cost = {};
+		for (size_t i = 0; i < rowBytes; i++)
+		{
+			const unsigned char left = i >= 4u ? row[i - 4u] : 0u;
+			candidates[0][i] = row[i];
+			candidates[1][i] = (unsigned char)(row[i] - left);
+			candidates[2][i] = (unsigned char)(row[i] - prev[i]);
+			for (int f = 0; f < 3; f++)
+			{
+				cost[f] += (unsigned long long)std::abs((int)(signed char)candidates[f][i]);
+			}
+		}
+		const int best = int(std::min_element(cost.begin(), cost.end()) - cost.begin());
+		unsigned char* pOut = filtered.data() + size_t(y) * (rowBytes + 1u);
+		pOut[0] = (unsigned char)best;
+		memcpy(pOut + 1, candidates[best].data(), rowBytes);
+		std::swap(prev, row);
+	}
+
+	const auto zdata = ZlibCompress(filtered, level);
+
+	std::vector<unsigned char> out;
+	out.reserve(zdata.size() + 64u);
+	const unsigned char signature[8] = { 0x89,'P','N','G','\r','\n',0x1A,'\n' };
+	out.insert(out.end(), signature, signature + 8);
+
+	std::vector<unsigned char> ihdr;
+	PutU32BE(ihdr, width);
+	PutU32BE(ihdr, height);
+	ihdr.push_back(8u);  // bit depth
+	ihdr.push_back(6u);  // rgba
+	ihdr.push_back(0u);  // deflate
+	ihdr.push_back(0u);  // adaptive filtering
+	ihdr.push_back(0u);  // no interlace
+	PutPngChunk(out, "IHDR", ihdr.data(), ihdr.size());
+	PutPngChunk(out, "IDAT", zdata.data(), zdata.size());
+	PutPngChunk(out, "IEND", nullptr, 0u);
+	return out;
+}
+
+std::vector<unsigned char> ImageCodec::EncodeQOI(const unsigned int* pPixels, unsigned int width, unsigned int height)
+{
+	std::vector<unsigned char> out;
+	out.reserve(14u + size_t(width) * height * 2u + 8u);
+	out.push_back('q');
+	out.push_back('o');
+	out.push_back('i');
+	out.push_back('f');
+	PutU32BE(out, width);
+	PutU32BE(out, height);
+	out.push_back(4u);
+	out.push_back(0u);
+
+	QoiRgba index[64] = {};
+	QoiRgba prev = { 0,0,0,255 };
+	int run = 0;
+	const size_t count = size_t(width) * height;
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto px = QoiFromDword(pPixels[i]);
+		if (px == prev)
+		{
+			run++;
+			if (run == 62 || i + 1 == count)
+			{
+				out.push_back(qoiOpRun | (unsigned char)(run - 1));
+				run = 0;
+			}
+			continue;
+		}
+		if (run > 0)
+		{
+			out.push_back(qoiOpRun | (unsigned char)(run - 1));
+			run = 0;
+		}
+
+		const int h = QoiHash(px);
+		if (index[h] == px)
+		{
+			out.push_back(qoiOpIndex | (unsigned char)h);
+		}
+		else
+		{
+			index[h] = px;
+			if (px.a == prev.a)
+			{
+				const signed char vr = (signed char)(px.r - prev.r);
+				const signed char vg = (signed char)(px.g - prev.g);
+				const signed char vb = (signed char)(px.b - prev.b);
+				const signed char vgr = (signed char)(vr - vg);
+				const signed char vgb = (signed char)(vb - vg);
+				if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2)
+				{
+					out.push_back(qoiOpDiff | (unsigned char)((vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+				}
+				else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8)
+				{
+					out.push_back(qoiOpLuma | (unsigned char)(vg + 32));
+					out.push_back((unsigned char)((vgr + 8) << 4 | (vgb + 8)));
+				}
+				else
+				{
+					out.push_back(qoiOpRgb);
+					out.push_back(px.r);
+					out.push_back(px.g);
+					out.push_back(px.b);
+				}
+			}
+			else
+			{
+				out.push_back(qoiOpRgba);
+				out.push_back(px.r);
+				out.push_back(px.g);
+				out.push_back(px.b);
+				out.push_back(px.a);
+			}
+		}
+		prev = px;
+	}
+	out.insert(out.end(), qoiPadding, qoiPadding + 8);
+	return out;
+}
+
+bool ImageCodec::DecodeQOI(const unsigned char* pData, size_t size, Image& out)
+{
+	if (size < 14u + 8u || memcmp(pData, "qoif", 4) != 0)
+	{
+		return false;
+	}
+	const unsigned int width = GetU32BE(pData + 4);
+	const unsigned int height = GetU32BE(pData + 8);
+	if (width == 0u || height == 0u || (unsigned long long)width * height > (1ull << 28u))
+	{
+		return false;
+	}
+	out.width = width;
+	out.height = height;
+	out.pixels.resize(size_t(width) * height);
+
+	QoiRgba index[64] = {};
+	QoiRgba px = { 0,0,0,255 };
+	size_t p = 14u;
+	const size_t end = size - 8u;
+	int run = 0;
+	for (auto& dst : out.pixels)
+	{
+		if (run > 0)
+		{
+			run--;
+		}
+		else if (p < end)
+		{
+			const unsigned char b1 = pData[p++];
+			if (b1 == qoiOpRgb)
+			{
+				if (p + 3 > end)
+				{
+					return false;
+				}
+				px.r = pData[p++];
+				px.g = pData[p++];
+				px.b = pData[p++];
+			}
+			else if (b1 == qoiOpRgba)
+			{
+				if (p + 4 > end)
+				{
+					return false;
+				}
+				px.r = pData[p++];
+				px.g = pData[p++];
+				px.b = pData[p++];
+				px.a = pData[p++];
+			}
+			else if ((b1 & qoiMask2) == qoiOpIndex)
+			{
+				px = index[b1];
+			}
+			else if ((b1 & qoiMask2) == qoiOpDiff)
+			{
+				px.r += ((b1 >> 4) & 0x03) - 2;
+				px.g += ((b1 >> 2) & 0x03) - 2;
+				px.b += (b1 & 0x03) - 2;
+			}
+			else if ((b1 & qoiMask2) == qoiOpLuma)
+			{
+				if (p + 1 > end)
+				{
+					return false;
+				}
+				const unsigned char b2 = pData[p++];
+				const int vg = (b1 & 0x3F) - 32;
+				px.r += vg - 8 + ((b2 >> 4) & 0x0F);
+				px.g += vg;
+				px.b += vg - 8 + (b2 & 0x0F);
+			}
+			else
+			{
+				run = b1 & 0x3F;
+			}
+			index[QoiHash(px)] = px;
+		}
+		else
+		{
+			return false;
+		}
+		dst = ((unsigned int)px.a << 24u) | ((unsigned int)px.r << 16u) | ((unsigned int)px.g << 8u) | px.b;
+	}
+	return true;
+}
+
+bool ImageCodec::WriteFile(const std::string& filename, const std::vector<unsigned char>& data) noexcept
+{
+	try
+	{
+		std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)data.size());
+		return bool(file);
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+bool ImageCodec::ReadFile(const std::string& filename, std::vector<unsigned char>& data)
+{
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		return false;
+	}
+	const auto size = file.tellg();
+	file.seekg(0);
+	data.resize(size_t(size));
+	file.read(reinterpret_cast<char*>(data.data()), size);
+	return bool(file);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include <string>
+
+// portable image writers (and a qoi reader) working on 32-bit 0xAARRGGBB pixels
+// kept free of windows headers so offline tools can encode without gdi+
+class ImageCodec
+{
+public:
+	enum class Format
+	{
+		Unknown,
+		BMP,
+		PNG,
+		QOI,
+	};
+	struct Image
+	{
+		unsigned int width = 0u;
+		unsigned int height = 0u;
+		std::vector<unsigned int> pixels;
+	};
+public:
+	static Format FormatFromFilename(const std::string& filename) noexcept;
+	static std::vector<unsigned char> Encode(Format format, const unsigned int* pPixels, unsigned int width, unsigned int height);
+	// 32bpp bottom-up bitmap, alpha is kept in the 4th byte
+	static std::vector<unsigned char> EncodeBMP(const unsigned int* pPixels, unsigned int width, unsigned int height);
+	// rgba8 png, per-row none/sub/up filter choice and a single-probe lz77 with fixed huffman codes
+	// favours encode speed over size, level 0 writes stored blocks only
+	static std::vector<unsigned char> EncodePNG(const unsigned int* pPixels, unsigned int width, unsigned int height, int level = 1);
+	static std::vector<unsigned char> EncodeQOI(const unsigned int* pPixels, unsigned int width, unsigned int height);
+	// returns false on malformed input
+	static bool DecodeQOI(const unsigned char* pData, size_t size, Image& out);
+	static bool WriteFile(const std::string& filename, const std::vector<unsigned char>& data) noexcept;
+	static bool ReadFile(const std::string& filename, std::vector<unsigned char>& data);
+};
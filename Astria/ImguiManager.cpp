@@ -1,9 +1,22 @@
 #include "ImguiManager.h"
 #include "imgui/imgui.h"
+#include "MemoryTracker.h"
 
 ImguiManager::ImguiManager()
 {
 	IMGUI_CHECKVERSION();
+	// imgui allocates with malloc by default, routed through operator new its memory shows up under UI
+	ImGui::SetAllocatorFunctions(
+		[](size_t size, void*) -> void*
+		{
+			MemoryTracker::Scope scope(MemoryTracker::Subsystem::UI);
+			return ::operator new(size);
+		},
+		[](void* p, void*)
+		{
+			::operator delete(p);
+		}
+	);
 	ImGui::CreateContext();
 	ImGui::StyleColorsDark();
 }
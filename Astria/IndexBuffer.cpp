@@ -17,6 +17,7 @@ IndexBuffer::IndexBuffer(Graphics& gfx, const std::vector<unsigned short>& indic
 	isd.pSysMem = indices.data();
 
 	GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&ibd, &isd, &pIndexBuffer));
+	gpuMemory.Set(ibd.ByteWidth);
 
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "Bindable.h"
+#include "MemoryTracker.h"
 
 
 class IndexBuffer : public Bindable
@@ -12,5 +13,6 @@ public:
 protected:
 	UINT count;
 	Microsoft::WRL::ComPtr<ID3D11Buffer> pIndexBuffer;
+	MemoryTracker::GpuAllocation gpuMemory{ MemoryTracker::Subsystem::Geometry };
 };
 
@@ -1,9 +1,21 @@
 #pragma once
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <execution>
 #include <DirectXMath.h>
+#include "VertexSimd.h"
 
 template<class T>
 class IndexedTriangleList {
+public:
+	enum class NormalWeighting
+	{
+		// face normal scaled by triangle area, big faces dominate
+		Area,
+		// unit face normal scaled by the corner angle, independent of how the faces are tessellated
+		Angle,
+	};
 public:
 	IndexedTriangleList() = default;
 	IndexedTriangleList(std::vector<T> verts_in, std::vector<unsigned short> indices_in)
@@ -13,11 +25,29 @@ public:
 		assert(indices.size() % 3 == 0);
 	}
 
+	// positions go through the matrix, normals (when the vertex has them) through its inverse-transpose
+	// the work is split into chunks across threads and each chunk runs the batched VertexSimd kernels
 	void Transform(DirectX::FXMMATRIX matrix) {
-		for (auto& v : vertices) {
-			const DirectX::XMVECTOR pos = DirectX::XMLoadFloat3(&v.pos);
-			DirectX::XMStoreFloat3(&v.pos, DirectX::XMVector3Transform(pos, matrix));
+		using namespace DirectX;
+		if (vertices.empty())
+		{
+			return;
 		}
+		XMFLOAT4X4 pointMatrix;
+		XMStoreFloat4x4(&pointMatrix, matrix);
+		XMFLOAT4X4 normalMatrix;
+		if constexpr (requires { &T::n; })
+		{
+			XMStoreFloat4x4(&normalMatrix, XMMatrixTranspose(XMMatrixInverse(nullptr, matrix)));
+		}
+		ForChunks(vertices.size(), [&](size_t begin, size_t end)
+		{
+			VertexSimd::TransformPoints(&vertices[begin].pos, sizeof(T), end - begin, pointMatrix);
+			if constexpr (requires { &T::n; })
+			{
+				VertexSimd::TransformNormals(&vertices[begin].n, sizeof(T), end - begin, normalMatrix);
+			}
+		});
 	}
 
 	void SetNormalsIndependentFlat() noexcept(!IS_DEBUG)
@@ -41,7 +71,262 @@ public:
 		}
 	}
 
+	// smooth normals for shared (welded) vertices, every vertex averages the weighted normals of its faces
+	// corner contributions are computed per triangle and gathered per vertex, so both passes run in parallel without atomics
+	void SetNormalsSmooth(NormalWeighting weighting = NormalWeighting::Angle) noexcept(!IS_DEBUG)
+	{
+		using namespace DirectX;
+		assert(indices.size() % 3 == 0 && indices.size() > 0);
+		std::vector<XMFLOAT3> cornerNormals(indices.size());
+		ForChunks(indices.size() / 3u, [&](size_t begin, size_t end)
+		{
+			for (size_t t = begin; t < end; t++)
+			{
+				const auto corner = t * 3u;
+				const auto p0 = XMLoadFloat3(&vertices[indices[corner]].pos);
+				const auto p1 = XMLoadFloat3(&vertices[indices[corner + 1u]].pos);
+				const auto p2 = XMLoadFloat3(&vertices[indices[corner + 2u]].pos);
+				// cross product length is twice the area
+				const auto cross = XMVector3Cross(p1 - p0, p2 - p0);
+				if (weighting == NormalWeighting::Area)
+				{
+					XMStoreFloat3(&cornerNormals[corner], cross);
+					XMStoreFloat3(&cornerNormals[corner + 1u], cross);
+					XMStoreFloat3(&cornerNormals[corner + 2u], cross);
+				}
+				else
+				{
+					const auto n = XMVector3Normalize(cross);
+					XMStoreFloat3(&cornerNormals[corner], n * CornerAngle(p0, p1, p2));
+					XMStoreFloat3(&cornerNormals[corner + 1u], n * CornerAngle(p1, p2, p0));
+					XMStoreFloat3(&cornerNormals[corner + 2u], n * CornerAngle(p2, p0, p1));
+				}
+			}
+		});
+
+		const auto adjacency = BuildAdjacency();
+		ForChunks(vertices.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t v = begin; v < end; v++)
+			{
+				auto sum = XMVectorZero();
+				for (auto c = adjacency.start[v]; c < adjacency.start[v + 1u]; c++)
+				{
+					sum += XMLoadFloat3(&cornerNormals[adjacency.corners[c]]);
+				}
+				XMStoreFloat3(&vertices[v].n, XMVector3Normalize(sum));
+			}
+		});
+	}
+
+	// per vertex tangent frame for normal mapping, needs pos, n and tc and writes tangent and bitangent
+	// follows MikkTSpace: tangents from the uv gradients are projected into each vertex normal's plane and
+	// angle weighted per corner, then orthogonalized, the bitangent keeps the handedness of the uv mapping
+	// vertices are not split on tangent space seams, run SplitHardEdges / keep uv seams unwelded for that
+	void SetTangents() noexcept(!IS_DEBUG)
+	{
+		using namespace DirectX;
+		assert(indices.size() % 3 == 0 && indices.size() > 0);
+		std::vector<XMFLOAT3> cornerTangents(indices.size());
+		std::vector<XMFLOAT3> cornerBitangents(indices.size());
+		ForChunks(indices.size() / 3u, [&](size_t begin, size_t end)
+		{
+			for (size_t t = begin; t < end; t++)
+			{
+				const auto corner = t * 3u;
+				const T* v[3] = { &vertices[indices[corner]],&vertices[indices[corner + 1u]],&vertices[indices[corner + 2u]] };
+				XMVECTOR p[3];
+				for (size_t k = 0u; k < 3u; k++)
+				{
+					p[k] = XMLoadFloat3(&v[k]->pos);
+				}
+				const auto e1 = p[1] - p[0];
+				const auto e2 = p[2] - p[0];
+				const float du1 = v[1]->tc.x - v[0]->tc.x;
+				const float dv1 = v[1]->tc.y - v[0]->tc.y;
+				const float du2 = v[2]->tc.x - v[0]->tc.x;
+				const float dv2 = v[2]->tc.y - v[0]->tc.y;
+				const float det = du1 * dv2 - du2 * dv1;
+				// a face without uv area has no defined tangent and contributes nothing
+				const float r = std::abs(det) > 1e-12f ? 1.0f / det : 0.0f;
+				const auto faceTangent = (e1 * dv2 - e2 * dv1) * r;
+				const auto faceBitangent = (e2 * du1 - e1 * du2) * r;
+				for (size_t k = 0u; k < 3u; k++)
+				{
+					const auto n = XMVector3Normalize(XMLoadFloat3(&v[k]->n));
+					const float angle = CornerAngle(p[k], p[(k + 1u) % 3u], p[(k + 2u) % 3u]);
+					XMStoreFloat3(&cornerTangents[corner + k], XMVector3Normalize(faceTangent - n * XMVector3Dot(n, faceTangent)) * angle);
+					XMStoreFloat3(&cornerBitangents[corner + k], XMVector3Normalize(faceBitangent - n * XMVector3Dot(n, faceBitangent)) * angle);
+				}
+			}
+		});
+
+		const auto adjacency = BuildAdjacency();
+		ForChunks(vertices.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				auto tangent = XMVectorZero();
+				auto bitangent = XMVectorZero();
+				for (auto c = adjacency.start[i]; c < adjacency.start[i + 1u]; c++)
+				{
+					tangent += XMLoadFloat3(&cornerTangents[adjacency.corners[c]]);
+					bitangent += XMLoadFloat3(&cornerBitangents[adjacency.corners[c]]);
+				}
+				auto& v = vertices[i];
+				const auto n = XMVector3Normalize(XMLoadFloat3(&v.n));
+				tangent = XMVector3Normalize(tangent - n * XMVector3Dot(n, tangent));
+				const auto handedness = XMVectorGetX(XMVector3Dot(XMVector3Cross(n, tangent), bitangent)) < 0.0f ? -1.0f : 1.0f;
+				XMStoreFloat3(&v.tangent, tangent);
+				XMStoreFloat3(&v.bitangent, XMVector3Cross(n, tangent) * handedness);
+			}
+		});
+	}
+
+	// gives every vertex one copy per group of faces whose normals lie within maxAngle (radians) of each other,
+	// so a following SetNormalsSmooth keeps creases sharp while smooth regions stay shared, returns the vertices added
+	size_t SplitHardEdges(float maxAngle) noexcept(!IS_DEBUG)
+	{
+		using namespace DirectX;
+		assert(indices.size() % 3 == 0 && indices.size() > 0);
+		const size_t triangleCount = indices.size() / 3u;
+		std::vector<XMFLOAT3> faceNormals(triangleCount);
+		ForChunks(triangleCount, [&](size_t begin, size_t end)
+		{
+			for (size_t t = begin; t < end; t++)
+			{
+				const auto p0 = XMLoadFloat3(&vertices[indices[t * 3u]].pos);
+				const auto p1 = XMLoadFloat3(&vertices[indices[t * 3u + 1u]].pos);
+				const auto p2 = XMLoadFloat3(&vertices[indices[t * 3u + 2u]].pos);
+				XMStoreFloat3(&faceNormals[t], XMVector3Normalize(XMVector3Cross(p1 - p0, p2 - p0)));
+			}
+		});
+
+		// corners join the first group whose founding face is close enough, otherwise found a new group
+		const float minCos = std::cos(maxAngle);
+		const auto adjacency = BuildAdjacency();
+		std::vector<unsigned int> cornerGroup(indices.size());
+		std::vector<char> foundsGroup(indices.size());
+		std::vector<unsigned int> groupCount(vertices.size());
+		ForChunks(vertices.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t v = begin; v < end; v++)
+			{
+				unsigned int groups = 0u;
+				const auto first = adjacency.start[v];
+				for (auto c = first; c < adjacency.start[v + 1u]; c++)
+				{
+					const auto corner = adjacency.corners[c];
+					const auto n = XMLoadFloat3(&faceNormals[corner / 3u]);
+					bool joined = false;
+					for (auto f = first; f < c && !joined; f++)
+					{
+						const auto founder = adjacency.corners[f];
+						if (foundsGroup[founder] && XMVectorGetX(XMVector3Dot(n, XMLoadFloat3(&faceNormals[founder / 3u]))) >= minCos)
+						{
+							cornerGroup[corner] = cornerGroup[founder];
+							joined = true;
+						}
+					}
+					if (!joined)
+					{
+						foundsGroup[corner] = 1;
+						cornerGroup[corner] = groups++;
+					}
+				}
+				groupCount[v] = groups;
+			}
+		});
+
+		// groups past the first become new vertices appended at the end
+		std::vector<size_t> firstExtra(vertices.size());
+		size_t added = 0u;
+		for (size_t v = 0u; v < vertices.size(); v++)
+		{
+			firstExtra[v] = vertices.size() + added;
+			added += groupCount[v] > 0u ? groupCount[v] - 1u : 0u;
+		}
+		assert("Split mesh exceeds 16-bit indices" && vertices.size() + added <= 0x10000u);
+		vertices.resize(vertices.size() + added);
+		ForChunks(firstExtra.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t v = begin; v < end; v++)
+			{
+				for (unsigned int g = 1u; g < groupCount[v]; g++)
+				{
+					vertices[firstExtra[v] + g - 1u] = vertices[v];
+				}
+				for (auto c = adjacency.start[v]; c < adjacency.start[v + 1u]; c++)
+				{
+					const auto corner = adjacency.corners[c];
+					if (cornerGroup[corner] != 0u)
+					{
+						indices[corner] = (unsigned short)(firstExtra[v] + cornerGroup[corner] - 1u);
+					}
+				}
+			}
+		});
+		return added;
+	}
+
+private:
+	// corners (positions in indices) using each vertex, corners of vertex v are corners[start[v]] .. corners[start[v + 1] - 1]
+	struct Adjacency
+	{
+		std::vector<unsigned int> start;
+		std::vector<unsigned int> corners;
+	};
+	Adjacency BuildAdjacency() const
+	{
+		Adjacency adjacency;
+		adjacency.start.assign(vertices.size() + 1u, 0u);
+		for (const auto i : indices)
+		{
+			adjacency.start[i + 1u]++;
+		}
+		for (size_t v = 0u; v < vertices.size(); v++)
+		{
+			adjacency.start[v + 1u] += adjacency.start[v];
+		}
+		adjacency.corners.resize(indices.size());
+		auto next = adjacency.start;
+		for (size_t c = 0u; c < indices.size(); c++)
+		{
+			adjacency.corners[next[indices[c]]++] = (unsigned int)c;
+		}
+		return adjacency;
+	}
+	// interior angle at p between the edges to a and b
+	static float CornerAngle(DirectX::FXMVECTOR p, DirectX::FXMVECTOR a, DirectX::FXMVECTOR b) noexcept
+	{
+		using namespace DirectX;
+		const float cosine = XMVectorGetX(XMVector3Dot(XMVector3Normalize(a - p), XMVector3Normalize(b - p)));
+		return std::acos(std::clamp(cosine, -1.0f, 1.0f));
+	}
+	// runs f(begin, end) over [0, count), split across threads once there is enough work
+	template<typename F>
+	static void ForChunks(size_t count, F&& f)
+	{
+		if (count < parallelThreshold)
+		{
+			f(size_t(0u), count);
+			return;
+		}
+		std::vector<size_t> chunks((count + chunkSize - 1u) / chunkSize);
+		for (size_t i = 0u; i < chunks.size(); i++)
+		{
+			chunks[i] = i * chunkSize;
+		}
+		std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](size_t begin)
+		{
+			f(begin, std::min(begin + chunkSize, count));
+		});
+	}
+
 public:
 	std::vector<T> vertices;
 	std::vector<unsigned short> indices;
-};
\ No newline at end of file
+private:
+	static constexpr size_t parallelThreshold = 1u << 14u;
+	static constexpr size_t chunkSize = 1u << 12u;
+};
@@ -1,7 +1,8 @@
 #include "InputLayout.h"
 #include "GraphicsThrowMacros.h"
+#include <sstream>
 
-InputLayout::InputLayout(Graphics& gfx, const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout, ID3DBlob* pVertexShaderBytecode)
+InputLayout::InputLayout(Graphics& gfx, std::span<const D3D11_INPUT_ELEMENT_DESC> layout, ID3DBlob* pVertexShaderBytecode)
 {
 	INFOMAN(gfx);
 
@@ -14,3 +15,22 @@ void InputLayout::Bind(Graphics& gfx) noexcept
 {
 	GetContext(gfx)->IASetInputLayout(pInputLayout.Get());
 }
+
+std::string InputLayout::GenerateUID(std::span<const D3D11_INPUT_ELEMENT_DESC> layout, ID3DBlob* pVertexShaderBytecode)
+{
+	std::ostringstream oss;
+	for (const auto& e : layout)
+	{
+		oss << e.SemanticName << e.SemanticIndex << ':' << e.Format << ':' << e.InputSlot << ':'
+			<< e.AlignedByteOffset << ':' << e.InputSlotClass << ':' << e.InstanceDataStepRate << ';';
+	}
+	// fnv-1a over the shader bytecode
+	unsigned long long hash = 14695981039346656037ull;
+	const auto pBytes = static_cast<const unsigned char*>(pVertexShaderBytecode->GetBufferPointer());
+	for (size_t i = 0u; i < pVertexShaderBytecode->GetBufferSize(); i++)
+	{
+		hash = (hash ^ pBytes[i]) * 1099511628211ull;
+	}
+	oss << std::hex << hash;
+	return oss.str();
+}
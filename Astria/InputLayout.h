@@ -1,12 +1,15 @@
 #pragma once
 #include "Bindable.h"
+#include <span>
 
 class InputLayout : public Bindable
 {
 public:
-	InputLayout(Graphics& gfx, const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout,
+	InputLayout(Graphics& gfx, std::span<const D3D11_INPUT_ELEMENT_DESC> layout,
 		ID3DBlob* pVertexShaderBytecode);
 	void Bind(Graphics& gfx)  noexcept override;
+	// layouts are only valid against a matching signature, so the bytecode contents are part of the key
+	static std::string GenerateUID(std::span<const D3D11_INPUT_ELEMENT_DESC> layout, ID3DBlob* pVertexShaderBytecode);
 protected:
 	Microsoft::WRL::ComPtr<ID3D11InputLayout> pInputLayout;
 };
@@ -0,0 +1,359 @@
+#include "MemoryTracker.h"
+#include "FrameAllocator.h"
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <sstream>
+
+MemoryTracker::Counter MemoryTracker::counters[MemoryTracker::subsystemCount][MemoryTracker::kindCount];
+thread_local MemoryTracker::Subsystem MemoryTracker::current = MemoryTracker::Subsystem::Other;
+
+namespace
+{
+	// ring of snapshots, written by the render thread and read by the ui and the exporters
+	std::mutex historyMutex;
+	std::vector<MemoryTracker::Snapshot> history;
+	size_t historyNext = 0u;
+	size_t frame = 0u;
+}
+
+MemoryTracker::Scope::Scope(Subsystem subsystem) noexcept
+	:
+	previous(current)
+{
+	current = subsystem;
+}
+
+MemoryTracker::Scope::~Scope()
+{
+	current = previous;
+}
+
+MemoryTracker::GpuAllocation::GpuAllocation(Subsystem subsystem) noexcept
+	:
+	subsystem(subsystem)
+{}
+
+MemoryTracker::GpuAllocation::~GpuAllocation()
+{
+	Set(0u);
+}
+
+void MemoryTracker::GpuAllocation::Set(size_t bytes_in) noexcept
+{
+	if (bytes_in > bytes)
+	{
+		Add(subsystem, Kind::Gpu, bytes_in - bytes);
+	}
+	else if (bytes_in < bytes)
+	{
+		Release(subsystem, Kind::Gpu, bytes - bytes_in);
+	}
+	bytes = bytes_in;
+}
+
+size_t MemoryTracker::GpuAllocation::GetBytes() const noexcept
+{
+	return bytes;
+}
+
+void MemoryTracker::Add(Subsystem subsystem, Kind kind, size_t bytes) noexcept
+{
+	auto& counter = counters[size_t(subsystem)][size_t(kind)];
+	const auto now = counter.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	counter.allocations.fetch_add(1u, std::memory_order_relaxed);
+	auto peak = counter.peak.load(std::memory_order_relaxed);
+	while (now > peak && !counter.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed))
+	{
+	}
+}
+
+void MemoryTracker::Release(Subsystem subsystem, Kind kind, size_t bytes) noexcept
+{
+	counters[size_t(subsystem)][size_t(kind)].bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryTracker::Subsystem MemoryTracker::GetCurrent() noexcept
+{
+	return current;
+}
+
+MemoryTracker::Usage MemoryTracker::GetUsage(Subsystem subsystem, Kind kind) noexcept
+{
+	const auto& counter = counters[size_t(subsystem)][size_t(kind)];
+	Usage usage;
+	usage.bytes = counter.bytes.load(std::memory_order_relaxed);
+	usage.peak = counter.peak.load(std::memory_order_relaxed);
+	usage.allocations = counter.allocations.load(std::memory_order_relaxed);
+	return usage;
+}
+
+const char* MemoryTracker::GetName(Subsystem subsystem) noexcept
+{
+	switch (subsystem)
+	{
+	case Subsystem::Other:
+		return "Other";
+	case Subsystem::Geometry:
+		return "Geometry";
+	case Subsystem::Textures:
+		return "Textures";
+	case Subsystem::Shaders:
+		return "Shaders";
+	case Subsystem::Constants:
+		return "Constants";
+	case Subsystem::Drawables:
+		return "Drawables";
+	case Subsystem::UI:
+		return "UI";
+	default:
+		return "?";
+	}
+}
+
+void MemoryTracker::NextFrame()
+{
+	Snapshot snapshot;
+	snapshot.frame = frame++;
+	for (size_t s = 0; s < subsystemCount; s++)
+	{
+		for (size_t k = 0; k < kindCount; k++)
+		{
+			snapshot.usage[s][k] = GetUsage(Subsystem(s), Kind(k));
+		}
+	}
+	std::lock_guard<std::mutex> lock(historyMutex);
+	if (history.size() < historySize)
+	{
+		history.push_back(snapshot);
+	}
+	else
+	{
+		history[historyNext] = snapshot;
+	}
+	historyNext = (historyNext + 1u) % historySize;
+}
+
+std::vector<MemoryTracker::Snapshot> MemoryTracker::GetHistory()
+{
+	std::lock_guard<std::mutex> lock(historyMutex);
+	if (history.size() < historySize)
+	{
+		return history;
+	}
+	std::vector<Snapshot> ordered(history.begin() + historyNext, history.end());
+	ordered.insert(ordered.end(), history.begin(), history.begin() + historyNext);
+	return ordered;
+}
+
+void MemoryTracker::ExportCsv(const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		throw Exception(__LINE__, __FILE__, "Failed to open " + path + " for writing");
+	}
+	file << "frame,subsystem,kind,bytes,peak,allocations\n";
+	for (const auto& snapshot : GetHistory())
+	{
+		for (size_t s = 0; s < subsystemCount; s++)
+		{
+			for (size_t k = 0; k < kindCount; k++)
+			{
+				const auto& usage = snapshot.usage[s][k];
+				file << snapshot.frame << ',' << GetName(Subsystem(s)) << ',' << (Kind(k) == Kind::Cpu ? "cpu" : "gpu") << ','
+					<< usage.bytes << ',' << usage.peak << ',' << usage.allocations << '\n';
+			}
+		}
+	}
+	if (!file)
+	{
+		throw Exception(__LINE__, __FILE__, "Failed to write " + path);
+	}
+}
+
+void MemoryTracker::ExportJson(const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		throw Exception(__LINE__, __FILE__, "Failed to open " + path + " for writing");
+	}
+	file << "{\"frames\":[";
+	const auto snapshots = GetHistory();
+	for (size_t i = 0; i < snapshots.size(); i++)
+	{
+		file << (i > 0u ? "," : "") << "\n{\"frame\":" << snapshots[i].frame << ",\"subsystems\":{";
+		for (size_t s = 0; s < subsystemCount; s++)
+		{
+			file << (s > 0u ? "," : "") << '"' << GetName(Subsystem(s)) << "\":{";
+			for (size_t k = 0; k < kindCount; k++)
+			{
+				const auto& usage = snapshots[i].usage[s][k];
+				file << (k > 0u ? "," : "") << (Kind(k) == Kind::Cpu ? "\"cpu\"" : "\"gpu\"")
+					<< ":{\"bytes\":" << usage.bytes << ",\"peak\":" << usage.peak << ",\"allocations\":" << usage.allocations << '}';
+			}
+			file << '}';
+		}
+		file << "}}";
+	}
+	file << "\n]}\n";
+	if (!file)
+	{
+		throw Exception(__LINE__, __FILE__, "Failed to write " + path);
+	}
+}
+
+
+MemoryTracker::Exception::Exception(int line, const char* file, std::string note) noexcept
+	:
+	AstriaException(line, file),
+	note(std::move(note))
+{}
+
+const char* MemoryTracker::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << AstriaException::what() << std::endl
+		<< "[Note] " << GetNote();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* MemoryTracker::Exception::GetType() const noexcept
+{
+	return "Astria Memory Tracker Exception";
+}
+
+const std::string& MemoryTracker::Exception::GetNote() const noexcept
+{
+	return note;
+}
+
+
+// global operator new replacement, every block carries the size and subsystem it was charged to so
+// the matching delete can give it back, the nothrow and array forms forward to these by default
+// builds that measure raw allocator cost (the benchmarks) define NO_HEAP_TRACKING and keep the standard ones
+#ifndef NO_HEAP_TRACKING
+namespace
+{
+	struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) BlockHeader
+	{
+		size_t size;
+		MemoryTracker::Subsystem subsystem;
+	};
+	// over-aligned blocks sit at an offset into their malloc block, the header keeps where that starts
+	struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) AlignedBlockHeader
+	{
+		void* pBlock;
+		size_t size;
+		MemoryTracker::Subsystem subsystem;
+	};
+
+	// the header lies before the block handed out, the address is computed as an integer since the compiler
+	// would otherwise see a pointer stepping off the front of the object it was given
+	template<class Header>
+	Header* HeaderOf(void* p) noexcept
+	{
+		return reinterpret_cast<Header*>(reinterpret_cast<uintptr_t>(p) - sizeof(Header));
+	}
+}
+
+void* operator new(size_t size)
+{
+	FrameAllocator::CountHeapAllocation();
+	const auto pHeader = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + size));
+	if (pHeader == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	pHeader->size = size;
+	pHeader->subsystem = MemoryTracker::GetCurrent();
+	MemoryTracker::Add(pHeader->subsystem, MemoryTracker::Kind::Cpu, size);
+	return reinterpret_cast<char*>(pHeader) + sizeof(BlockHeader);
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	if (p == nullptr)
+	{
+		return;
+	}
+	const auto pHeader = HeaderOf<BlockHeader>(p);
+	MemoryTracker::Release(pHeader->subsystem, MemoryTracker::Kind::Cpu, pHeader->size);
+	std::free(pHeader);
+}
+
+void operator delete[](void* p) noexcept
+{
+	operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	operator delete(p);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	FrameAllocator::CountHeapAllocation();
+	const auto align = size_t(alignment);
+	// room for the header and for sliding the block up to the next multiple of align
+	char* const pBlock = static_cast<char*>(std::malloc(sizeof(AlignedBlockHeader) + align + size));
+	if (pBlock == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	const auto address = reinterpret_cast<uintptr_t>(pBlock) + sizeof(AlignedBlockHeader);
+	char* const p = pBlock + ((address + align - 1u) & ~uintptr_t(align - 1u)) - reinterpret_cast<uintptr_t>(pBlock);
+	const auto pHeader = HeaderOf<AlignedBlockHeader>(p);
+	pHeader->pBlock = pBlock;
+	pHeader->size = size;
+	pHeader->subsystem = MemoryTracker::GetCurrent();
+	MemoryTracker::Add(pHeader->subsystem, MemoryTracker::Kind::Cpu, size);
+	return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+	if (p == nullptr)
+	{
+		return;
+	}
+	const auto pHeader = HeaderOf<AlignedBlockHeader>(p);
+	MemoryTracker::Release(pHeader->subsystem, MemoryTracker::Kind::Cpu, pHeader->size);
+	std::free(pHeader->pBlock);
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+	operator delete(p, alignment);
+}
+
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(p, alignment);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(p, alignment);
+}
+#endif
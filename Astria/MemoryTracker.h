@@ -0,0 +1,107 @@
+#pragma once
+#include "AstriaException.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// memory use by subsystem with high-water marks and a per frame history that can be exported
+// cpu bytes are counted by the replaced global operator new, plain and over-aligned forms, under the innermost Scope
+// of the allocating thread, gpu bytes are reported by the resources that create them through a GpuAllocation member
+// with NO_HEAP_TRACKING defined the operators are not replaced, cpu usage and the heap counts of FrameAllocator stay zero
+class MemoryTracker
+{
+public:
+	class Exception : public AstriaException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::string note;
+	};
+	enum class Subsystem
+	{
+		Other,
+		Geometry,
+		Textures,
+		Shaders,
+		Constants,
+		Drawables,
+		UI,
+		Count
+	};
+	enum class Kind
+	{
+		Cpu,
+		Gpu,
+		Count
+	};
+	static constexpr size_t subsystemCount = size_t(Subsystem::Count);
+	static constexpr size_t kindCount = size_t(Kind::Count);
+	struct Usage
+	{
+		size_t bytes = 0u;
+		// high-water mark of bytes since startup
+		size_t peak = 0u;
+		// allocations made since startup
+		size_t allocations = 0u;
+	};
+	struct Snapshot
+	{
+		size_t frame = 0u;
+		std::array<std::array<Usage, kindCount>, subsystemCount> usage;
+	};
+	// heap allocations of the constructing thread are charged to the subsystem while the scope lives
+	class Scope
+	{
+	public:
+		Scope(Subsystem subsystem) noexcept;
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		~Scope();
+	private:
+		Subsystem previous;
+	};
+	// gpu bytes owned by a resource, given back when the owner goes away
+	class GpuAllocation
+	{
+	public:
+		GpuAllocation(Subsystem subsystem) noexcept;
+		GpuAllocation(const GpuAllocation&) = delete;
+		GpuAllocation& operator=(const GpuAllocation&) = delete;
+		~GpuAllocation();
+		void Set(size_t bytes) noexcept;
+		size_t GetBytes() const noexcept;
+	private:
+		Subsystem subsystem;
+		size_t bytes = 0u;
+	};
+public:
+	static void Add(Subsystem subsystem, Kind kind, size_t bytes) noexcept;
+	static void Release(Subsystem subsystem, Kind kind, size_t bytes) noexcept;
+	static Subsystem GetCurrent() noexcept;
+	static Usage GetUsage(Subsystem subsystem, Kind kind) noexcept;
+	static const char* GetName(Subsystem subsystem) noexcept;
+	// records a snapshot into the history, called once per frame by Graphics::BeginFrame
+	static void NextFrame();
+	// the last historySize snapshots, oldest first
+	static std::vector<Snapshot> GetHistory();
+	// one row per frame, subsystem and kind
+	static void ExportCsv(const std::string& path);
+	static void ExportJson(const std::string& path);
+private:
+	struct Counter
+	{
+		std::atomic<size_t> bytes = 0u;
+		std::atomic<size_t> peak = 0u;
+		std::atomic<size_t> allocations = 0u;
+	};
+private:
+	static Counter counters[subsystemCount][kindCount];
+	static thread_local Subsystem current;
+	static constexpr size_t historySize = 600u;
+};
@@ -0,0 +1,282 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+// merges duplicate vertices of an IndexedTriangleList, compacts the vertex buffer and rewrites the indices
+// lookups go through an open addressing table keyed by a hash of the vertex (Bitwise) or of its position cell (Epsilon)
+// surviving vertices are stored in the order the indices first reference them, unreferenced vertices are dropped
+class MeshWelder
+{
+public:
+	enum class Mode
+	{
+		// vertices merge when their object representation is identical, padding bytes included
+		// (value initialized vertices have zeroed padding, memberwise assigned ones are not guaranteed to)
+		Bitwise,
+		// vertices merge when every compared component lies within the epsilon, positions are snapped to
+		// epsilon sized cells and the 27 neighbouring cells are searched so no pair within reach is missed
+		Epsilon,
+	};
+	struct Options
+	{
+		Mode mode = Mode::Bitwise;
+		float positionEpsilon = 1e-5f;
+		float attributeEpsilon = 1e-4f;
+		// merge on position alone and keep the attributes of the first vertex seen, e.g. ahead of SetNormalsSmooth
+		bool positionOnly = false;
+	};
+	struct Stats
+	{
+		size_t verticesBefore = 0u;
+		size_t verticesAfter = 0u;
+		// vertices no index referred to
+		size_t unreferenced = 0u;
+		// triangles that collapsed onto fewer than three distinct vertices and were removed
+		size_t degenerateTriangles = 0u;
+		size_t bytesSaved = 0u;
+	};
+public:
+	template<class V>
+	static Stats Weld(IndexedTriangleList<V>& mesh)
+	{
+		return Weld(mesh, Options{});
+	}
+	template<class V>
+	static Stats Weld(IndexedTriangleList<V>& mesh, const Options& options) noexcept(!IS_DEBUG)
+	{
+		assert(mesh.indices.size() % 3 == 0);
+		assert("Epsilon welding compares pos, n, tc, tex, tangent and bitangent only, the vertex holds other data" &&
+			(options.mode == Mode::Bitwise || options.positionOnly || ComparedBytes<V>() == sizeof(V)));
+		assert(options.mode == Mode::Bitwise || options.positionEpsilon > 0.0f);
+
+		Stats stats;
+		stats.verticesBefore = mesh.vertices.size();
+
+		size_t tableSize = 16u;
+		while (tableSize < mesh.vertices.size() * 2u)
+		{
+			tableSize <<= 1u;
+		}
+		const size_t mask = tableSize - 1u;
+		std::vector<unsigned int> table(tableSize, empty);
+		// remap from the old vertex index to the welded one
+		std::vector<unsigned int> remap(mesh.vertices.size(), empty);
+		std::vector<V> welded;
+		welded.reserve(mesh.vertices.size());
+		// position cell of every welded vertex, Epsilon only
+		std::vector<Cell> cells;
+
+		const float invCell = options.mode == Mode::Epsilon ? 1.0f / options.positionEpsilon : 0.0f;
+		for (const auto i : mesh.indices)
+		{
+			if (remap[i] != empty)
+			{
+				continue;
+			}
+			const V& v = mesh.vertices[i];
+			unsigned int match = empty;
+			size_t slot = 0u;
+			if (options.mode == Mode::Bitwise)
+			{
+				const auto hash = options.positionOnly ? HashBytes(&v.pos, sizeof(v.pos)) : HashBytes(&v, sizeof(V));
+				for (slot = hash & mask; table[slot] != empty; slot = (slot + 1u) & mask)
+				{
+					const V& other = welded[table[slot]];
+					if (options.positionOnly ? std::memcmp(&other.pos, &v.pos, sizeof(v.pos)) == 0 : std::memcmp(&other, &v, sizeof(V)) == 0)
+					{
+						match = table[slot];
+						break;
+					}
+				}
+			}
+			else
+			{
+				const Cell cell = {
+					(int64_t)std::floor(v.pos.x * invCell),
+					(int64_t)std::floor(v.pos.y * invCell),
+					(int64_t)std::floor(v.pos.z * invCell),
+				};
+				for (int64_t dz = -1; dz <= 1 && match == empty; dz++)
+				{
+					for (int64_t dy = -1; dy <= 1 && match == empty; dy++)
+					{
+						for (int64_t dx = -1; dx <= 1 && match == empty; dx++)
+						{
+							const Cell neighbour = { cell.x + dx,cell.y + dy,cell.z + dz };
+							for (auto s = HashCell(neighbour) & mask; table[s] != empty; s = (s + 1u) & mask)
+							{
+								const auto e = table[s];
+								if (cells[e] == neighbour && Near(welded[e], v, options))
+								{
+									match = e;
+									break;
+								}
+							}
+						}
+					}
+				}
+				if (match == empty)
+				{
+					slot = HashCell(cell) & mask;
+					while (table[slot] != empty)
+					{
+						slot = (slot + 1u) & mask;
+					}
+					cells.push_back(cell);
+				}
+			}
+			if (match == empty)
+			{
+				match = (unsigned int)welded.size();
+				table[slot] = match;
+				welded.push_back(v);
+			}
+			remap[i] = match;
+		}
+
+		// rewrite the indices in place, dropping triangles that lost a corner to the merge
+		size_t out = 0u;
+		for (size_t t = 0u; t < mesh.indices.size(); t += 3u)
+		{
+			const auto a = (unsigned short)remap[mesh.indices[t]];
+			const auto b = (unsigned short)remap[mesh.indices[t + 1u]];
+			const auto c = (unsigned short)remap[mesh.indices[t + 2u]];
+			if (a == b || b == c || a == c)
+			{
+				stats.degenerateTriangles++;
+				continue;
+			}
+			mesh.indices[out++] = a;
+			mesh.indices[out++] = b;
+			mesh.indices[out++] = c;
+		}
+		mesh.indices.resize(out);
+
+		for (const auto r : remap)
+		{
+			stats.unreferenced += r == empty ? 1u : 0u;
+		}
+		stats.verticesAfter = welded.size();
+		stats.bytesSaved = (stats.verticesBefore - stats.verticesAfter) * sizeof(V);
+		mesh.vertices = std::move(welded);
+		return stats;
+	}
+private:
+	struct Cell
+	{
+		int64_t x;
+		int64_t y;
+		int64_t z;
+		bool operator==(const Cell&) const = default;
+	};
+	static uint64_t Mix(uint64_t hash, uint64_t word) noexcept
+	{
+		hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+		return hash ^ (hash >> 29u);
+	}
+	static uint64_t HashBytes(const void* pData, size_t size) noexcept
+	{
+		const auto pBytes = static_cast<const unsigned char*>(pData);
+		uint64_t hash = 0xCBF29CE484222325ull;
+		size_t i = 0u;
+		for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+		{
+			uint64_t word;
+			std::memcpy(&word, pBytes + i, sizeof(word));
+			hash = Mix(hash, word);
+		}
+		for (; i < size; i++)
+		{
+			hash = Mix(hash, pBytes[i]);
+		}
+		return hash;
+	}
+	static uint64_t HashCell(const Cell& cell) noexcept
+	{
+		return Mix(Mix(Mix(0xCBF29CE484222325ull, (uint64_t)cell.x), (uint64_t)cell.y), (uint64_t)cell.z);
+	}
+	// componentwise comparison of the XMFLOATn attribute types
+	template<class A>
+	static bool NearComponents(const A& a, const A& b, float epsilon) noexcept
+	{
+		static_assert(sizeof(A) % sizeof(float) == 0);
+		const auto pA = reinterpret_cast<const float*>(&a);
+		const auto pB = reinterpret_cast<const float*>(&b);
+		for (size_t i = 0u; i < sizeof(A) / sizeof(float); i++)
+		{
+			if (!(std::abs(pA[i] - pB[i]) <= epsilon))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	template<class V>
+	static bool Near(const V& a, const V& b, const Options& options) noexcept
+	{
+		if (!NearComponents(a.pos, b.pos, options.positionEpsilon))
+		{
+			return false;
+		}
+		if (options.positionOnly)
+		{
+			return true;
+		}
+		const float epsilon = options.attributeEpsilon;
+		bool within = true;
+		if constexpr (requires { a.n; })
+		{
+			within = within && NearComponents(a.n, b.n, epsilon);
+		}
+		if constexpr (requires { a.tc; })
+		{
+			within = within && NearComponents(a.tc, b.tc, epsilon);
+		}
+		if constexpr (requires { a.tex; })
+		{
+			within = within && NearComponents(a.tex, b.tex, epsilon);
+		}
+		if constexpr (requires { a.tangent; })
+		{
+			within = within && NearComponents(a.tangent, b.tangent, epsilon);
+		}
+		if constexpr (requires { a.bitangent; })
+		{
+			within = within && NearComponents(a.bitangent, b.bitangent, epsilon);
+		}
+		return within;
+	}
+	// bytes of V covered by Near, anything else in the vertex would be silently ignored by Epsilon mode
+	template<class V>
+	static constexpr size_t ComparedBytes() noexcept
+	{
+		size_t bytes = sizeof(V::pos);
+		if constexpr (requires { &V::n; })
+		{
+			bytes += sizeof(V::n);
+		}
+		if constexpr (requires { &V::tc; })
+		{
+			bytes += sizeof(V::tc);
+		}
+		if constexpr (requires { &V::tex; })
+		{
+			bytes += sizeof(V::tex);
+		}
+		if constexpr (requires { &V::tangent; })
+		{
+			bytes += sizeof(V::tangent);
+		}
+		if constexpr (requires { &V::bitangent; })
+		{
+			bytes += sizeof(V::bitangent);
+		}
+		return bytes;
+	}
+private:
+	static constexpr unsigned int empty = ~0u;
+};
@@ -0,0 +1,348 @@
+#include "MeshletBuilder.h"
+#include "Profiler.h"
+#include <assimp/mesh.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace dx = DirectX;
+
+namespace
+{
+	// a cone whose normals spread further than this cannot reject anything from any viewpoint worth testing
+	constexpr float minConeDot = 0.1f;
+
+	void FinishMeshlet(MeshletBuilder::Meshlet& meshlet, const MeshletBuilder::Meshlets& result,
+		const std::vector<dx::XMFLOAT3>& positions, const std::vector<dx::XMFLOAT3>& faceNormals,
+		const std::vector<unsigned int>& meshletFaces)
+	{
+		using namespace DirectX;
+		// sphere around the center of the bounding box, a few percent looser than the minimal one but stable
+		auto lo = XMLoadFloat3(&positions[result.vertices[meshlet.vertexOffset]]);
+		auto hi = lo;
+		for (unsigned int i = 1u; i < meshlet.vertexCount; i++)
+		{
+			const auto p = XMLoadFloat3(&positions[result.vertices[meshlet.vertexOffset + i]]);
+			lo = XMVectorMin(lo, p);
+			hi = XMVectorMax(hi, p);
+		}
+		const auto center = (lo + hi) * 0.5f;
+		float radiusSq = 0.0f;
+		for (unsigned int i = 0u; i < meshlet.vertexCount; i++)
+		{
+			const auto d = XMLoadFloat3(&positions[result.vertices[meshlet.vertexOffset + i]]) - center;
+			radiusSq = std::max(radiusSq, XMVectorGetX(XMVector3Dot(d, d)));
+		}
+		XMStoreFloat3(&meshlet.center, center);
+		meshlet.radius = std::sqrt(radiusSq);
+
+		auto axis = XMVectorZero();
+		for (const auto f : meshletFaces)
+		{
+			axis += XMLoadFloat3(&faceNormals[f]);
+		}
+		axis = XMVector3Normalize(axis);
+		float minDot = 1.0f;
+		for (const auto f : meshletFaces)
+		{
+			const auto n = XMLoadFloat3(&faceNormals[f]);
+			// degenerate triangles have a zero normal and do not constrain the cone
+			if (XMVectorGetX(XMVector3Dot(n, n)) > 0.0f)
+			{
+				minDot = std::min(minDot, XMVectorGetX(XMVector3Dot(axis, n)));
+			}
+		}
+		if (minDot <= minConeDot || XMVectorGetX(XMVector3Dot(axis, axis)) == 0.0f)
+		{
+			meshlet.coneAxis = { 0.0f,0.0f,0.0f };
+			meshlet.coneCutoff = 1.0f;
+		}
+		else
+		{
+			XMStoreFloat3(&meshlet.coneAxis, axis);
+			meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+		}
+	}
+}
+
+MeshletBuilder::Meshlets MeshletBuilder::Build(const aiMesh& mesh, const Options& options)
+{
+	std::vector<unsigned short> indices;
+	indices.reserve(size_t(mesh.mNumFaces) * 3u);
+	for (unsigned int i = 0; i < mesh.mNumFaces; i++)
+	{
+		const auto& face = mesh.mFaces[i];
+		// points and lines left over by aiProcess_Triangulate carry no surface
+		if (face.mNumIndices == 3)
+		{
+			indices.push_back((unsigned short)face.mIndices[0]);
+			indices.push_back((unsigned short)face.mIndices[1]);
+			indices.push_back((unsigned short)face.mIndices[2]);
+		}
+	}
+	return Build(mesh.mVertices, sizeof(aiVector3D), mesh.mNumVertices, indices, options);
+}
+
+MeshletBuilder::Meshlets MeshletBuilder::Build(const void* pFirstPosition, size_t stride, size_t vertexCount,
+	std::span<const unsigned short> indices, const Options& options)
+{
+	using namespace DirectX;
+	assert(indices.size() % 3 == 0);
+	assert("Cluster local vertex indices are 8-bit" && options.maxVertices >= 3u && options.maxVertices <= 256u);
+	assert(options.maxTriangles >= 1u);
+	assert("Too many vertices for 16-bit indices" && vertexCount <= 0x10000u);
+
+	std::vector<XMFLOAT3> positions(vertexCount);
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		positions[i] = *reinterpret_cast<const XMFLOAT3*>(static_cast<const char*>(pFirstPosition) + i * stride);
+	}
+	const size_t triangleCount = indices.size() / 3u;
+	std::vector<XMFLOAT3> faceNormals(triangleCount);
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		const auto p0 = XMLoadFloat3(&positions[indices[t * 3u]]);
+		const auto p1 = XMLoadFloat3(&positions[indices[t * 3u + 1u]]);
+		const auto p2 = XMLoadFloat3(&positions[indices[t * 3u + 2u]]);
+		XMStoreFloat3(&faceNormals[t], XMVector3Normalize(XMVector3Cross(p1 - p0, p2 - p0)));
+	}
+
+	// triangles using each vertex, those of vertex v are triangles[start[v]] .. triangles[start[v + 1] - 1]
+	std::vector<unsigned int> start(vertexCount + 1u, 0u);
+	for (const auto i : indices)
+	{
+		start[i + 1u]++;
+	}
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		start[v + 1u] += start[v];
+	}
+	std::vector<unsigned int> vertexTriangles(indices.size());
+	{
+		auto next = start;
+		for (size_t c = 0; c < indices.size(); c++)
+		{
+			vertexTriangles[next[indices[c]]++] = (unsigned int)(c / 3u);
+		}
+	}
+
+	Meshlets result;
+	result.meshlets.reserve(triangleCount / options.maxTriangles + 1u);
+	result.vertices.reserve(triangleCount);
+	result.triangles.reserve(indices.size());
+
+	std::vector<char> emitted(triangleCount, 0);
+	// cluster local index of every mesh vertex, -1 while the vertex is not in the current cluster
+	std::vector<short> local(vertexCount, -1);
+	std::vector<unsigned int> candidates;
+	std::vector<unsigned int> meshletFaces;
+	size_t cursor = 0u;
+	size_t remaining = triangleCount;
+	Meshlet meshlet;
+
+	const auto newVertices = [&](size_t t)
+	{
+		return (unsigned int)(local[indices[t * 3u]] < 0) + (unsigned int)(local[indices[t * 3u + 1u]] < 0) + (unsigned int)(local[indices[t * 3u + 2u]] < 0);
+	};
+	const auto flush = [&]()
+	{
+		FinishMeshlet(meshlet, result, positions, faceNormals, meshletFaces);
+		for (unsigned int i = 0u; i < meshlet.vertexCount; i++)
+		{
+			local[result.vertices[meshlet.vertexOffset + i]] = -1;
+		}
+		result.meshlets.push_back(meshlet);
+		meshlet = {};
+		meshlet.vertexOffset = (unsigned int)result.vertices.size();
+		meshlet.triangleOffset = (unsigned int)(result.triangles.size() / 3u);
+		candidates.clear();
+		meshletFaces.clear();
+	};
+
+	while (remaining > 0u)
+	{
+		// the adjacent triangle adding the fewest vertices, else the next one in index order
+		size_t best = triangleCount;
+		unsigned int bestCost = 4u;
+		for (const auto t : candidates)
+		{
+			if (!emitted[t])
+			{
+				const auto cost = newVertices(t);
+				if (cost < bestCost)
+				{
+					best = t;
+					bestCost = cost;
+				}
+			}
+		}
+		if (best == triangleCount)
+		{
+			while (emitted[cursor])
+			{
+				cursor++;
+			}
+			best = cursor;
+			bestCost = newVertices(best);
+		}
+		if (meshlet.vertexCount + bestCost > options.maxVertices || meshlet.triangleCount == options.maxTriangles)
+		{
+			flush();
+			continue;
+		}
+
+		for (size_t k = 0; k < 3u; k++)
+		{
+			const auto v = indices[best * 3u + k];
+			if (local[v] < 0)
+			{
+				local[v] = (short)meshlet.vertexCount++;
+				result.vertices.push_back(v);
+				for (auto i = start[v]; i < start[v + 1u]; i++)
+				{
+					if (!emitted[vertexTriangles[i]])
+					{
+						candidates.push_back(vertexTriangles[i]);
+					}
+				}
+			}
+			result.triangles.push_back((unsigned char)local[v]);
+		}
+		emitted[best] = 1;
+		meshletFaces.push_back((unsigned int)best);
+		meshlet.triangleCount++;
+		remaining--;
+		// emitted triangles are dropped from the candidate list once it grows past what the cluster can reach
+		if (candidates.size() > options.maxVertices * 8u)
+		{
+			candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](unsigned int t) { return emitted[t] != 0; }), candidates.end());
+		}
+	}
+	if (meshlet.triangleCount > 0u)
+	{
+		flush();
+	}
+	return result;
+}
+
+MeshletBuilder::Stats MeshletBuilder::GetStats(const Meshlets& meshlets, const Options& options) noexcept
+{
+	Stats stats;
+	stats.meshlets = meshlets.meshlets.size();
+	if (stats.meshlets == 0u)
+	{
+		return stats;
+	}
+	stats.triangles = meshlets.triangles.size() / 3u;
+	size_t cullable = 0u;
+	float radius = 0.0f;
+	for (const auto& m : meshlets.meshlets)
+	{
+		cullable += m.coneCutoff < 1.0f ? 1u : 0u;
+		radius += m.radius;
+	}
+	unsigned short highest = 0u;
+	for (const auto v : meshlets.vertices)
+	{
+		highest = std::max(highest, v);
+	}
+	std::vector<char> seen(size_t(highest) + 1u, 0);
+	size_t distinct = 0u;
+	for (const auto v : meshlets.vertices)
+	{
+		distinct += seen[v] ? 0u : 1u;
+		seen[v] = 1;
+	}
+	const auto count = float(stats.meshlets);
+	stats.averageVertices = float(meshlets.vertices.size()) / count;
+	stats.averageTriangles = float(stats.triangles) / count;
+	stats.triangleFill = float(stats.triangles) / (count * float(options.maxTriangles));
+	stats.vertexDuplication = float(meshlets.vertices.size()) / float(distinct);
+	stats.averageRadius = radius / count;
+	stats.cullableConeFraction = float(cullable) / count;
+	return stats;
+}
+
+MeshletBuilder::Frustum MeshletBuilder::ExtractFrustum(DirectX::FXMMATRIX viewProjection) noexcept
+{
+	using namespace DirectX;
+	// row vectors: clip = v * M, so the clip space components are dot products with the columns of M
+	const XMMATRIX columns = XMMatrixTranspose(viewProjection);
+	const XMVECTOR planes[6] = {
+		columns.r[3] + columns.r[0],
+		columns.r[3] - columns.r[0],
+		columns.r[3] + columns.r[1],
+		columns.r[3] - columns.r[1],
+		columns.r[2],
+		columns.r[3] - columns.r[2],
+	};
+	Frustum frustum;
+	for (size_t i = 0; i < 6u; i++)
+	{
+		XMStoreFloat4(&frustum.planes[i], XMPlaneNormalize(planes[i]));
+	}
+	return frustum;
+}
+
+bool MeshletBuilder::IsOutside(const Meshlet& meshlet, const Frustum& frustum) noexcept
+{
+	for (const auto& plane : frustum.planes)
+	{
+		const float distance = plane.x * meshlet.center.x + plane.y * meshlet.center.y + plane.z * meshlet.center.z + plane.w;
+		if (distance < -meshlet.radius)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool MeshletBuilder::IsBackfacing(const Meshlet& meshlet, const DirectX::XMFLOAT3& cameraPosition) noexcept
+{
+	if (meshlet.coneCutoff >= 1.0f)
+	{
+		return false;
+	}
+	// the view direction to every point of the bounding sphere has to lie outside the cone of front facing directions
+	const float dx = meshlet.center.x - cameraPosition.x;
+	const float dy = meshlet.center.y - cameraPosition.y;
+	const float dz = meshlet.center.z - cameraPosition.z;
+	const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+	return dx * meshlet.coneAxis.x + dy * meshlet.coneAxis.y + dz * meshlet.coneAxis.z >= meshlet.coneCutoff * distance + meshlet.radius;
+}
+
+MeshletBuilder::CullStats MeshletBuilder::Cull(const Meshlets& meshlets, const Frustum& frustum, const DirectX::XMFLOAT3& cameraPosition,
+	std::vector<unsigned int>& visible)
+{
+	PROFILE_ZONE("Culling");
+	CullStats stats;
+	visible.clear();
+	for (size_t i = 0; i < meshlets.meshlets.size(); i++)
+	{
+		const auto& meshlet = meshlets.meshlets[i];
+		stats.tested++;
+		if (IsOutside(meshlet, frustum))
+		{
+			stats.frustumRejected++;
+		}
+		else if (IsBackfacing(meshlet, cameraPosition))
+		{
+			stats.backfaceRejected++;
+		}
+		else
+		{
+			visible.push_back((unsigned int)i);
+		}
+	}
+	stats.visible = visible.size();
+	return stats;
+}
+
+void MeshletBuilder::AppendIndices(const Meshlets& meshlets, size_t meshlet, std::vector<unsigned short>& indices)
+{
+	const auto& m = meshlets.meshlets[meshlet];
+	for (size_t i = 0; i < size_t(m.triangleCount) * 3u; i++)
+	{
+		indices.push_back(meshlets.vertices[m.vertexOffset + meshlets.triangles[m.triangleOffset * 3u + i]]);
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <DirectXMath.h>
+#include <vector>
+#include <span>
+
+struct aiMesh;
+
+// splits a triangle mesh into small clusters (meshlets) with a bounding sphere and a normal cone each,
+// so the cpu can reject clusters that are behind the camera plane or face away instead of whole objects
+// clusters are grown greedily from adjacent triangles, preferring the one that brings the fewest new vertices
+class MeshletBuilder
+{
+public:
+	struct Options
+	{
+		size_t maxVertices = 64u;
+		// 124 keeps the local triangle list of a cluster inside 372 bytes, below the usual 128 primitives limit
+		size_t maxTriangles = 124u;
+	};
+	struct Meshlet
+	{
+		// ranges in Meshlets::vertices and Meshlets::triangles
+		unsigned int vertexOffset = 0u;
+		unsigned int vertexCount = 0u;
+		unsigned int triangleOffset = 0u;
+		unsigned int triangleCount = 0u;
+		DirectX::XMFLOAT3 center = { 0.0f,0.0f,0.0f };
+		float radius = 0.0f;
+		// every triangle normal lies within the cone around axis, cutoff is the sine of its half angle,
+		// a cutoff of 1 marks a cone too wide to ever be rejected
+		DirectX::XMFLOAT3 coneAxis = { 0.0f,0.0f,0.0f };
+		float coneCutoff = 1.0f;
+	};
+	struct Meshlets
+	{
+		std::vector<Meshlet> meshlets;
+		// mesh vertex index of each cluster local vertex
+		std::vector<unsigned short> vertices;
+		// three cluster local vertex indices per triangle
+		std::vector<unsigned char> triangles;
+	};
+	struct Stats
+	{
+		size_t meshlets = 0u;
+		size_t triangles = 0u;
+		float averageVertices = 0.0f;
+		float averageTriangles = 0.0f;
+		// triangles / (meshlets * maxTriangles)
+		float triangleFill = 0.0f;
+		// cluster local vertices over distinct mesh vertices, 1 means no vertex is shared between clusters
+		float vertexDuplication = 0.0f;
+		float averageRadius = 0.0f;
+		// clusters whose cone is narrow enough for backface rejection
+		float cullableConeFraction = 0.0f;
+	};
+	struct CullStats
+	{
+		size_t tested = 0u;
+		size_t frustumRejected = 0u;
+		size_t backfaceRejected = 0u;
+		size_t visible = 0u;
+	};
+	// planes as (a, b, c, d) with a * x + b * y + c * z + d >= 0 inside, normalized
+	struct Frustum
+	{
+		DirectX::XMFLOAT4 planes[6];
+	};
+public:
+	template<class V>
+	static Meshlets Build(const IndexedTriangleList<V>& mesh)
+	{
+		return Build(mesh, Options{});
+	}
+	template<class V>
+	static Meshlets Build(const IndexedTriangleList<V>& mesh, const Options& options)
+	{
+		return Build(&mesh.vertices.front().pos, sizeof(V), mesh.vertices.size(), mesh.indices, options);
+	}
+	static Meshlets Build(const aiMesh& mesh, const Options& options);
+	// pFirstPosition points at the float3 position of the first vertex, stride is the vertex size in bytes
+	static Meshlets Build(const void* pFirstPosition, size_t stride, size_t vertexCount,
+		std::span<const unsigned short> indices, const Options& options);
+	static Stats GetStats(const Meshlets& meshlets, const Options& options) noexcept;
+
+	// frustum of a (model ->) view -> projection transform, clip space x, y in [-w, w] and z in [0, w]
+	static Frustum ExtractFrustum(DirectX::FXMMATRIX viewProjection) noexcept;
+	static bool IsOutside(const Meshlet& meshlet, const Frustum& frustum) noexcept;
+	// true when every triangle of the cluster faces away from a camera at cameraPosition (same space as the mesh)
+	static bool IsBackfacing(const Meshlet& meshlet, const DirectX::XMFLOAT3& cameraPosition) noexcept;
+	// writes the indices of the visible meshlets into visible, returns what was rejected and why
+	static CullStats Cull(const Meshlets& meshlets, const Frustum& frustum, const DirectX::XMFLOAT3& cameraPosition,
+		std::vector<unsigned int>& visible);
+	// expands the triangles of one meshlet back into mesh vertex indices
+	static void AppendIndices(const Meshlets& meshlets, size_t meshlet, std::vector<unsigned short>& indices);
+};
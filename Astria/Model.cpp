@@ -0,0 +1,307 @@
+#include "Model.h"
+#include "BindableBase.h"
+#include "FrameAllocator.h"
+#include "MemoryTracker.h"
+#include "PhongPermutation.h"
+#include "VertexQuantizer.h"
+#include "Surface.h"
+#include "Texture.h"
+#include "Sampler.h"
+#include "Vertex.h"
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <filesystem>
+#include <iterator>
+#include <sstream>
+
+namespace dx = DirectX;
+
+Mesh::Mesh(Graphics& gfx, const aiMesh& mesh, const aiMaterial& material, const std::string& directory)
+{
+	using as3dexp::VertexLayout;
+
+	// the diffuse map is only used when it exists on disk and the mesh can address it
+	std::string texturePath;
+	aiString textureName;
+	if (mesh.HasTextureCoords(0) && material.GetTexture(aiTextureType_DIFFUSE, 0, &textureName) == aiReturn_SUCCESS)
+	{
+		const auto path = std::filesystem::path(directory) / textureName.C_Str();
+		if (std::filesystem::exists(path))
+		{
+			texturePath = path.string();
+		}
+	}
+	const bool textured = !texturePath.empty();
+
+	VertexLayout layout;
+	layout.Append(VertexLayout::Position3D).Append(VertexLayout::Normal);
+	if (textured)
+	{
+		layout.Append(VertexLayout::Texture2D);
+	}
+	as3dexp::VertexBuffer vbuf(std::move(layout));
+	vbuf.Resize(mesh.mNumVertices);
+	static_assert(sizeof(aiVector3D) == sizeof(dx::XMFLOAT3), "aiVector3D must be 3 packed floats");
+	vbuf.WriteStream<VertexLayout::Position3D>(reinterpret_cast<const dx::XMFLOAT3*>(mesh.mVertices), mesh.mNumVertices);
+	vbuf.WriteStream<VertexLayout::Normal>(reinterpret_cast<const dx::XMFLOAT3*>(mesh.mNormals), mesh.mNumVertices);
+	if (textured)
+	{
+		vbuf.GenerateStream<VertexLayout::Texture2D>(mesh.mNumVertices, [&mesh](size_t i)
+		{
+			return dx::XMFLOAT2{ mesh.mTextureCoords[0][i].x,mesh.mTextureCoords[0][i].y };
+		});
+	}
+
+	std::vector<unsigned short> indices;
+	indices.reserve(size_t(mesh.mNumFaces) * 3u);
+	for (unsigned int i = 0; i < mesh.mNumFaces; i++)
+	{
+		const auto& face = mesh.mFaces[i];
+		// points and lines left over by aiProcess_Triangulate carry no surface
+		if (face.mNumIndices == 3)
+		{
+			indices.push_back(face.mIndices[0]);
+			indices.push_back(face.mIndices[1]);
+			indices.push_back(face.mIndices[2]);
+		}
+	}
+
+	const auto packed = VertexQuantizer::Quantize(vbuf);
+	AddBind(std::make_shared<VertexBuffer>(gfx, packed.vertices));
+	AddBind(std::make_shared<VertexConstantBuffer<VertexQuantizer::Dequantization>>(gfx, packed.dequantization, 1u));
+	AddIndexBuffer(std::make_shared<IndexBuffer>(gfx, indices));
+
+	const auto& phong = PhongPermutation::Resolve(gfx, PhongPermutation::FeaturesFromLayout(packed.vertices.GetLayout()));
+	AddBind(phong.pVertexShader);
+	AddBind(phong.pPixelShader);
+	AddBind(Codex::Resolve<InputLayout>(gfx, packed.vertices.GetLayout().GetD3DLayout(FrameAllocator::Get()), phong.pVertexShader->GetBytecode()));
+	AddBind(Codex::Resolve<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+
+	float specularIntensity = 0.6f;
+	float specularPower = 30.0f;
+	material.Get(AI_MATKEY_SHININESS_STRENGTH, specularIntensity);
+	material.Get(AI_MATKEY_SHININESS, specularPower);
+	if (textured)
+	{
+		AddBind(std::make_shared<Texture>(gfx, Surface::FromFile(texturePath)));
+		AddBind(Codex::Resolve<Sampler>(gfx));
+		struct PSMaterialConstant
+		{
+			float specularIntensity;
+			float specularPower;
+			float padding[2];
+		} pmc = { specularIntensity,specularPower };
+		AddBind(std::make_shared<PixelConstantBuffer<PSMaterialConstant>>(gfx, pmc, 1u));
+	}
+	else
+	{
+		aiColor3D diffuse = { 0.8f,0.8f,0.8f };
+		material.Get(AI_MATKEY_COLOR_DIFFUSE, diffuse);
+		struct PSMaterialConstant
+		{
+			dx::XMFLOAT3 color;
+			float specularIntensity;
+			float specularPower;
+			float padding[3];
+		} pmc = { { diffuse.r,diffuse.g,diffuse.b },specularIntensity,specularPower };
+		AddBind(std::make_shared<PixelConstantBuffer<PSMaterialConstant>>(gfx, pmc, 1u));
+	}
+
+	AddBind(std::make_shared<TransformCbuf>(gfx, *this));
+}
+
+void Mesh::Draw(Graphics& gfx, DirectX::FXMMATRIX transform_in)
+{
+	dx::XMStoreFloat4x4(&transform, transform_in);
+	Drawable::Draw(gfx);
+}
+
+DirectX::XMMATRIX Mesh::GetTransformXM() const noexcept
+{
+	return dx::XMLoadFloat4x4(&transform);
+}
+
+
+std::mutex Model::mutex;
+std::unordered_map<std::string, std::shared_ptr<Model::Scene>> Model::scenes;
+
+Model::Model(Graphics& gfx, const std::string& fileName)
+	:
+	pScene(Resolve(gfx, fileName))
+{
+	root = graph.AddNode(SceneGraph::none, dx::XMMatrixIdentity());
+	// scene nodes are stored parent before child, so every parent handle exists when its children are added
+	nodeHandles.reserve(pScene->nodes.size());
+	for (const auto& node : pScene->nodes)
+	{
+		const auto parent = node.parent == noParent ? root : nodeHandles[node.parent];
+		nodeHandles.push_back(graph.AddNode(parent, dx::XMLoadFloat4x4(&node.transform)));
+	}
+}
+
+void Model::SetRootTransform(DirectX::FXMMATRIX transform) noexcept
+{
+	graph.SetLocalTransform(root, transform);
+}
+
+void Model::SetNodeTransform(size_t node, DirectX::FXMMATRIX transform) noexcept(!IS_DEBUG)
+{
+	assert(node < nodeHandles.size());
+	graph.SetLocalTransform(nodeHandles[node], transform);
+}
+
+DirectX::XMMATRIX Model::GetNodeTransform(size_t node) const noexcept(!IS_DEBUG)
+{
+	assert(node < nodeHandles.size());
+	return graph.GetLocalTransform(nodeHandles[node]);
+}
+
+DirectX::XMMATRIX Model::GetWorldTransform(size_t node) const noexcept(!IS_DEBUG)
+{
+	assert(node < nodeHandles.size());
+	return graph.GetWorldTransform(nodeHandles[node]);
+}
+
+size_t Model::GetNodeCount() const noexcept
+{
+	return pScene->nodes.size();
+}
+
+const std::string& Model::GetNodeName(size_t node) const noexcept(!IS_DEBUG)
+{
+	assert(node < pScene->nodes.size());
+	return pScene->nodes[node].name;
+}
+
+std::optional<size_t> Model::FindNode(const std::string& name) const noexcept
+{
+	for (size_t i = 0; i < pScene->nodes.size(); i++)
+	{
+		if (pScene->nodes[i].name == name)
+		{
+			return i;
+		}
+	}
+	return {};
+}
+
+size_t Model::UpdateTransforms()
+{
+	return graph.Update();
+}
+
+void Model::Draw(Graphics& gfx)
+{
+	UpdateTransforms();
+	const auto& nodes = pScene->nodes;
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		const auto world = graph.GetWorldTransform(nodeHandles[i]);
+		for (size_t m = 0; m < nodes[i].meshCount; m++)
+		{
+			pScene->meshes[pScene->nodeMeshes[nodes[i].meshOffset + m]]->Draw(gfx, world);
+		}
+	}
+}
+
+void Model::Prune() noexcept
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto i = scenes.begin(); i != scenes.end();)
+	{
+		i = i->second.use_count() == 1 ? scenes.erase(i) : std::next(i);
+	}
+}
+
+std::shared_ptr<Model::Scene> Model::Resolve(Graphics& gfx, const std::string& fileName)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	const auto i = scenes.find(fileName);
+	if (i != scenes.end())
+	{
+		return i->second;
+	}
+	auto pScene = Import(gfx, fileName);
+	scenes.emplace(fileName, pScene);
+	return pScene;
+}
+
+std::shared_ptr<Model::Scene> Model::Import(Graphics& gfx, const std::string& fileName)
+{
+	MemoryTracker::Scope scope(MemoryTracker::Subsystem::Geometry);
+	Assimp::Importer imp;
+	const auto pModel = imp.ReadFile(fileName,
+		aiProcess_Triangulate |
+		aiProcess_JoinIdenticalVertices |
+		aiProcess_GenSmoothNormals
+	);
+	if (pModel == nullptr || pModel->mRootNode == nullptr)
+	{
+		throw Exception(__LINE__, __FILE__, "Failed to import " + fileName + ": " + imp.GetErrorString());
+	}
+
+	auto pScene = std::make_shared<Scene>();
+	const auto directory = std::filesystem::path(fileName).parent_path().string();
+	pScene->meshes.reserve(pModel->mNumMeshes);
+	for (unsigned int i = 0; i < pModel->mNumMeshes; i++)
+	{
+		const auto& mesh = *pModel->mMeshes[i];
+		if (mesh.mNumVertices > 0x10000u)
+		{
+			throw Exception(__LINE__, __FILE__, fileName + ": mesh " + std::to_string(i) + " has too many vertices for 16-bit indices");
+		}
+		pScene->meshes.push_back(std::make_unique<Mesh>(gfx, mesh, *pModel->mMaterials[mesh.mMaterialIndex], directory));
+	}
+
+	// depth first with an explicit stack, children are pushed reversed to keep the file order
+	std::vector<std::pair<const aiNode*, size_t>> stack = { { pModel->mRootNode,noParent } };
+	while (!stack.empty())
+	{
+		const auto [pNode, parent] = stack.back();
+		stack.pop_back();
+		Node node;
+		node.name = pNode->mName.C_Str();
+		node.parent = parent;
+		// assimp matrices are row major for column vectors, DirectXMath multiplies row vectors
+		dx::XMStoreFloat4x4(&node.transform, dx::XMMatrixTranspose(
+			dx::XMLoadFloat4x4(reinterpret_cast<const dx::XMFLOAT4X4*>(&pNode->mTransformation))
+		));
+		node.meshOffset = pScene->nodeMeshes.size();
+		node.meshCount = pNode->mNumMeshes;
+		pScene->nodeMeshes.insert(pScene->nodeMeshes.end(), pNode->mMeshes, pNode->mMeshes + pNode->mNumMeshes);
+		const auto index = pScene->nodes.size();
+		pScene->nodes.push_back(std::move(node));
+		for (unsigned int c = pNode->mNumChildren; c > 0; c--)
+		{
+			stack.emplace_back(pNode->mChildren[c - 1], index);
+		}
+	}
+	return pScene;
+}
+
+
+Model::Exception::Exception(int line, const char* file, std::string note) noexcept
+	:
+	AstriaException(line, file),
+	note(std::move(note))
+{}
+
+const char* Model::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << AstriaException::what() << std::endl
+		<< "[Note] " << GetNote();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* Model::Exception::GetType() const noexcept
+{
+	return "Astria Model Exception";
+}
+
+const std::string& Model::Exception::GetNote() const noexcept
+{
+	return note;
+}
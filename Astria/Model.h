@@ -0,0 +1,88 @@
+#pragma once
+#include "DrawableBase.h"
+#include "AstriaException.h"
+#include "SceneGraph.h"
+#include <DirectXMath.h>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct aiMesh;
+struct aiMaterial;
+
+// one imported mesh with its material, the transform is handed in per draw so a single Mesh
+// serves every node and every Model instance that places it
+class Mesh : public DrawableBase<Mesh>
+{
+public:
+	Mesh(Graphics& gfx, const aiMesh& mesh, const aiMaterial& material, const std::string& directory);
+	void Draw(Graphics& gfx, DirectX::FXMMATRIX transform);
+	DirectX::XMMATRIX GetTransformXM() const noexcept override;
+	void Update(float dt) noexcept override {}
+private:
+	DirectX::XMFLOAT4X4 transform;
+};
+
+// instance of a model file, the file is imported once into shared meshes and a flattened node hierarchy
+// every instance places its nodes in its own SceneGraph under a root node carrying the instance transform
+class Model
+{
+public:
+	class Exception : public AstriaException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::string note;
+	};
+public:
+	Model(Graphics& gfx, const std::string& fileName);
+	void SetRootTransform(DirectX::FXMMATRIX transform) noexcept;
+	// replaces the imported local transform of a node
+	void SetNodeTransform(size_t node, DirectX::FXMMATRIX transform) noexcept(!IS_DEBUG);
+	DirectX::XMMATRIX GetNodeTransform(size_t node) const noexcept(!IS_DEBUG);
+	// valid after UpdateTransforms / Draw
+	DirectX::XMMATRIX GetWorldTransform(size_t node) const noexcept(!IS_DEBUG);
+	size_t GetNodeCount() const noexcept;
+	const std::string& GetNodeName(size_t node) const noexcept(!IS_DEBUG);
+	std::optional<size_t> FindNode(const std::string& name) const noexcept;
+	// recomputes the world transforms of the dirty subtrees, returns how many nodes were recomputed
+	size_t UpdateTransforms();
+	void Draw(Graphics& gfx);
+	// drops every imported file no Model instance uses anymore
+	static void Prune() noexcept;
+private:
+	static constexpr size_t noParent = ~size_t(0u);
+	struct Node
+	{
+		std::string name;
+		size_t parent;
+		DirectX::XMFLOAT4X4 transform;
+		// range in Scene::nodeMeshes
+		size_t meshOffset;
+		size_t meshCount;
+	};
+	struct Scene
+	{
+		std::vector<std::unique_ptr<Mesh>> meshes;
+		std::vector<Node> nodes;
+		std::vector<size_t> nodeMeshes;
+	};
+private:
+	static std::shared_ptr<Scene> Resolve(Graphics& gfx, const std::string& fileName);
+	static std::shared_ptr<Scene> Import(Graphics& gfx, const std::string& fileName);
+private:
+	std::shared_ptr<Scene> pScene;
+	SceneGraph graph;
+	SceneGraph::Handle root;
+	// graph handle of every scene node
+	std::vector<SceneGraph::Handle> nodeHandles;
+	static std::mutex mutex;
+	static std::unordered_map<std::string, std::shared_ptr<Scene>> scenes;
+};
@@ -1,59 +1,74 @@
 #pragma once
 #include "DrawableBase.h"
-#include "AstriaMath.h"
+#include "ObjectComponents.h"
+#include "EntityWorld.h"
+#include <random>
 
+// orbiting object, the orbit lives in the object until it is attached to an EntityWorld and in the world after that
 template<class T>
 class ObjectBase : public DrawableBase<T>
 {
+public:
+	// moves the orbit into an entity of the world, from then on ObjectSystems::Animate drives the object and
+	// Update does nothing, the world must outlive the object
+	Entity Attach(EntityWorld& world)
+	{
+		assert("Object is already attached to a world" && pWorld == nullptr);
+		WorldTransform placement;
+		DirectX::XMStoreFloat4x4(&placement.transform, orbit.GetTransformXM());
+		entity = world.Create(orbit, placement, Renderable{ this });
+		pWorld = &world;
+		return entity;
+	}
+	~ObjectBase() override
+	{
+		if (pWorld != nullptr && pWorld->IsAlive(entity))
+		{
+			pWorld->Destroy(entity);
+		}
+	}
 protected:
 	ObjectBase(Graphics& gfx, std::mt19937& rng,
 		std::uniform_real_distribution<float>& adist,
 		std::uniform_real_distribution<float>& ddist,
 		std::uniform_real_distribution<float>& odist,
 		std::uniform_real_distribution<float>& rdist)
-		: 
-		r(rdist(rng)),
-		droll(ddist(rng)),
-		dpitch(ddist(rng)),
-		dyaw(ddist(rng)),
-		dphi(odist(rng)),
-		dtheta(odist(rng)),
-		dchi(odist(rng)),
-		chi(adist(rng)),
-		theta(adist(rng)),
-		phi(adist(rng))
-	{}
+	{
+		// drawn in the order the members used to be initialized in, so a seed gives the same scene as before
+		orbit.r = rdist(rng);
+		orbit.theta = adist(rng);
+		orbit.phi = adist(rng);
+		orbit.chi = adist(rng);
+		orbit.droll = ddist(rng);
+		orbit.dpitch = ddist(rng);
+		orbit.dyaw = ddist(rng);
+		orbit.dtheta = odist(rng);
+		orbit.dphi = odist(rng);
+		orbit.dchi = odist(rng);
+	}
 
 	void Update(float dt) noexcept override {
-		roll = wrap_angle(roll + droll * dt);
-		pitch = wrap_angle(pitch + dpitch * dt);
-		yaw = wrap_angle(yaw + dyaw * dt);
-		theta = wrap_angle(theta + dtheta * dt);
-		phi = wrap_angle(phi + dphi * dt);
-		chi = wrap_angle(chi + dchi * dt);
+		if (pWorld == nullptr)
+		{
+			orbit.Advance(dt);
+		}
 	}
 
 	DirectX::XMMATRIX GetTransformXM() const noexcept override {
-		return
-			DirectX::XMMatrixRotationRollPitchYaw(pitch, yaw, roll) *
-			DirectX::XMMatrixTranslation(r, 0.0f, 0.0f) *
-			DirectX::XMMatrixRotationRollPitchYaw(theta, phi, chi);
+		if (pWorld != nullptr)
+		{
+			return DirectX::XMLoadFloat4x4(&pWorld->Get<WorldTransform>(entity).transform);
+		}
+		return orbit.GetTransformXM();
 	}
 
-protected:
-	// positional
-	float r;
-	float roll = 0.0f;
-	float pitch = 0.0f;
-	float yaw = 0.0f;
-	float theta;
-	float phi;
-	float chi;
-	// speed (delta/s)
-	float droll;
-	float dpitch;
-	float dyaw;
-	float dtheta;
-	float dphi;
-	float dchi;
-};
\ No newline at end of file
+	Orbit& GetOrbit() noexcept
+	{
+		return pWorld != nullptr ? pWorld->Get<Orbit>(entity) : orbit;
+	}
+
+private:
+	Orbit orbit;
+	EntityWorld* pWorld = nullptr;
+	Entity entity;
+};
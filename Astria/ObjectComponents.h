@@ -0,0 +1,56 @@
+#pragma once
+#include "AstriaMath.h"
+#include <DirectXMath.h>
+
+class Drawable;
+
+// components the orbiting scene objects are made of in the EntityWorld
+
+// orbit of an object around the origin plus its spin about its own center
+struct Orbit
+{
+	// positional
+	float r;
+	float roll = 0.0f;
+	float pitch = 0.0f;
+	float yaw = 0.0f;
+	float theta;
+	float phi;
+	float chi;
+	// speed (delta/s)
+	float droll;
+	float dpitch;
+	float dyaw;
+	float dtheta;
+	float dphi;
+	float dchi;
+
+	void Advance(float dt) noexcept
+	{
+		roll = wrap_angle(roll + droll * dt);
+		pitch = wrap_angle(pitch + dpitch * dt);
+		yaw = wrap_angle(yaw + dyaw * dt);
+		theta = wrap_angle(theta + dtheta * dt);
+		phi = wrap_angle(phi + dphi * dt);
+		chi = wrap_angle(chi + dchi * dt);
+	}
+	DirectX::XMMATRIX GetTransformXM() const noexcept
+	{
+		return
+			DirectX::XMMatrixRotationRollPitchYaw(pitch, yaw, roll) *
+			DirectX::XMMatrixTranslation(r, 0.0f, 0.0f) *
+			DirectX::XMMatrixRotationRollPitchYaw(theta, phi, chi);
+	}
+};
+
+// result of the orbit, written by ObjectSystems::Animate and read back by the drawable when it binds its transform
+struct WorldTransform
+{
+	DirectX::XMFLOAT4X4 transform;
+};
+
+// drawable holding the bindables of the entity, owned outside the world
+struct Renderable
+{
+	Drawable* pDrawable;
+};
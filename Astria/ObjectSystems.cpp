@@ -0,0 +1,26 @@
+#include "ObjectSystems.h"
+#include "ObjectComponents.h"
+#include "Drawable.h"
+#include "Profiler.h"
+
+namespace dx = DirectX;
+
+void ObjectSystems::Animate(EntityWorld& world, float dt)
+{
+	PROFILE_ZONE("Update");
+	world.ParallelForEach<Orbit, WorldTransform>([dt](Orbit& orbit, WorldTransform& placement)
+	{
+		orbit.Advance(dt);
+		dx::XMStoreFloat4x4(&placement.transform, orbit.GetTransformXM());
+	});
+}
+
+void ObjectSystems::Draw(EntityWorld& world, Graphics& gfx)
+{
+	PROFILE_ZONE("Draw");
+	// the device context is single threaded, so drawing stays on the calling thread
+	world.ForEach<const Renderable>([&gfx](const Renderable& renderable)
+	{
+		renderable.pDrawable->Draw(gfx);
+	});
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include "EntityWorld.h"
+
+class Graphics;
+
+// per frame work on the orbiting objects of an EntityWorld, each a single pass over the matching chunks
+class ObjectSystems
+{
+public:
+	// advances every orbit and writes its world transform, chunks are split across threads
+	static void Animate(EntityWorld& world, float dt);
+	// draws every renderable entity with the transform Animate left in the world
+	static void Draw(EntityWorld& world, Graphics& gfx);
+};
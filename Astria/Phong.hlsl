@@ -0,0 +1,195 @@
+// single source for every phong variant, compiled at runtime per feature set (see PhongPermutation)
+// PHONG_VERTEX_SHADER / PHONG_PIXEL_SHADER pick the stage, the feature defines are 0 or 1
+#ifndef PHONG_VERTEX_COLOR
+#define PHONG_VERTEX_COLOR 0
+#endif
+#ifndef PHONG_TEXTURE
+#define PHONG_TEXTURE 0
+#endif
+#ifndef PHONG_INSTANCED
+#define PHONG_INSTANCED 0
+#endif
+#ifndef PHONG_NORMAL_MAP
+#define PHONG_NORMAL_MAP 0
+#endif
+#ifndef PHONG_INDEXED_COLOR
+#define PHONG_INDEXED_COLOR 0
+#endif
+#ifndef PHONG_QUANTIZED_POSITION
+#define PHONG_QUANTIZED_POSITION 0
+#endif
+#ifndef PHONG_PACKED_NORMAL
+#define PHONG_PACKED_NORMAL 0
+#endif
+
+struct VSOut
+{
+	float3 worldPos : Position;
+	float3 normal : Normal;
+#if PHONG_VERTEX_COLOR
+	float3 color : Color;
+#endif
+#if PHONG_TEXTURE
+	float2 tc : Texcoord;
+#endif
+#if PHONG_NORMAL_MAP
+	float3 tangent : Tangent;
+	float3 bitangent : Bitangent;
+#endif
+	float4 pos : SV_Position;
+};
+
+#ifdef PHONG_VERTEX_SHADER
+
+cbuffer CBuf : register(b0)
+{
+	matrix modelView;
+	matrix modelViewProj;
+};
+
+#if PHONG_QUANTIZED_POSITION
+// matches VertexQuantizer::Dequantization
+cbuffer DequantCBuf : register(b1)
+{
+	float3 posScale;
+	float3 posOffset;
+};
+#endif
+
+struct VSIn
+{
+	float3 pos : Position;
+	float3 n : Normal;
+#if PHONG_VERTEX_COLOR
+	float3 color : Color;
+#endif
+#if PHONG_TEXTURE
+	float2 tc : Texcoord;
+#endif
+#if PHONG_NORMAL_MAP
+	float3 tangent : Tangent;
+	float3 bitangent : Bitangent;
+#endif
+#if PHONG_INSTANCED
+	// per-instance placement relative to the drawable's own transform
+	float4x4 instanceTransform : InstanceTransform;
+#endif
+};
+
+VSOut main(VSIn vsi)
+{
+#if PHONG_QUANTIZED_POSITION
+	const float3 meshPos = vsi.pos * posScale + posOffset;
+#else
+	const float3 meshPos = vsi.pos;
+#endif
+#if PHONG_PACKED_NORMAL
+	const float3 n = vsi.n * 2.0f - 1.0f;
+#else
+	const float3 n = vsi.n;
+#endif
+#if PHONG_INSTANCED
+	const float3 pos = (float3)mul(float4(meshPos, 1.0f), vsi.instanceTransform);
+	const float3x3 toView = mul((float3x3)vsi.instanceTransform, (float3x3)modelView);
+#else
+	const float3 pos = meshPos;
+	const float3x3 toView = (float3x3)modelView;
+#endif
+	VSOut vso;
+	vso.worldPos = (float3)mul(float4(pos, 1.0f), modelView);
+	vso.normal = mul(n, toView);
+#if PHONG_VERTEX_COLOR
+	vso.color = vsi.color;
+#endif
+#if PHONG_TEXTURE
+	vso.tc = vsi.tc;
+#endif
+#if PHONG_NORMAL_MAP
+	vso.tangent = mul(vsi.tangent, toView);
+	vso.bitangent = mul(vsi.bitangent, toView);
+#endif
+	vso.pos = mul(float4(pos, 1.0f), modelViewProj);
+	return vso;
+}
+
+#endif
+
+#ifdef PHONG_PIXEL_SHADER
+
+cbuffer LightCBuf
+{
+	float3 lightPos;
+	float3 ambient;
+	float3 diffuseColor;
+	float diffuseIntensity;
+	float attConst;
+	float attLin;
+	float attQuad;
+};
+
+// layouts match the material structs the drawables already upload
+cbuffer ObjectCBuf
+{
+#if PHONG_INDEXED_COLOR
+	float3 materialColors[6];
+	float padding;
+#elif !PHONG_VERTEX_COLOR && !PHONG_TEXTURE
+	float3 materialColor;
+#endif
+	float specularIntensity;
+	float specularPower;
+};
+
+#if PHONG_TEXTURE
+Texture2D tex : register(t0);
+#endif
+#if PHONG_NORMAL_MAP
+Texture2D nmap : register(t1);
+#endif
+SamplerState splr;
+
+float4 main(VSOut psi, uint tid : SV_PrimitiveID) : SV_Target
+{
+	const float3 worldPos = psi.worldPos;
+#if PHONG_NORMAL_MAP
+	const float3 ns = nmap.Sample(splr, psi.tc).xyz * 2.0f - 1.0f;
+	const float3 n = normalize(ns.x * psi.tangent + ns.y * psi.bitangent + ns.z * psi.normal);
+#else
+	const float3 n = psi.normal;
+#endif
+	// fragment to light vector data
+	const float3 vToL = lightPos - worldPos;
+	const float distToL = length(vToL);
+	const float3 dirToL = vToL / distToL;
+	// diffuse attenuation
+	const float att = 1.0f / (attConst + attLin * distToL + attQuad * (distToL * distToL));
+	// diffuse intensity
+	const float3 diffuse = diffuseColor * diffuseIntensity * att * max(0.0f, dot(dirToL, n));
+
+	// reflected light vector
+	const float3 w = n * dot(vToL, n);
+	const float3 r = w * 2.0f - vToL;
+
+	// calculate specular intensity based on angle between viewing vector and reflection vector, narrow with power function
+	const float3 specular = att * (diffuseColor * diffuseIntensity) * specularIntensity * pow(max(0.0f, dot(normalize(-r), normalize(worldPos))), specularPower);
+
+	// final color
+#if PHONG_TEXTURE
+	float4 color = float4(saturate(diffuse + ambient + specular), 1.0f) * tex.Sample(splr, psi.tc);
+#if PHONG_VERTEX_COLOR
+	color.rgb *= psi.color;
+#endif
+	return color;
+#else
+#if PHONG_INDEXED_COLOR
+	const float3 baseColor = materialColors[(tid / 2) % 6];
+#elif PHONG_VERTEX_COLOR
+	const float3 baseColor = psi.color;
+#else
+	const float3 baseColor = materialColor;
+#endif
+	return float4(saturate((diffuse + ambient + specular) * baseColor), 1.0f);
+#endif
+}
+
+#endif
@@ -0,0 +1,106 @@
+#include "PhongPermutation.h"
+#include "Codex.h"
+#include "FrameAllocator.h"
+#include <cstring>
+
+std::unordered_map<unsigned int, PhongPermutation::Shaders> PhongPermutation::table;
+PhongPermutation::Stats PhongPermutation::stats;
+
+unsigned int PhongPermutation::FeaturesFromLayout(const as3dexp::VertexLayout& layout) noexcept(!IS_DEBUG)
+{
+	return FeaturesFromLayout(layout.GetD3DLayout(FrameAllocator::Get()));
+}
+
+unsigned int PhongPermutation::FeaturesFromLayout(std::span<const D3D11_INPUT_ELEMENT_DESC> layout) noexcept
+{
+	unsigned int features = None;
+	for (const auto& e : layout)
+	{
+		// hlsl semantics are case insensitive
+		// packed formats are told apart by the format, the semantic stays the same
+		if (_stricmp(e.SemanticName, "Position") == 0)
+		{
+			features |= e.Format == DXGI_FORMAT_R16G16B16A16_SNORM ? QuantizedPosition : None;
+		}
+		else if (_stricmp(e.SemanticName, "Normal") == 0)
+		{
+			features |= e.Format == DXGI_FORMAT_R10G10B10A2_UNORM ? PackedNormal : None;
+		}
+		else if (_stricmp(e.SemanticName, "Color") == 0)
+		{
+			features |= VertexColor;
+		}
+		else if (_stricmp(e.SemanticName, "Texcoord") == 0)
+		{
+			features |= Texture;
+		}
+		else if (_stricmp(e.SemanticName, "Tangent") == 0)
+		{
+			features |= NormalMap;
+		}
+		else if (_stricmp(e.SemanticName, "InstanceTransform") == 0)
+		{
+			features |= Instanced;
+		}
+	}
+	return features;
+}
+
+const PhongPermutation::Shaders& PhongPermutation::Resolve(Graphics& gfx, unsigned int features)
+{
+	// normal mapping needs the texture coordinates
+	if (!(features & Texture))
+	{
+		features &= ~NormalMap;
+	}
+	const auto i = table.find(features);
+	if (i != table.end())
+	{
+		return i->second;
+	}
+
+	Shaders shaders;
+	shaders.pVertexShader = Codex::Resolve<VertexShader>(gfx, std::wstring(source), GetDefines(features, ShaderManager::Stage::Vertex));
+	shaders.pPixelShader = Codex::Resolve<PixelShader>(gfx, std::wstring(source), GetDefines(features, ShaderManager::Stage::Pixel));
+
+	// count the distinct stage variants actually compiled
+	bool newVertexShader = true;
+	bool newPixelShader = true;
+	for (const auto& p : table)
+	{
+		newVertexShader = newVertexShader && p.second.pVertexShader != shaders.pVertexShader;
+		newPixelShader = newPixelShader && p.second.pPixelShader != shaders.pPixelShader;
+	}
+	stats.vertexShaders += newVertexShader ? 1u : 0u;
+	stats.pixelShaders += newPixelShader ? 1u : 0u;
+	stats.permutations++;
+
+	return table.emplace(features, std::move(shaders)).first->second;
+}
+
+PhongPermutation::Stats PhongPermutation::GetStats() noexcept
+{
+	return stats;
+}
+
+std::vector<ShaderManager::Define> PhongPermutation::GetDefines(unsigned int features, ShaderManager::Stage stage)
+{
+	features &= stage == ShaderManager::Stage::Vertex ? vertexFeatures : pixelFeatures;
+	std::vector<ShaderManager::Define> defines;
+	defines.push_back({ stage == ShaderManager::Stage::Vertex ? "PHONG_VERTEX_SHADER" : "PHONG_PIXEL_SHADER","1" });
+	const auto add = [&](Feature f, const char* name)
+	{
+		if (features & f)
+		{
+			defines.push_back({ name,"1" });
+		}
+	};
+	add(VertexColor, "PHONG_VERTEX_COLOR");
+	add(Texture, "PHONG_TEXTURE");
+	add(Instanced, "PHONG_INSTANCED");
+	add(NormalMap, "PHONG_NORMAL_MAP");
+	add(IndexedColor, "PHONG_INDEXED_COLOR");
+	add(QuantizedPosition, "PHONG_QUANTIZED_POSITION");
+	add(PackedNormal, "PHONG_PACKED_NORMAL");
+	return defines;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "VertexShader.h"
+#include "PixelShader.h"
+#include "Vertex.h"
+#include <memory>
+#include <span>
+#include <unordered_map>
+
+// compiles Phong.hlsl once per feature set and hands out the shared shader pair
+// features are picked from the vertex layout, the ones a layout cannot express are or'ed in by the caller
+class PhongPermutation
+{
+public:
+	enum Feature : unsigned int
+	{
+		None = 0u,
+		// Color vertex element modulates the lit color
+		VertexColor = 1u << 0u,
+		// Texcoord vertex element samples the texture in slot 0
+		Texture = 1u << 1u,
+		// InstanceTransform matrix per instance in front of the drawable transform
+		Instanced = 1u << 2u,
+		// Tangent/Bitangent vertex elements sample a tangent space normal map in slot 1
+		NormalMap = 1u << 3u,
+		// six material colors picked by primitive id instead of a single material color
+		IndexedColor = 1u << 4u,
+		// snorm16 positions expanded by the per-mesh scale and offset in vertex constant buffer slot 1
+		QuantizedPosition = 1u << 5u,
+		// 10:10:10:2 unorm normals expanded to [-1,1]
+		PackedNormal = 1u << 6u,
+	};
+	struct Shaders
+	{
+		std::shared_ptr<VertexShader> pVertexShader;
+		std::shared_ptr<PixelShader> pPixelShader;
+	};
+	struct Stats
+	{
+		size_t permutations = 0u;
+		size_t vertexShaders = 0u;
+		size_t pixelShaders = 0u;
+	};
+public:
+	static unsigned int FeaturesFromLayout(const as3dexp::VertexLayout& layout) noexcept(!IS_DEBUG);
+	static unsigned int FeaturesFromLayout(std::span<const D3D11_INPUT_ELEMENT_DESC> layout) noexcept;
+	static const Shaders& Resolve(Graphics& gfx, unsigned int features);
+	static Stats GetStats() noexcept;
+	static std::vector<ShaderManager::Define> GetDefines(unsigned int features, ShaderManager::Stage stage);
+private:
+	// features that do not change a stage are masked off so variants share that stage's shader
+	static constexpr unsigned int vertexFeatures = VertexColor | Texture | Instanced | NormalMap | QuantizedPosition | PackedNormal;
+	static constexpr unsigned int pixelFeatures = VertexColor | Texture | NormalMap | IndexedColor;
+	static constexpr const wchar_t* source = L"Phong.hlsl";
+	// permutation table keyed by feature mask
+	static std::unordered_map<unsigned int, Shaders> table;
+	static Stats stats;
+};
@@ -1,5 +1,6 @@
 #include "PixelShader.h"
 #include "GraphicsThrowMacros.h"
+#include "Codex.h"
 #include <d3dcompiler.h>
 
 #pragma comment(lib, "D3DCompiler.lib")
@@ -8,13 +9,55 @@ PixelShader::PixelShader(Graphics& gfx, const std::wstring& path)
 {
 	INFOMAN(gfx);
 
-	Microsoft::WRL::ComPtr<ID3DBlob> pBytecodeBlob;
-
 	GFX_THROW_INFO(D3DReadFileToBlob(path.c_str(), &pBytecodeBlob));
 	GFX_THROW_INFO(GetDevice(gfx)->CreatePixelShader(pBytecodeBlob->GetBufferPointer(), pBytecodeBlob->GetBufferSize(), nullptr, pPixelShader.GetAddressOf()));
+
+	WatchSource(gfx, ShaderManager::SourceFromObject(path), {});
+}
+
+PixelShader::PixelShader(Graphics& gfx, const std::wstring& sourcePath, const std::vector<ShaderManager::Define>& defines)
+{
+	INFOMAN(gfx);
+
+	pBytecodeBlob = gfx.GetShaderManager().Compile(sourcePath, ShaderManager::Stage::Pixel, defines);
+	GFX_THROW_INFO(GetDevice(gfx)->CreatePixelShader(pBytecodeBlob->GetBufferPointer(), pBytecodeBlob->GetBufferSize(), nullptr, pPixelShader.GetAddressOf()));
+
+	WatchSource(gfx, sourcePath, defines);
 }
 
 void PixelShader::Bind(Graphics& gfx) noexcept
 {
 	GetContext(gfx)->PSSetShader(pPixelShader.Get(), nullptr, 0u);
 }
+
+ID3DBlob* PixelShader::GetBytecode() const noexcept
+{
+	return pBytecodeBlob.Get();
+}
+
+std::string PixelShader::GenerateUID(const std::wstring& path)
+{
+	return Codex::Narrow(path);
+}
+
+std::string PixelShader::GenerateUID(const std::wstring& sourcePath, const std::vector<ShaderManager::Define>& defines)
+{
+	return Codex::Narrow(sourcePath) + "|" + ShaderManager::DefinesString(defines);
+}
+
+void PixelShader::WatchSource(Graphics& gfx, std::wstring sourcePath, std::vector<ShaderManager::Define> defines)
+{
+	gpuMemory.Set(pBytecodeBlob->GetBufferSize());
+	pWatch = gfx.GetShaderManager().WatchSource(std::move(sourcePath), ShaderManager::Stage::Pixel, std::move(defines),
+		[this](Graphics& gfx, ID3DBlob* pBlob)
+		{
+			INFOMAN(gfx);
+
+			Microsoft::WRL::ComPtr<ID3D11PixelShader> pNewShader;
+			GFX_THROW_INFO(GetDevice(gfx)->CreatePixelShader(pBlob->GetBufferPointer(), pBlob->GetBufferSize(), nullptr, &pNewShader));
+			pPixelShader = std::move(pNewShader);
+			pBytecodeBlob = pBlob;
+			gpuMemory.Set(pBytecodeBlob->GetBufferSize());
+		}
+	);
+}
@@ -1,12 +1,23 @@
 #pragma once
 #include "Bindable.h"
+#include "MemoryTracker.h"
 
 class PixelShader : public Bindable
 {
 public:
 	PixelShader(Graphics& gfx, const std::wstring& path);
+	// compiles an hlsl source with defines through the shader manager's bytecode cache
+	PixelShader(Graphics& gfx, const std::wstring& sourcePath, const std::vector<ShaderManager::Define>& defines);
 	void Bind(Graphics& gfx) noexcept override;
-
+	ID3DBlob* GetBytecode() const noexcept;
+	static std::string GenerateUID(const std::wstring& path);
+	static std::string GenerateUID(const std::wstring& sourcePath, const std::vector<ShaderManager::Define>& defines);
+private:
+	void WatchSource(Graphics& gfx, std::wstring sourcePath, std::vector<ShaderManager::Define> defines);
 protected:
+	Microsoft::WRL::ComPtr<ID3DBlob> pBytecodeBlob;
+	std::shared_ptr<ShaderManager::Watch> pWatch;
 	Microsoft::WRL::ComPtr<ID3D11PixelShader> pPixelShader;
+	// the driver keeps its own copy of the bytecode, about as large
+	MemoryTracker::GpuAllocation gpuMemory{ MemoryTracker::Subsystem::Shaders };
 };
@@ -43,7 +43,7 @@ public:
 		}
 
 		std::vector<unsigned short> indices;
-		indices.reserve(sq(divisions_x * divisions_y) * 6);
+		indices.reserve(size_t(divisions_x) * size_t(divisions_y) * 6u);
 		{
 			const auto vxy2i = [nVertices_x](size_t x, size_t y)
 			{
@@ -0,0 +1,129 @@
+#include "PoolAllocator.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+
+namespace
+{
+	// every pool alive, for the totals
+	std::mutex& RegistryMutex()
+	{
+		static auto& mutex = *new std::mutex;
+		return mutex;
+	}
+	std::vector<const PoolAllocator*>& Registry()
+	{
+		static auto& pools = *new std::vector<const PoolAllocator*>;
+		return pools;
+	}
+}
+
+PoolAllocator::PoolAllocator(size_t slotSize_in, size_t blockBytes)
+	:
+	// a slot must hold the free list link and keep the next slot aligned like operator new would
+	slotSize((std::max(slotSize_in, sizeof(FreeSlot)) + alignment - 1u) / alignment * alignment),
+	slotsPerBlock(std::max(blockBytes / slotSize, size_t(1u)))
+{
+	stats.pools = 1u;
+	std::lock_guard<std::mutex> lock(RegistryMutex());
+	Registry().push_back(this);
+}
+
+PoolAllocator::~PoolAllocator()
+{
+	assert("Pool destroyed with objects still alive" && stats.live == 0u);
+	std::lock_guard<std::mutex> lock(RegistryMutex());
+	auto& pools = Registry();
+	pools.erase(std::find(pools.begin(), pools.end(), this));
+}
+
+void* PoolAllocator::Allocate()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	void* p;
+	if (pFree != nullptr)
+	{
+		p = pFree;
+		pFree = pFree->pNext;
+	}
+	else
+	{
+		if (blocks.empty() || bumpNext == slotsPerBlock)
+		{
+			blocks.push_back(std::make_unique<std::byte[]>(slotsPerBlock * slotSize));
+			bumpNext = 0u;
+			stats.blocks++;
+			stats.reservedBytes += slotsPerBlock * slotSize;
+		}
+		p = blocks.back().get() + bumpNext++ * slotSize;
+	}
+	stats.allocations++;
+	stats.peak = std::max(++stats.live, stats.peak);
+	return p;
+}
+
+void PoolAllocator::Free(void* p) noexcept
+{
+	if (p == nullptr)
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	assert("Freeing into a pool with nothing allocated" && stats.live > 0u);
+	const auto pSlot = static_cast<FreeSlot*>(p);
+	pSlot->pNext = pFree;
+	pFree = pSlot;
+	stats.frees++;
+	stats.live--;
+}
+
+size_t PoolAllocator::GetSlotSize() const noexcept
+{
+	return slotSize;
+}
+
+PoolAllocator::Stats PoolAllocator::GetStats() const noexcept
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+PoolAllocator::Stats PoolAllocator::GetTotals() noexcept
+{
+	Stats totals;
+	std::lock_guard<std::mutex> lock(RegistryMutex());
+	for (const auto pPool : Registry())
+	{
+		const auto stats = pPool->GetStats();
+		totals.pools++;
+		totals.blocks += stats.blocks;
+		totals.live += stats.live;
+		totals.peak += stats.peak;
+		totals.allocations += stats.allocations;
+		totals.frees += stats.frees;
+		totals.reservedBytes += stats.reservedBytes;
+	}
+	return totals;
+}
+
+PoolAllocator* PoolAllocator::ForSize(size_t size)
+{
+	if (size > maxSizeClass)
+	{
+		return nullptr;
+	}
+	// size classes from the alignment up to maxSizeClass in powers of two, never destroyed like For<T>
+	constexpr size_t classCount = std::bit_width(maxSizeClass / alignment);
+	static std::array<PoolAllocator*, classCount> pools = []()
+	{
+		std::array<PoolAllocator*, classCount> pools;
+		for (size_t i = 0; i < classCount; i++)
+		{
+			pools[i] = new PoolAllocator(alignment << i);
+		}
+		return pools;
+	}();
+	const auto index = (size_t)std::bit_width((std::max(size, alignment) - 1u) / alignment);
+	return pools[index];
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// fixed size slots carved out of large blocks, freed slots are reused before the blocks grow
+// objects of one size end up next to each other instead of scattered across the heap, and an
+// allocation is a pop from the free list or a bump in the last block instead of a trip to the heap
+class PoolAllocator
+{
+public:
+	struct Stats
+	{
+		size_t pools = 0u;
+		size_t blocks = 0u;
+		// slots handed out and not yet freed
+		size_t live = 0u;
+		size_t peak = 0u;
+		size_t allocations = 0u;
+		size_t frees = 0u;
+		size_t reservedBytes = 0u;
+	};
+public:
+	PoolAllocator(size_t slotSize, size_t blockBytes = 64u * 1024u);
+	PoolAllocator(const PoolAllocator&) = delete;
+	PoolAllocator& operator=(const PoolAllocator&) = delete;
+	~PoolAllocator();
+	void* Allocate();
+	void Free(void* p) noexcept;
+	size_t GetSlotSize() const noexcept;
+	Stats GetStats() const noexcept;
+	// sum over every pool alive
+	static Stats GetTotals() noexcept;
+	// pool for objects of type T, it is never destroyed so objects held by other statics can still be freed at exit
+	template<class T>
+	static PoolAllocator& For()
+	{
+		static auto& pool = *new PoolAllocator(sizeof(T));
+		return pool;
+	}
+	// pool for any object up to size bytes (rounded up to a power of two), nullptr when size is too large to pool
+	static PoolAllocator* ForSize(size_t size);
+private:
+	struct FreeSlot
+	{
+		FreeSlot* pNext;
+	};
+private:
+	mutable std::mutex mutex;
+	size_t slotSize;
+	size_t slotsPerBlock;
+	std::vector<std::unique_ptr<std::byte[]>> blocks;
+	// slots of the last block not handed out yet
+	size_t bumpNext = 0u;
+	FreeSlot* pFree = nullptr;
+	Stats stats;
+	static constexpr size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+	static constexpr size_t maxSizeClass = 512u;
+};
@@ -0,0 +1,249 @@
+#include "Profiler.h"
+#include "imgui/imgui.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+namespace
+{
+	// written only by its thread, read by NextFrame once the frame it holds is over
+	struct ThreadBuffer
+	{
+		unsigned int thread;
+		unsigned int depth = 0u;
+		std::vector<Profiler::Event> events[2];
+		size_t frames[2] = { ~size_t(0u),~size_t(0u) };
+	};
+	// buffers outlive their threads so the last events of a finished thread can still be collected
+	std::mutex registryMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+	std::atomic<size_t> frame = 0u;
+	const auto epoch = std::chrono::steady_clock::now();
+	// owned by the thread calling NextFrame
+	std::vector<Profiler::Event> lastFrame;
+	std::vector<Profiler::Event> captured;
+	std::vector<Profiler::GpuEvent> capturedGpu;
+	size_t captureFramesLeft = 0u;
+
+	ThreadBuffer& LocalBuffer()
+	{
+		thread_local ThreadBuffer* pBuffer = []()
+		{
+			std::lock_guard<std::mutex> lock(registryMutex);
+			threadBuffers.push_back(std::make_unique<ThreadBuffer>());
+			threadBuffers.back()->thread = (unsigned int)(threadBuffers.size() - 1u);
+			return threadBuffers.back().get();
+		}();
+		return *pBuffer;
+	}
+}
+
+Profiler::Zone::Zone(const char* name)
+	:
+	name(name),
+	depth(LocalBuffer().depth++)
+{
+	start = Now();
+}
+
+Profiler::Zone::~Zone()
+{
+	const auto end = Now();
+	auto& buffer = LocalBuffer();
+	buffer.depth--;
+	// a buffer still holding the frame before last is reused for the current one
+	const auto now = frame.load(std::memory_order_acquire);
+	const auto slot = now & 1u;
+	if (buffer.frames[slot] != now)
+	{
+		buffer.events[slot].clear();
+		buffer.frames[slot] = now;
+	}
+	buffer.events[slot].push_back({ name,start,end,depth,buffer.thread });
+}
+
+void Profiler::NextFrame()
+{
+	const auto completed = frame.load(std::memory_order_relaxed);
+	const auto slot = completed & 1u;
+	lastFrame.clear();
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		for (const auto& pBuffer : threadBuffers)
+		{
+			if (pBuffer->frames[slot] == completed)
+			{
+				lastFrame.insert(lastFrame.end(), pBuffer->events[slot].begin(), pBuffer->events[slot].end());
+			}
+		}
+	}
+	// zones are recorded as they close, children before their parents
+	std::sort(lastFrame.begin(), lastFrame.end(), [](const Event& a, const Event& b)
+	{
+		return a.thread != b.thread ? a.thread < b.thread : a.start != b.start ? a.start < b.start : a.depth < b.depth;
+	});
+	if (captureFramesLeft > 0u)
+	{
+		captured.insert(captured.end(), lastFrame.begin(), lastFrame.end());
+		captureFramesLeft--;
+	}
+	frame.store(completed + 1u, std::memory_order_release);
+}
+
+const std::vector<Profiler::Event>& Profiler::GetLastFrame() noexcept
+{
+	return lastFrame;
+}
+
+void Profiler::StartCapture(size_t frameCount)
+{
+	captured.clear();
+	capturedGpu.clear();
+	captureFramesLeft = frameCount;
+}
+
+bool Profiler::IsCapturing() noexcept
+{
+	return captureFramesLeft > 0u;
+}
+
+void Profiler::RecordGpu(const GpuEvent& event)
+{
+	if (captureFramesLeft > 0u)
+	{
+		capturedGpu.push_back(event);
+	}
+}
+
+void Profiler::ExportChromeTrace(const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		throw Exception(__LINE__, __FILE__, "Failed to open " + path + " for writing");
+	}
+	// the metadata leads so every event after it can start with a comma
+	file << "{\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"CPU\"}}";
+	if (!capturedGpu.empty())
+	{
+		file << ",\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"GPU\"}}";
+	}
+	// nanosecond timestamps as microseconds to the nanosecond, the default six digits would round the starts
+	// of a long running process to milliseconds and misorder nested zones
+	file << std::fixed << std::setprecision(3);
+	unsigned int threads = 0u;
+	for (const auto& e : captured)
+	{
+		threads = std::max(threads, e.thread + 1u);
+		// complete events, timestamps in microseconds
+		file << ",\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+			<< ",\"ts\":" << e.start / 1000.0 << ",\"dur\":" << (e.end - e.start) / 1000.0 << '}';
+	}
+	for (unsigned int t = 0u; t < threads; t++)
+	{
+		// threads are numbered in the order they first opened a zone
+		file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t << ",\"args\":{\"name\":\"Thread " << t << "\"}}";
+	}
+	// the gpu passes get a process of their own so they are not mistaken for a cpu thread
+	for (const auto& e : capturedGpu)
+	{
+		file << ",\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":2,\"tid\":0"
+			<< ",\"ts\":" << e.start / 1000.0 << ",\"dur\":" << (e.end - e.start) / 1000.0
+			<< ",\"args\":{\"vertices\":" << e.vertices << ",\"primitives\":" << e.primitives
+			<< ",\"pixelInvocations\":" << e.pixelInvocations << "}}";
+	}
+	file << "\n]}\n";
+	if (!file)
+	{
+		throw Exception(__LINE__, __FILE__, "Failed to write " + path);
+	}
+}
+
+void Profiler::SpawnWindow() noexcept
+{
+	if (ImGui::Begin("Profiler"))
+	{
+		if (lastFrame.empty())
+		{
+			ImGui::Text("No zones recorded last frame");
+		}
+		else
+		{
+			int64_t first = lastFrame.front().start;
+			int64_t last = lastFrame.front().end;
+			unsigned int maxDepth = 0u;
+			for (const auto& e : lastFrame)
+			{
+				first = std::min(first, e.start);
+				last = std::max(last, e.end);
+				maxDepth = std::max(maxDepth, e.depth);
+			}
+			ImGui::Text("%.3f ms from first to last zone, %zu zones", (last - first) / 1e6, lastFrame.size());
+
+			const float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+			const float barHeight = ImGui::GetTextLineHeight() + 2.0f;
+			const float rowHeight = barHeight * (maxDepth + 1u) + 4.0f;
+			const float scale = width / float(std::max(last - first, int64_t(1)));
+			const auto origin = ImGui::GetCursorScreenPos();
+			const auto pDrawList = ImGui::GetWindowDrawList();
+			const unsigned int threads = lastFrame.back().thread + 1u;
+			for (const auto& e : lastFrame)
+			{
+				const float x0 = origin.x + (e.start - first) * scale;
+				const float x1 = std::max(origin.x + (e.end - first) * scale, x0 + 1.0f);
+				const float y0 = origin.y + e.thread * rowHeight + e.depth * barHeight;
+				const float y1 = y0 + barHeight - 1.0f;
+				// the same zone keeps its color from frame to frame
+				const auto hash = (unsigned int)(std::hash<const void*>{}(e.name));
+				const auto color = IM_COL32(80 + hash % 120, 80 + (hash >> 8) % 120, 80 + (hash >> 16) % 120, 255);
+				pDrawList->AddRectFilled({ x0,y0 }, { x1,y1 }, color);
+				if (x1 - x0 > ImGui::CalcTextSize(e.name).x + 4.0f)
+				{
+					pDrawList->AddText({ x0 + 2.0f,y0 + 1.0f }, IM_COL32_WHITE, e.name);
+				}
+				if (ImGui::IsMouseHoveringRect({ x0,y0 }, { x1,y1 }))
+				{
+					ImGui::SetTooltip("%s: %.3f ms", e.name, (e.end - e.start) / 1e6);
+				}
+			}
+			ImGui::Dummy({ width,rowHeight * threads });
+		}
+	}
+	ImGui::End();
+}
+
+int64_t Profiler::Now() noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+
+Profiler::Exception::Exception(int line, const char* file, std::string note) noexcept
+	:
+	AstriaException(line, file),
+	note(std::move(note))
+{}
+
+const char* Profiler::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << AstriaException::what() << std::endl
+		<< "[Note] " << GetNote();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* Profiler::Exception::GetType() const noexcept
+{
+	return "Astria Profiler Exception";
+}
+
+const std::string& Profiler::Exception::GetNote() const noexcept
+{
+	return note;
+}
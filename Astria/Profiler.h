@@ -0,0 +1,87 @@
+#pragma once
+#include "AstriaException.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// hierarchical cpu zones per thread, opened and closed with PROFILE_ZONE("name") in the scope to measure
+// every thread records into its own buffers without locking, one per frame parity, NextFrame (called by
+// Graphics::BeginFrame) collects the frame that just ended from all threads
+// zone names must be string literals or otherwise outlive the profiler, zones must close before the frame ends
+// PROFILE_ENABLED decides whether the macros record anything, it follows IS_DEBUG unless the build sets it,
+// e.g. PROFILE_ENABLED=true for a profiling release build
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED IS_DEBUG
+#endif
+
+class Profiler
+{
+public:
+	class Exception : public AstriaException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::string note;
+	};
+	struct Event
+	{
+		const char* name;
+		// nanoseconds since the profiler started
+		int64_t start;
+		int64_t end;
+		unsigned int depth;
+		unsigned int thread;
+	};
+	// a pass timed on the gpu, its times moved onto the profiler clock
+	struct GpuEvent
+	{
+		const char* name;
+		int64_t start;
+		int64_t end;
+		uint64_t vertices;
+		uint64_t primitives;
+		uint64_t pixelInvocations;
+	};
+	class Zone
+	{
+	public:
+		// the first zone of a thread registers its buffers, later ones may grow them
+		Zone(const char* name);
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+		~Zone();
+	private:
+		const char* name;
+		int64_t start;
+		unsigned int depth;
+	};
+public:
+	static void NextFrame();
+	// events of the last completed frame, ordered by thread and start
+	static const std::vector<Event>& GetLastFrame() noexcept;
+	// the events of the next frameCount frames are kept for ExportChromeTrace
+	static void StartCapture(size_t frameCount);
+	static bool IsCapturing() noexcept;
+	// gpu passes are read back frames after they ran and join the capture running at that point
+	// only called from the thread calling NextFrame
+	static void RecordGpu(const GpuEvent& event);
+	// chrome://tracing / perfetto json of the last capture
+	static void ExportChromeTrace(const std::string& path);
+	// timeline of the last frame, one row of nested bars per thread
+	static void SpawnWindow() noexcept;
+	// nanoseconds since the profiler started
+	static int64_t Now() noexcept;
+};
+
+#define PROFILE_CONCAT_(a,b) a##b
+#define PROFILE_CONCAT(a,b) PROFILE_CONCAT_(a,b)
+#if PROFILE_ENABLED
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCAT(profileZone,__LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
@@ -17,4 +17,10 @@ Sampler::Sampler(Graphics& gfx)
 void Sampler::Bind(Graphics& gfx) noexcept
 {
 	GetContext(gfx)->PSSetSamplers(0, 1, pSampler.GetAddressOf());
+}
+
+std::string Sampler::GenerateUID()
+{
+	// only one sampler configuration exists so far
+	return "linear_wrap";
 }
\ No newline at end of file
@@ -6,6 +6,7 @@ class Sampler : public Bindable
 public:
 	Sampler(Graphics& gfx);
 	void Bind(Graphics& gfx) noexcept override;
+	static std::string GenerateUID();
 protected:
 	Microsoft::WRL::ComPtr<ID3D11SamplerState> pSampler;
 };
\ No newline at end of file
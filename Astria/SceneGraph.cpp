@@ -0,0 +1,260 @@
+#include "SceneGraph.h"
+#include "FrameAllocator.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <execution>
+
+namespace dx = DirectX;
+
+SceneGraph::Handle SceneGraph::AddNode(Handle parent, DirectX::FXMMATRIX local)
+{
+	assert("Parent is not a live node" && (parent == none || IsAlive(parent)));
+	const auto handle = (Handle)slots.size();
+	const auto slot = (unsigned int)locals.size();
+	const unsigned int parentSlot = parent == none ? noSlot : slots[parent];
+	const unsigned int depth = parentSlot == noSlot ? 0u : depths[parentSlot] + 1u;
+
+	// appending keeps the levels contiguous as long as nodes arrive in depth order
+	if (!layoutDirty)
+	{
+		if (levelStart.empty())
+		{
+			levelStart = { 0u,1u };
+		}
+		else if (depth + 1u == levelStart.size() - 1u)
+		{
+			levelStart.back()++;
+		}
+		else if (depth + 1u == levelStart.size())
+		{
+			levelStart.push_back(levelStart.back() + 1u);
+		}
+		else
+		{
+			layoutDirty = true;
+		}
+	}
+
+	locals.emplace_back();
+	dx::XMStoreFloat4x4(&locals.back(), local);
+	worlds.emplace_back();
+	parents.push_back(parentSlot);
+	depths.push_back(depth);
+	dirty.push_back(1);
+	handles.push_back(handle);
+	slots.push_back(slot);
+	removed.push_back(0);
+	anyDirty = true;
+	return handle;
+}
+
+void SceneGraph::RemoveNode(Handle node) noexcept(!IS_DEBUG)
+{
+	assert(IsAlive(node));
+	// the subtree goes with it at the next regroup, until then IsAlive checks the ancestors
+	removed[node] = 1;
+	layoutDirty = true;
+}
+
+bool SceneGraph::IsAlive(Handle node) const noexcept
+{
+	if (node >= slots.size() || removed[node] || slots[node] == noSlot)
+	{
+		return false;
+	}
+	for (auto parent = parents[slots[node]]; parent != noSlot; parent = parents[parent])
+	{
+		if (removed[handles[parent]])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void SceneGraph::SetLocalTransform(Handle node, DirectX::FXMMATRIX local) noexcept(!IS_DEBUG)
+{
+	assert(IsAlive(node));
+	const auto slot = slots[node];
+	dx::XMStoreFloat4x4(&locals[slot], local);
+	dirty[slot] = 1;
+	anyDirty = true;
+}
+
+DirectX::XMMATRIX SceneGraph::GetLocalTransform(Handle node) const noexcept(!IS_DEBUG)
+{
+	assert(IsAlive(node));
+	return dx::XMLoadFloat4x4(&locals[slots[node]]);
+}
+
+DirectX::XMMATRIX SceneGraph::GetWorldTransform(Handle node) const noexcept(!IS_DEBUG)
+{
+	assert(IsAlive(node));
+	return dx::XMLoadFloat4x4(&worlds[slots[node]]);
+}
+
+SceneGraph::Handle SceneGraph::GetParent(Handle node) const noexcept(!IS_DEBUG)
+{
+	assert(IsAlive(node));
+	const auto parent = parents[slots[node]];
+	return parent == noSlot ? none : handles[parent];
+}
+
+size_t SceneGraph::GetNodeCount() const noexcept
+{
+	return locals.size();
+}
+
+size_t SceneGraph::Update()
+{
+	PROFILE_ZONE("Transform");
+	if (layoutDirty)
+	{
+		Reorder();
+	}
+	stats.nodes = locals.size();
+	stats.levels = levelStart.empty() ? 0u : levelStart.size() - 1u;
+	if (!anyDirty)
+	{
+		stats.updated = 0u;
+		return 0u;
+	}
+	// a level only reads the flags and worlds of the level above, which are final by the time it runs
+	std::atomic<size_t> updated = 0u;
+	for (size_t level = 0u; level + 1u < levelStart.size(); level++)
+	{
+		ForChunks(levelStart[level], levelStart[level + 1u], [&](size_t begin, size_t end)
+		{
+			size_t count = 0u;
+			for (size_t i = begin; i < end; i++)
+			{
+				const auto parent = parents[i];
+				if (parent != noSlot && dirty[parent])
+				{
+					dirty[i] = 1;
+				}
+				if (dirty[i])
+				{
+					const auto local = dx::XMLoadFloat4x4(&locals[i]);
+					dx::XMStoreFloat4x4(&worlds[i], parent == noSlot ? local : local * dx::XMLoadFloat4x4(&worlds[parent]));
+					count++;
+				}
+			}
+			updated += count;
+		});
+	}
+	std::fill(dirty.begin(), dirty.end(), char(0));
+	anyDirty = false;
+	stats.updated = updated;
+	return stats.updated;
+}
+
+const SceneGraph::Stats& SceneGraph::GetStats() const noexcept
+{
+	return stats;
+}
+
+void SceneGraph::Reorder()
+{
+	// counting sort of the slots by depth, stable so siblings keep their order
+	const size_t count = locals.size();
+	const unsigned int levels = count > 0u ? *std::max_element(depths.begin(), depths.end()) + 1u : 0u;
+	std::vector<size_t> start(size_t(levels) + 1u, 0u);
+	for (const auto d : depths)
+	{
+		start[d + 1u]++;
+	}
+	for (size_t l = 0u; l < levels; l++)
+	{
+		start[l + 1u] += start[l];
+	}
+	std::vector<unsigned int> order(count);
+	{
+		auto next = start;
+		for (unsigned int slot = 0u; slot < count; slot++)
+		{
+			order[next[depths[slot]]++] = slot;
+		}
+	}
+
+	// parents are visited before their children, so removal flows down the subtree
+	std::vector<unsigned int> newSlot(count, noSlot);
+	std::vector<char> dead(count, 0);
+	unsigned int live = 0u;
+	for (const auto slot : order)
+	{
+		const auto parent = parents[slot];
+		dead[slot] = removed[handles[slot]] || (parent != noSlot && dead[parent]);
+		if (!dead[slot])
+		{
+			newSlot[slot] = live++;
+		}
+	}
+
+	std::vector<dx::XMFLOAT4X4> newLocals(live);
+	std::vector<dx::XMFLOAT4X4> newWorlds(live);
+	std::vector<unsigned int> newParents(live);
+	std::vector<unsigned int> newDepths(live);
+	std::vector<char> newDirty(live);
+	std::vector<Handle> newHandles(live);
+	levelStart.assign(1u, 0u);
+	for (const auto slot : order)
+	{
+		const auto handle = handles[slot];
+		if (dead[slot])
+		{
+			removed[handle] = 1;
+			slots[handle] = noSlot;
+			continue;
+		}
+		const auto to = newSlot[slot];
+		newLocals[to] = locals[slot];
+		newWorlds[to] = worlds[slot];
+		newParents[to] = parents[slot] == noSlot ? noSlot : newSlot[parents[slot]];
+		newDepths[to] = depths[slot];
+		newDirty[to] = dirty[slot];
+		newHandles[to] = handle;
+		slots[handle] = to;
+		if (newDepths[to] + 1u == levelStart.size())
+		{
+			levelStart.push_back(to + 1u);
+		}
+		else
+		{
+			levelStart.back() = to + 1u;
+		}
+	}
+	if (live == 0u)
+	{
+		levelStart.clear();
+	}
+	locals = std::move(newLocals);
+	worlds = std::move(newWorlds);
+	parents = std::move(newParents);
+	depths = std::move(newDepths);
+	dirty = std::move(newDirty);
+	handles = std::move(newHandles);
+	layoutDirty = false;
+	stats.reorders++;
+}
+
+template<typename F>
+void SceneGraph::ForChunks(size_t begin, size_t end, F&& f)
+{
+	if (end - begin < parallelThreshold)
+	{
+		f(begin, end);
+		return;
+	}
+	std::pmr::vector<size_t> chunks((end - begin + chunkSize - 1u) / chunkSize, FrameAllocator::Get());
+	for (size_t i = 0u; i < chunks.size(); i++)
+	{
+		chunks[i] = begin + i * chunkSize;
+	}
+	std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](size_t first)
+	{
+		f(first, std::min(first + chunkSize, end));
+	});
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+
+// transform hierarchy stored as contiguous arrays grouped by depth, every level after the one holding its parents
+// local transforms are set through handles, Update recomputes world = local * parent world only below changed
+// nodes, one level after the other with the nodes of a level split across threads
+class SceneGraph
+{
+public:
+	using Handle = unsigned int;
+	static constexpr Handle none = ~0u;
+	struct Stats
+	{
+		size_t nodes = 0u;
+		size_t levels = 0u;
+		// nodes recomputed by the last Update
+		size_t updated = 0u;
+		// times the arrays had to be regrouped by depth after adds out of depth order or removals
+		size_t reorders = 0u;
+	};
+public:
+	// handles are never reused, so a stale handle can be told apart from a live one
+	Handle AddNode(Handle parent, DirectX::FXMMATRIX local);
+	// removes the node together with its whole subtree
+	void RemoveNode(Handle node) noexcept(!IS_DEBUG);
+	bool IsAlive(Handle node) const noexcept;
+	void SetLocalTransform(Handle node, DirectX::FXMMATRIX local) noexcept(!IS_DEBUG);
+	DirectX::XMMATRIX GetLocalTransform(Handle node) const noexcept(!IS_DEBUG);
+	// valid for nodes that existed at the last Update
+	DirectX::XMMATRIX GetWorldTransform(Handle node) const noexcept(!IS_DEBUG);
+	Handle GetParent(Handle node) const noexcept(!IS_DEBUG);
+	// removed subtrees are only dropped from the store at the next Update
+	size_t GetNodeCount() const noexcept;
+	// recomputes the world transforms of the dirty subtrees, returns how many nodes were recomputed
+	size_t Update();
+	const Stats& GetStats() const noexcept;
+private:
+	// regroups the slots by depth (stable) and drops removed subtrees
+	void Reorder();
+	template<typename F>
+	static void ForChunks(size_t begin, size_t end, F&& f);
+private:
+	// per slot, slots are grouped by depth once the layout is clean
+	std::vector<DirectX::XMFLOAT4X4> locals;
+	std::vector<DirectX::XMFLOAT4X4> worlds;
+	std::vector<unsigned int> parents;
+	std::vector<unsigned int> depths;
+	std::vector<char> dirty;
+	std::vector<Handle> handles;
+	// first slot of every depth, plus one past the last slot
+	std::vector<size_t> levelStart;
+	// per handle
+	std::vector<unsigned int> slots;
+	std::vector<char> removed;
+	bool anyDirty = false;
+	bool layoutDirty = false;
+	Stats stats;
+	static constexpr unsigned int noSlot = ~0u;
+	static constexpr size_t parallelThreshold = 1u << 12u;
+	static constexpr size_t chunkSize = 1u << 10u;
+};
@@ -0,0 +1,371 @@
+#include "ShaderManager.h"
+#include "imgui/imgui.h"
+#include "MemoryTracker.h"
+#include <d3dcompiler.h>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#pragma comment(lib, "D3DCompiler.lib")
+
+namespace wrl = Microsoft::WRL;
+namespace fs = std::filesystem;
+
+ShaderManager::Watch::Watch(std::wstring source, Stage stage, std::vector<Define> defines, ReloadFn onReload)
+	:
+	source(std::move(source)),
+	stage(stage),
+	defines(std::move(defines)),
+	onReload(std::move(onReload))
+{}
+
+ShaderManager::ShaderManager()
+	:
+	lastPoll(std::chrono::steady_clock::now())
+{
+	worker = std::thread([this] { WorkerLoop(); });
+}
+
+ShaderManager::~ShaderManager()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	cv.notify_all();
+	worker.join();
+}
+
+wrl::ComPtr<ID3DBlob> ShaderManager::Compile(const std::wstring& source, Stage stage, const std::vector<Define>& defines)
+{
+	MemoryTracker::Scope scope(MemoryTracker::Subsystem::Shaders);
+	auto result = CompileFile(source, stage, defines);
+	Record(result);
+	if (!result.pBlob)
+	{
+		throw Exception(__LINE__, __FILE__, result.error);
+	}
+	return std::move(result.pBlob);
+}
+
+std::shared_ptr<ShaderManager::Watch> ShaderManager::WatchSource(std::wstring source, Stage stage, std::vector<Define> defines, ReloadFn onReload)
+{
+	std::error_code ec;
+	const auto lastWrite = fs::last_write_time(source, ec);
+	if (ec)
+	{
+		return nullptr;
+	}
+	auto pWatch = std::make_shared<Watch>(std::move(source), stage, std::move(defines), std::move(onReload));
+	pWatch->lastWrite = lastWrite;
+	watches.push_back(pWatch);
+	return pWatch;
+}
+
+void ShaderManager::Update(Graphics& gfx) noexcept
+{
+	// hand finished compiles to their owners
+	std::vector<Done> finished;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		finished.swap(done);
+	}
+	for (auto& d : finished)
+	{
+		const auto pWatch = d.pWatch.lock();
+		if (!pWatch)
+		{
+			continue;
+		}
+		pWatch->pending = false;
+		if (!d.result.pBlob)
+		{
+			// keep running the old shader until the source compiles again
+			pWatch->lastError = std::move(d.result.error);
+			continue;
+		}
+		try
+		{
+			pWatch->onReload(gfx, d.result.pBlob.Get());
+			pWatch->lastError.clear();
+			pWatch->reloads++;
+			std::lock_guard<std::mutex> lock(mutex);
+			stats.reloads++;
+		}
+		catch (const std::exception& e)
+		{
+			pWatch->lastError = e.what();
+		}
+		catch (...)
+		{
+			pWatch->lastError = "unknown error while swapping shader";
+		}
+	}
+
+	// poll the sources every so often, file system calls are not free
+	const auto now = std::chrono::steady_clock::now();
+	if (std::chrono::duration<float>(now - lastPoll).count() < pollInterval)
+	{
+		return;
+	}
+	lastPoll = now;
+	for (auto i = watches.begin(); i != watches.end();)
+	{
+		const auto pWatch = i->lock();
+		if (!pWatch)
+		{
+			i = watches.erase(i);
+			continue;
+		}
+		std::error_code ec;
+		const auto lastWrite = fs::last_write_time(pWatch->source, ec);
+		if (!ec && lastWrite != pWatch->lastWrite && !pWatch->pending)
+		{
+			pWatch->lastWrite = lastWrite;
+			Enqueue(pWatch);
+		}
+		i++;
+	}
+}
+
+void ShaderManager::RecompileAll() noexcept
+{
+	for (const auto& w : watches)
+	{
+		if (const auto pWatch = w.lock(); pWatch && !pWatch->pending)
+		{
+			Enqueue(pWatch);
+		}
+	}
+}
+
+ShaderManager::Stats ShaderManager::GetStats() const noexcept
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+void ShaderManager::SpawnControlWindow() noexcept
+{
+	if (ImGui::Begin("Shaders"))
+	{
+		const auto s = GetStats();
+		ImGui::Text("%zu compiled, %zu from cache, %zu failed, %zu swapped", s.compiles, s.cacheHits, s.failures, s.reloads);
+		ImGui::Text("Last compile: %.1f ms", s.lastCompileMs);
+		if (ImGui::Button("Recompile All"))
+		{
+			RecompileAll();
+		}
+		for (const auto& w : watches)
+		{
+			const auto pWatch = w.lock();
+			if (!pWatch)
+			{
+				continue;
+			}
+			auto name = fs::path(pWatch->source).string();
+			if (!pWatch->defines.empty())
+			{
+				name += " [" + DefinesString(pWatch->defines) + "]";
+			}
+			ImGui::Text("%s: %s, %zu reloads", name.c_str(), pWatch->pending ? "compiling" : "idle", pWatch->reloads);
+			if (!pWatch->lastError.empty())
+			{
+				ImGui::TextColored({ 1.0f,0.4f,0.4f,1.0f }, "%s", pWatch->lastError.c_str());
+			}
+		}
+	}
+	ImGui::End();
+}
+
+std::wstring ShaderManager::SourceFromObject(const std::wstring& objectPath)
+{
+	return fs::path(objectPath).replace_extension(L".hlsl").wstring();
+}
+
+const char* ShaderManager::GetTarget(Stage stage) noexcept
+{
+	// matches the shader model the project builds with
+	switch (stage)
+	{
+	case Stage::Vertex:
+		return "vs_4_0";
+	case Stage::Pixel:
+		return "ps_4_0";
+	}
+	return "";
+}
+
+ShaderManager::Result ShaderManager::CompileFile(const std::wstring& source, Stage stage, const std::vector<Define>& defines) noexcept
+{
+	Result result;
+	const auto start = std::chrono::steady_clock::now();
+	try
+	{
+		std::ifstream file(fs::path(source), std::ios::binary);
+		if (!file)
+		{
+			result.error = "cannot open " + fs::path(source).string();
+			return result;
+		}
+		const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+#ifndef NDEBUG
+		const UINT flags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+		const UINT flags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+#endif
+
+		// the key covers everything that changes the output, includes are not followed
+		unsigned long long hash = 14695981039346656037ull;
+		const auto mix = [&hash](const std::string& s)
+		{
+			for (const unsigned char c : s)
+			{
+				hash = (hash ^ c) * 1099511628211ull;
+			}
+			hash = (hash ^ 0xFFu) * 1099511628211ull;
+		};
+		mix(text);
+		mix(GetTarget(stage));
+		mix(DefinesString(defines));
+		mix(std::to_string(flags));
+		std::wostringstream name;
+		name << fs::path(source).stem().wstring() << L'_' << std::hex << hash << L".cso";
+		const auto cachePath = fs::path(cacheDirectory) / name.str();
+
+		if (SUCCEEDED(D3DReadFileToBlob(cachePath.c_str(), &result.pBlob)))
+		{
+			result.fromCache = true;
+		}
+		else
+		{
+			std::vector<D3D_SHADER_MACRO> macros;
+			for (const auto& d : defines)
+			{
+				macros.push_back({ d.name.c_str(),d.value.c_str() });
+			}
+			macros.push_back({ nullptr,nullptr });
+
+			const auto sourceName = fs::path(source).string();
+			wrl::ComPtr<ID3DBlob> pErrors;
+			const HRESULT hr = D3DCompile(
+				text.data(), text.size(), sourceName.c_str(), macros.data(), D3D_COMPILE_STANDARD_FILE_INCLUDE,
+				"main", GetTarget(stage), flags, 0u, &result.pBlob, &pErrors
+			);
+			if (FAILED(hr))
+			{
+				result.pBlob = nullptr;
+				result.error = pErrors
+					? std::string(static_cast<const char*>(pErrors->GetBufferPointer()), pErrors->GetBufferSize())
+					: "failed to compile " + sourceName;
+				return result;
+			}
+			// a cache that cannot be written only costs a recompile next time
+			std::error_code ec;
+			fs::create_directories(cacheDirectory, ec);
+			D3DWriteBlobToFile(result.pBlob.Get(), cachePath.c_str(), TRUE);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		result.pBlob = nullptr;
+		result.error = e.what();
+	}
+	result.ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+std::string ShaderManager::DefinesString(const std::vector<Define>& defines)
+{
+	std::string s;
+	for (const auto& d : defines)
+	{
+		if (!s.empty())
+		{
+			s += ' ';
+		}
+		s += d.name;
+		if (!d.value.empty())
+		{
+			s += '=' + d.value;
+		}
+	}
+	return s;
+}
+
+void ShaderManager::Record(const Result& result) noexcept
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!result.pBlob)
+	{
+		stats.failures++;
+	}
+	else if (result.fromCache)
+	{
+		stats.cacheHits++;
+	}
+	else
+	{
+		stats.compiles++;
+	}
+	stats.lastCompileMs = result.ms;
+}
+
+void ShaderManager::Enqueue(const std::shared_ptr<Watch>& pWatch)
+{
+	pWatch->pending = true;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back({ pWatch,pWatch->source,pWatch->stage,pWatch->defines });
+	}
+	cv.notify_one();
+}
+
+void ShaderManager::WorkerLoop() noexcept
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		cv.wait(lock, [this] { return quit || !jobs.empty(); });
+		if (quit)
+		{
+			return;
+		}
+		auto job = std::move(jobs.front());
+		jobs.pop_front();
+		lock.unlock();
+
+		auto result = CompileFile(job.source, job.stage, job.defines);
+		Record(result);
+
+		lock.lock();
+		done.push_back({ std::move(job.pWatch),std::move(result) });
+	}
+}
+
+// shader manager exception stuff
+ShaderManager::Exception::Exception(int line, const char* file, std::string note) noexcept
+	:
+	AstriaException(line, file),
+	note(std::move(note))
+{}
+
+const char* ShaderManager::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << AstriaException::what() << std::endl
+		<< "[Note] " << GetNote();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* ShaderManager::Exception::GetType() const noexcept
+{
+	return "Astria Shader Exception";
+}
+
+const std::string& ShaderManager::Exception::GetNote() const noexcept
+{
+	return note;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "AstriaWin.h"
+#include "AstriaException.h"
+#include <d3d11.h>
+#include <wrl.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Graphics;
+
+// compiles hlsl at runtime with a persistent bytecode cache and hot-reloads watched shaders
+// sources are polled between frames, compiles run on a worker thread and finished blobs are
+// handed back to their owners in Update so a swap never happens in the middle of a frame
+class ShaderManager
+{
+public:
+	class Exception : public AstriaException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::string note;
+	};
+	enum class Stage
+	{
+		Vertex,
+		Pixel,
+	};
+	struct Define
+	{
+		std::string name;
+		std::string value;
+	};
+	// called on the main thread with the freshly compiled bytecode, may throw to reject it
+	using ReloadFn = std::function<void(Graphics&, ID3DBlob*)>;
+	// keeps a source watched for as long as the owner holds on to it
+	class Watch
+	{
+		friend class ShaderManager;
+	public:
+		Watch(std::wstring source, Stage stage, std::vector<Define> defines, ReloadFn onReload);
+	private:
+		std::wstring source;
+		Stage stage;
+		std::vector<Define> defines;
+		ReloadFn onReload;
+		std::filesystem::file_time_type lastWrite;
+		bool pending = false;
+		size_t reloads = 0u;
+		std::string lastError;
+	};
+	struct Stats
+	{
+		size_t compiles = 0u;
+		size_t cacheHits = 0u;
+		size_t failures = 0u;
+		size_t reloads = 0u;
+		float lastCompileMs = 0.0f;
+	};
+public:
+	ShaderManager();
+	ShaderManager(const ShaderManager&) = delete;
+	ShaderManager& operator=(const ShaderManager&) = delete;
+	~ShaderManager();
+	// blocking compile of source with defines, served from the bytecode cache when the source hash matches
+	Microsoft::WRL::ComPtr<ID3DBlob> Compile(const std::wstring& source, Stage stage, const std::vector<Define>& defines = {});
+	// returns nullptr when the source does not exist (e.g. shipped without hlsl)
+	std::shared_ptr<Watch> WatchSource(std::wstring source, Stage stage, std::vector<Define> defines, ReloadFn onReload);
+	// poll sources and deliver finished compiles, call between frames
+	void Update(Graphics& gfx) noexcept;
+	void RecompileAll() noexcept;
+	Stats GetStats() const noexcept;
+	void SpawnControlWindow() noexcept;
+	// maps a build output like SolidVS.cso to the source it was built from
+	static std::wstring SourceFromObject(const std::wstring& objectPath);
+	static const char* GetTarget(Stage stage) noexcept;
+	static std::string DefinesString(const std::vector<Define>& defines);
+private:
+	struct Result
+	{
+		Microsoft::WRL::ComPtr<ID3DBlob> pBlob;
+		std::string error;
+		bool fromCache = false;
+		float ms = 0.0f;
+	};
+	struct Job
+	{
+		std::weak_ptr<Watch> pWatch;
+		std::wstring source;
+		Stage stage;
+		std::vector<Define> defines;
+	};
+	struct Done
+	{
+		std::weak_ptr<Watch> pWatch;
+		Result result;
+	};
+private:
+	static Result CompileFile(const std::wstring& source, Stage stage, const std::vector<Define>& defines) noexcept;
+	void Record(const Result& result) noexcept;
+	void Enqueue(const std::shared_ptr<Watch>& pWatch);
+	void WorkerLoop() noexcept;
+private:
+	static constexpr const wchar_t* cacheDirectory = L"ShaderCache";
+	static constexpr float pollInterval = 0.25f;
+	std::vector<std::weak_ptr<Watch>> watches;
+	std::chrono::steady_clock::time_point lastPoll;
+	// worker state
+	mutable std::mutex mutex;
+	std::condition_variable cv;
+	std::deque<Job> jobs;
+	std::vector<Done> done;
+	Stats stats;
+	bool quit = false;
+	std::thread worker;
+};
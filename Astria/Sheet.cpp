@@ -1,5 +1,6 @@
 #include "Sheet.h"
 #include "BindableBase.h"
+#include "PhongPermutation.h"
 #include "GraphicsThrowMacros.h"
 #include "Plane.h"
 #include "Surface.h"
@@ -40,13 +41,7 @@ Sheet::Sheet(Graphics& gfx,
 
 		AddStaticBind(std::make_unique<VertexBuffer>(gfx, model.vertices));
 
-		AddStaticBind(std::make_unique<Sampler>(gfx));
-
-		auto pvs = std::make_unique<VertexShader>(gfx, L"TexturedPhongVS.cso");
-		auto pvsbc = pvs->GetBytecode();
-		AddStaticBind(std::move(pvs));
-
-		AddStaticBind(std::make_unique<PixelShader>(gfx, L"TexturedPhongPS.cso"));
+		AddStaticBind(Codex::Resolve<Sampler>(gfx));
 
 		AddStaticIndexBuffer(std::make_unique<IndexBuffer>(gfx, model.indices));
 
@@ -56,9 +51,12 @@ Sheet::Sheet(Graphics& gfx,
 			{ "Normal",0,DXGI_FORMAT_R32G32B32_FLOAT,0,12,D3D11_INPUT_PER_VERTEX_DATA,0 },
 			{ "TexCoord",0,DXGI_FORMAT_R32G32_FLOAT,0,24,D3D11_INPUT_PER_VERTEX_DATA,0 },
 		};
-		AddStaticBind(std::make_unique<InputLayout>(gfx, ied, pvsbc));
+		const auto& phong = PhongPermutation::Resolve(gfx, PhongPermutation::FeaturesFromLayout(ied));
+		AddStaticBind(phong.pVertexShader);
+		AddStaticBind(phong.pPixelShader);
+		AddStaticBind(Codex::Resolve<InputLayout>(gfx, ied, phong.pVertexShader->GetBytecode()));
 
-		AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		AddStaticBind(Codex::Resolve<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
 
 		struct PSMaterialConstant
 		{
@@ -1,5 +1,6 @@
 #include "SkinnedBox.h"
 #include "BindableBase.h"
+#include "PhongPermutation.h"
 #include "GraphicsThrowMacros.h"
 #include "Cube.h"
 #include "Surface.h"
@@ -32,13 +33,7 @@ SkinnedBox::SkinnedBox(Graphics& gfx,
 
 		AddStaticBind(std::make_unique<Texture>(gfx, Surface::FromFile("Images\\red_abstract.jpg")));
 
-		AddStaticBind(std::make_unique<Sampler>(gfx));
-
-		auto pvs = std::make_unique<VertexShader>(gfx, L"TexturedPhongVS.cso");
-		auto pvsbc = pvs->GetBytecode();
-		AddStaticBind(std::move(pvs));
-
-		AddStaticBind(std::make_unique<PixelShader>(gfx, L"TexturedPhongPS.cso"));
+		AddStaticBind(Codex::Resolve<Sampler>(gfx));
 
 		AddStaticIndexBuffer(std::make_unique<IndexBuffer>(gfx, model.indices));
 
@@ -48,9 +43,12 @@ SkinnedBox::SkinnedBox(Graphics& gfx,
 			{ "Normal",0,DXGI_FORMAT_R32G32B32_FLOAT,0,12,D3D11_INPUT_PER_VERTEX_DATA,0 },
 			{ "TexCoord",0,DXGI_FORMAT_R32G32_FLOAT,0,24,D3D11_INPUT_PER_VERTEX_DATA,0 },
 		};
-		AddStaticBind(std::make_unique<InputLayout>(gfx, ied, pvsbc));
+		const auto& phong = PhongPermutation::Resolve(gfx, PhongPermutation::FeaturesFromLayout(ied));
+		AddStaticBind(phong.pVertexShader);
+		AddStaticBind(phong.pPixelShader);
+		AddStaticBind(Codex::Resolve<InputLayout>(gfx, ied, phong.pVertexShader->GetBytecode()));
 
-		AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		AddStaticBind(Codex::Resolve<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
 
 		struct PSMaterialConstant
 		{
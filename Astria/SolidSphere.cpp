@@ -20,11 +20,11 @@ SolidSphere::SolidSphere(Graphics& gfx, float radius)
 		AddBind(std::make_unique<VertexBuffer>(gfx, model.vertices));
 		AddIndexBuffer(std::make_unique<IndexBuffer>(gfx, model.indices));
 
-		auto pvs = std::make_unique<VertexShader>(gfx, L"SolidVS.cso");
+		auto pvs = Codex::Resolve<VertexShader>(gfx, L"SolidVS.cso");
 		auto pvsbc = pvs->GetBytecode();
 		AddStaticBind(std::move(pvs));
 
-		AddStaticBind(std::make_unique<PixelShader>(gfx, L"SolidPS.cso"));
+		AddStaticBind(Codex::Resolve<PixelShader>(gfx, L"SolidPS.cso"));
 
 		struct PSColorConstant
 		{
@@ -37,9 +37,9 @@ SolidSphere::SolidSphere(Graphics& gfx, float radius)
 		{
 			{ "Position",0,DXGI_FORMAT_R32G32B32_FLOAT,0,0,D3D11_INPUT_PER_VERTEX_DATA,0 },
 		};
-		AddStaticBind(std::make_unique<InputLayout>(gfx, ied, pvsbc));
+		AddStaticBind(Codex::Resolve<InputLayout>(gfx, ied, pvsbc));
 
-		AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		AddStaticBind(Codex::Resolve<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
 	}
 	else
 	{
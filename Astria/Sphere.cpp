@@ -1,6 +1,8 @@
 #include "Sphere.h"
 #include "SphereVertices.h"
 #include "BindableBase.h"
+#include "PhongPermutation.h"
+#include "GeometryCache.h"
 #include "GraphicsThrowMacros.h"
 
 Sphere::Sphere(Graphics& gfx, std::mt19937& rng, std::uniform_real_distribution<float>& adist, std::uniform_real_distribution<float>& ddist, 
@@ -12,21 +14,18 @@ Sphere::Sphere(Graphics& gfx, std::mt19937& rng, std::uniform_real_distribution<
 	namespace dx = DirectX;
 	if (!IsStaticInitialized()) {
 
-		auto pvs = std::make_unique<VertexShader>(gfx, L"PhongVS.cso");
-		auto pvsbc = pvs->GetBytecode();
-		AddStaticBind(std::move(pvs));
-
-		AddStaticBind(std::make_unique<PixelShader>(gfx, L"IndexedPhongPS.cso"));
-
 		const std::vector<D3D11_INPUT_ELEMENT_DESC> ied =
 		{
 			{ "Position",0,DXGI_FORMAT_R32G32B32_FLOAT,0,0,D3D11_INPUT_PER_VERTEX_DATA,0 }, 
 			{ "Normal",0,DXGI_FORMAT_R32G32B32_FLOAT,0,12,D3D11_INPUT_PER_VERTEX_DATA,0 }
 		};
 
-		AddStaticBind(std::make_unique<InputLayout>(gfx, ied, pvsbc));
+		const auto& phong = PhongPermutation::Resolve(gfx, PhongPermutation::FeaturesFromLayout(ied) | PhongPermutation::IndexedColor);
+		AddStaticBind(phong.pVertexShader);
+		AddStaticBind(phong.pPixelShader);
+		AddStaticBind(Codex::Resolve<InputLayout>(gfx, ied, phong.pVertexShader->GetBytecode()));
 
-		AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		AddStaticBind(Codex::Resolve<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
 	}
 	
 	struct Vertex {
@@ -34,13 +33,13 @@ Sphere::Sphere(Graphics& gfx, std::mt19937& rng, std::uniform_real_distribution<
 		dx::XMFLOAT3 n;
 	};
 
-	auto model = SphereVertices::MakeTesselatedIndependentCapNormals<Vertex>(latDist(rng), longDist(rng));
+	const auto mesh = GeometryCache::Resolve<Vertex>(gfx, "Sphere.IndependentCapNormals", SphereVertices::MakeTesselatedIndependentCapNormals<Vertex>, latDist(rng), longDist(rng));
 
 	//model.Transform(dx::XMMatrixScaling(1.0f, 1.2f, 1.5f));
 
-	AddBind(std::make_unique<VertexBuffer>(gfx, model.vertices));
+	AddBind(mesh.pVertexBuffer);
 
-	AddIndexBuffer(std::make_unique<IndexBuffer>(gfx, model.indices));
+	AddIndexBuffer(mesh.pIndexBuffer);
 
 	struct PSMaterialConstant {
 
@@ -3,326 +3,174 @@
 #include "AstriaMath.h"
 #include "IndexedTriangleList.h"
 #include <DirectXMath.h>
+#include <cmath>
+#include <span>
 
+// rings are computed in closed form, ring k sits at latitude k * PI / latDiv and every ring is walked by
+// incremental rotation, so a vertex costs a few multiplies instead of building and applying rotation matrices
+// the Fill* variants write into caller provided storage sized with TesselatedVertexCount/TesselatedIndexCount
 class SphereVertices
 {
 public:
-	template<class V>
-	static IndexedTriangleList<V> MakeTesselated(int longDiv, int latDiv)
+	static size_t TesselatedVertexCount(int longDiv, int latDiv) noexcept
 	{
-		namespace dx = DirectX;
-		assert(longDiv >= 2 && longDiv >= 1);
-
-		const auto l_tip = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
-		const auto u_tip = dx::XMVectorSet(1.0f, 0.0f, 1.0f, 0.0f);
-
-		const float longitudeAngle = 2.0f * PI / longDiv;
-		const float latitudeAngle = PI / latDiv;
-
-		auto base = dx::XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f);
-
-		std::vector<V> vertices;
-
-		for (int iLat = 1; iLat < latDiv; iLat ++) {
-
-			base = dx::XMVector3Transform(base, dx::XMMatrixRotationY(latitudeAngle));
-
-			for (int iLong = 0; iLong < longDiv; iLong++)
-			{
-				vertices.emplace_back();
-				auto v = dx::XMVector3Transform(
-					base,
-					dx::XMMatrixRotationZ(longitudeAngle * iLong)
-				);
-				dx::XMStoreFloat3(&vertices.back().pos, v);
-			}
-		}
-
-		// the l tip
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f, 0.0f, -1.0f};
-		const auto ilCenter = (unsigned short)(vertices.size() - 1);
-
-		// the u tip
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f, 1.0f };
-		const auto iuCenter = (unsigned short)(vertices.size() - 1);
-
-
-		// l tip indices
-		std::vector<unsigned short> indices;
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
-		{
-			indices.push_back(ilCenter);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iLong);
-		}
-
-
-		unsigned short end = longDiv * (latDiv - 2);
-		unsigned short n = 0;
-
-		// Sphere indices
-		for (unsigned short iLong = 0; iLong < end; iLong++)
-		{
-			if (iLong != 0 && iLong % longDiv == 0) {
-				n += 1;
-			}
-
-			unsigned short factor = n * longDiv;
-
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(iLong + longDiv);
-
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(((iLong + 1) % longDiv) + longDiv + factor);
-			indices.push_back(iLong + longDiv);
-		}
-
-		// u tip indices
-		for (unsigned short iLong = end; iLong < longDiv + end; iLong++)
-		{
-			indices.push_back(iuCenter);
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + end);
-		}
-
-		return { std::move(vertices),std::move(indices) };
+		return size_t(longDiv) * size_t(latDiv - 1) + 2u;
+	}
+	static size_t TesselatedIndexCount(int longDiv, int latDiv) noexcept
+	{
+		return size_t(longDiv) * 6u * size_t(latDiv - 1);
+	}
 
+	template<class V>
+	static void FillTesselated(int longDiv, int latDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		Fill<V, false, false>(longDiv, latDiv, vertices, indices);
+	}
+	template<class V>
+	static void FillTesselatedIndependentCapNormals(int longDiv, int latDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		Fill<V, true, false>(longDiv, latDiv, vertices, indices);
+	}
+	// the first and last ring get polar texture coordinates like a cap, the rings between are unwrapped
+	template<class V>
+	static void FillTesselatedIndependentTextureCapNormals(int longDiv, int latDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		Fill<V, true, true>(longDiv, latDiv, vertices, indices);
 	}
 
+	template<class V>
+	static IndexedTriangleList<V> MakeTesselated(int longDiv, int latDiv)
+	{
+		return Make<V, false, false>(longDiv, latDiv);
+	}
 
 	template<class V>
 	static IndexedTriangleList<V> MakeTesselatedIndependentCapNormals(int longDiv, int latDiv)
 	{
-		namespace dx = DirectX;
-		assert(longDiv >= 2 && longDiv >= 1);
-
-		const auto l_tip = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
-		const auto u_tip = dx::XMVectorSet(1.0f, 0.0f, 1.0f, 0.0f);
-
-		const float longitudeAngle = 2.0f * PI / longDiv;
-		const float latitudeAngle = PI / latDiv;
-
-		auto base = dx::XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f);
-
-		std::vector<V> vertices;
+		return Make<V, true, false>(longDiv, latDiv);
+	}
 
-		for (int iLat = 1; iLat < latDiv; iLat++) {
+	template<class V>
+	static IndexedTriangleList<V> MakeTesselatedIndependentTextureCapNormals(int longDiv, int latDiv)
+	{
+		return Make<V, true, true>(longDiv, latDiv);
+	}
 
-			base = dx::XMVector3Transform(base, dx::XMMatrixRotationY(latitudeAngle));
+	template<class V>
+	static IndexedTriangleList<V> Make()
+	{
+		return MakeTesselated<V>(24, 24);
+	}
+private:
+	template<class V, bool normals, bool texcoords>
+	static IndexedTriangleList<V> Make(int longDiv, int latDiv)
+	{
+		std::vector<V> vertices(TesselatedVertexCount(longDiv, latDiv));
+		std::vector<unsigned short> indices(TesselatedIndexCount(longDiv, latDiv));
+		Fill<V, normals, texcoords>(longDiv, latDiv, vertices, indices);
+		return { std::move(vertices),std::move(indices) };
+	}
 
-			for (int iLong = 0; iLong < longDiv; iLong++)
+	template<class V, bool normals, bool texcoords>
+	static void Fill(int longDiv, int latDiv, std::span<V> vertices, std::span<unsigned short> indices) noexcept(!IS_DEBUG)
+	{
+		assert(longDiv >= 3 && latDiv >= 3);
+		assert(vertices.size() == TesselatedVertexCount(longDiv, latDiv));
+		assert(indices.size() == TesselatedIndexCount(longDiv, latDiv));
+		assert("Too many vertices for 16-bit indices" && vertices.size() <= 0x10000u);
+
+		const double longitudeAngle = 2.0 * PI_D / longDiv;
+		const double latitudeAngle = PI_D / latDiv;
+		const double cosStep = std::cos(longitudeAngle);
+		const double sinStep = std::sin(longitudeAngle);
+
+		size_t i = 0u;
+		for (int iLat = 1; iLat < latDiv; iLat++)
+		{
+			const float radius = float(std::sin(latitudeAngle * iLat));
+			const float z = -float(std::cos(latitudeAngle * iLat));
+			const bool capRing = iLat == 1 || iLat == latDiv - 1;
+			// double keeps the drift of the incremental rotation far below float precision
+			double c = 1.0;
+			double s = 0.0;
+			for (int iLong = 0; iLong < longDiv; iLong++, i++)
 			{
-				vertices.emplace_back();
-				auto v = dx::XMVector3Transform(
-					base,
-					dx::XMMatrixRotationZ(longitudeAngle * iLong)
-				);
-				dx::XMStoreFloat3(&vertices.back().pos, v);
-				vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,vertices.back().pos.z };
+				auto& v = vertices[i];
+				v.pos = { -radius * float(c),-radius * float(s),z };
+				if constexpr (normals)
+				{
+					v.n = v.pos;
+				}
+				if constexpr (texcoords)
+				{
+					v.tc = capRing
+						? DirectX::XMFLOAT2{ 0.5f + 0.5f * float(c),0.5f + 0.5f * float(s) }
+						: DirectX::XMFLOAT2{ iLong / (longDiv * 1.0f),iLat / (longDiv * 1.0f) };
+				}
+				const double next = c * cosStep - s * sinStep;
+				s = s * cosStep + c * sinStep;
+				c = next;
 			}
 		}
 
 		// the l tip
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f, 0.0f, -1.0f };
-		vertices.back().n = { 0.0f,0.0f, -1.0f };
-		const auto ilCenter = (unsigned short)(vertices.size() - 1);
-
+		vertices[i].pos = { 0.0f,0.0f,-1.0f };
 		// the u tip
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f, 1.0f };
-		vertices.back().n = { 0.0f,0.0f, 1.0f };
-		const auto iuCenter = (unsigned short)(vertices.size() - 1);
-
-
-		// l tip indices
-		std::vector<unsigned short> indices;
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
+		vertices[i + 1u].pos = { 0.0f,0.0f,1.0f };
+		if constexpr (normals)
 		{
-			indices.push_back(ilCenter);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iLong);
+			vertices[i].n = { 0.0f,0.0f,-1.0f };
+			vertices[i + 1u].n = { 0.0f,0.0f,1.0f };
 		}
-
-
-		unsigned short end = longDiv * (latDiv - 2);
-		unsigned short n = 0;
-
-		// Sphere indices
-		for (unsigned short iLong = 0; iLong < end; iLong++)
-		{
-			if (iLong != 0 && iLong % longDiv == 0) {
-				n += 1;
-			}
-
-			unsigned short factor = n * longDiv;
-
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(iLong + longDiv);
-
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(((iLong + 1) % longDiv) + longDiv + factor);
-			indices.push_back(iLong + longDiv);
-		}
-
-		// u tip indices
-		for (unsigned short iLong = end; iLong < longDiv + end; iLong++)
+		if constexpr (texcoords)
 		{
-			indices.push_back(iuCenter);
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + end);
+			vertices[i].tc = { 0.5f,0.5f };
+			vertices[i + 1u].tc = { 0.5f,0.5f };
 		}
 
-		return { std::move(vertices),std::move(indices) };
-
+		FillIndices(longDiv, latDiv - 1, indices);
 	}
 
-	template<class V>
-	static IndexedTriangleList<V> MakeTesselatedIndependentTextureCapNormals(int longDiv, int latDiv)
+	// fans from the two tips (stored after the rings) and a quad strip between each pair of rings
+	static void FillIndices(int longDiv, int rings, std::span<unsigned short> indices) noexcept
 	{
-		namespace dx = DirectX;
-		assert(longDiv >= 2 && longDiv >= 1);
-
-		const auto l_tip = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
-		const auto u_tip = dx::XMVectorSet(1.0f, 0.0f, 1.0f, 0.0f);
-
-		const float longitudeAngle = 2.0f * PI / longDiv;
-		const float latitudeAngle = PI / latDiv;
-
-		auto base = dx::XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f);
-
-		const auto txc_center = dx::XMVectorSet(0.5f, 0.5f, 0.0f, 0.0f);
-		const auto txc_base = dx::XMVectorSet(1, 0.5f, 0.0f, 0.0f);
-
-		std::vector<V> vertices;
-
-		//l_base ring
-		base = dx::XMVector3Transform(base, dx::XMMatrixRotationY(latitudeAngle));
-
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-			
-			vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,vertices.back().pos.z };
-		
-			auto t = dx::XMVectorAdd(
-				dx::XMVector2Transform(dx::XMVectorSubtract(txc_base, txc_center), dx::XMMatrixRotationZ(longitudeAngle * iLong)),
-				txc_center);
-
-			dx::XMStoreFloat2(&vertices.back().tc, t);
-		}
-
-
-		for (int iLat = 2; iLat < latDiv-1; iLat++) {
-
-			base = dx::XMVector3Transform(base, dx::XMMatrixRotationY(latitudeAngle));
-
-			for (int iLong = 0; iLong < longDiv; iLong++)
-			{
-				vertices.emplace_back();
-				auto v = dx::XMVector3Transform(
-					base,
-					dx::XMMatrixRotationZ(longitudeAngle * iLong)
-				);
-				dx::XMStoreFloat3(&vertices.back().pos, v);
-				vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,vertices.back().pos.z };
-				vertices.back().tc = { iLong / (longDiv * 1.0f), iLat / (longDiv * 1.0f) };
-			}
-		}
-
-		//u_base ring
-		base = dx::XMVector3Transform(base, dx::XMMatrixRotationY(latitudeAngle));
-
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-
-			vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,vertices.back().pos.z };
-
-			auto t = dx::XMVectorAdd(
-				dx::XMVector2Transform(dx::XMVectorSubtract(txc_base, txc_center), dx::XMMatrixRotationZ(longitudeAngle * iLong)),
-				txc_center);
-
-			dx::XMStoreFloat2(&vertices.back().tc, t);
-		}
-
-		// the l tip
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f, 0.0f, -1.0f };
-		vertices.back().n = { 0.0f,0.0f, -1.0f };
-		vertices.back().tc = { 0.5f, 0.5f };
-		const auto ilCenter = (unsigned short)(vertices.size() - 1);
-
-		// the u tip
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f, 1.0f };
-		vertices.back().n = { 0.0f,0.0f, 1.0f };
-		vertices.back().tc = { 0.5f, 0.5f };
-		const auto iuCenter = (unsigned short)(vertices.size() - 1);
-
+		const auto ring = size_t(longDiv);
+		const auto ilCenter = (unsigned short)(ring * rings);
+		const auto iuCenter = (unsigned short)(ring * rings + 1u);
+		const size_t end = ring * (rings - 1);
+		size_t i = 0u;
 
 		// l tip indices
-		std::vector<unsigned short> indices;
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
+		for (size_t iLong = 0u; iLong < ring; iLong++)
 		{
-			indices.push_back(ilCenter);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iLong);
+			indices[i++] = ilCenter;
+			indices[i++] = (unsigned short)((iLong + 1u) % ring);
+			indices[i++] = (unsigned short)iLong;
 		}
 
-
-		unsigned short end = longDiv * (latDiv - 2);
-		unsigned short n = 0;
-
-		// Sphere indices
-		for (unsigned short iLong = 0; iLong < end; iLong++)
+		// strips
+		for (size_t iRing = 0u; iRing < end; iRing += ring)
 		{
-			if (iLong != 0 && iLong % longDiv == 0) {
-				n += 1;
+			for (size_t iLong = 0u; iLong < ring; iLong++)
+			{
+				const auto a = (unsigned short)(iRing + iLong);
+				const auto b = (unsigned short)(iRing + (iLong + 1u) % ring);
+				indices[i++] = a;
+				indices[i++] = b;
+				indices[i++] = (unsigned short)(a + ring);
+
+				indices[i++] = b;
+				indices[i++] = (unsigned short)(b + ring);
+				indices[i++] = (unsigned short)(a + ring);
 			}
-
-			unsigned short factor = n * longDiv;
-
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(iLong + longDiv);
-
-			indices.push_back(((iLong + 1) % longDiv) + factor);
-			indices.push_back(((iLong + 1) % longDiv) + longDiv + factor);
-			indices.push_back(iLong + longDiv);
 		}
 
 		// u tip indices
-		for (unsigned short iLong = end; iLong < longDiv + end; iLong++)
+		for (size_t iLong = 0u; iLong < ring; iLong++)
 		{
-			indices.push_back(iuCenter);
-			indices.push_back(iLong);
-			indices.push_back(((iLong + 1) % longDiv) + end);
+			indices[i++] = iuCenter;
+			indices[i++] = (unsigned short)(end + iLong);
+			indices[i++] = (unsigned short)(end + (iLong + 1u) % ring);
 		}
-
-		return { std::move(vertices),std::move(indices) };
-
-	}
-
-	template<class V>
-	static IndexedTriangleList<V> Make()
-	{
-		return MakeTesselated<V>(24, 24);
 	}
-};
\ No newline at end of file
+};
@@ -1,15 +1,21 @@
-#define FULL_WINTARD
 #include "Surface.h"
+#include "ImageCodec.h"
+#include "MemoryTracker.h"
 #include <algorithm>
+#include <sstream>
+// gdi+ decodes the formats ImageCodec cannot read, off windows only qoi files load
+#ifdef _WIN32
+#define FULL_WINTARD
+#include "AstriaWin.h"
 namespace Gdiplus
 {
 	using std::min;
 	using std::max;
 }
 #include <gdiplus.h>
-#include <sstream>
 
 #pragma comment( lib,"gdiplus.lib" )
+#endif
 
 Surface::Surface(unsigned int width, unsigned int height) noexcept
 	:
@@ -39,7 +45,22 @@ Surface::~Surface()
 
 void Surface::Clear(Color fillValue) noexcept
 {
-	memset(pBuffer.get(), fillValue.dword, width * height * sizeof(Color));
+	SurfaceSimd::Fill(GetDwordPtr(), size_t(width) * height, fillValue.dword);
+}
+
+void Surface::Fill(Rect rect, Color fillValue) noexcept
+{
+	const auto bounds = GetRect();
+	rect.left = std::max(rect.left, bounds.left);
+	rect.top = std::max(rect.top, bounds.top);
+	rect.right = std::min(rect.right, bounds.right);
+	rect.bottom = std::min(rect.bottom, bounds.bottom);
+	if (rect.left >= rect.right || rect.top >= rect.bottom)
+	{
+		return;
+	}
+	SurfaceSimd::FillRect(GetDwordPtr() + size_t(rect.top) * width + rect.left, width,
+		rect.right - rect.left, rect.bottom - rect.top, fillValue.dword);
 }
 
 void Surface::PutPixel(unsigned int x, unsigned int y, Color c) noexcept(!IS_DEBUG)
@@ -87,10 +108,30 @@ const Surface::Color* Surface::GetBufferPtrConst() const noexcept
 
 Surface Surface::FromFile(const std::string& name)
 {
+	MemoryTracker::Scope scope(MemoryTracker::Subsystem::Textures);
 	unsigned int width = 0;
 	unsigned int height = 0;
 	std::unique_ptr<Color[]> pBuffer;
 
+	// qoi is decoded natively, everything else goes through gdi+
+	if (ImageCodec::FormatFromFilename(name) == ImageCodec::Format::QOI)
+	{
+		std::vector<unsigned char> data;
+		ImageCodec::Image image;
+		if (!ImageCodec::ReadFile(name, data) || !ImageCodec::DecodeQOI(data.data(), data.size(), image))
+		{
+			std::stringstream ss;
+			ss << "Loading image [" << name << "]: failed to load.";
+			throw Exception(__LINE__, __FILE__, ss.str());
+		}
+		width = image.width;
+		height = image.height;
+		pBuffer = std::make_unique<Color[]>(width * height);
+		std::copy(image.pixels.begin(), image.pixels.end(), reinterpret_cast<unsigned int*>(pBuffer.get()));
+		return Surface(width, height, std::move(pBuffer));
+	}
+
+#ifdef _WIN32
 	{
 		// convert filenam to wide string (for Gdiplus)
 		wchar_t wideName[512];
@@ -120,74 +161,154 @@ Surface Surface::FromFile(const std::string& name)
 	}
 
 	return Surface(width, height, std::move(pBuffer));
+#else
+	std::stringstream ss;
+	ss << "Loading image [" << name << "]: only .qoi files can be loaded without gdi+.";
+	throw Exception(__LINE__, __FILE__, ss.str());
+#endif
 }
 
 void Surface::Save(const std::string& filename) const
 {
-	auto GetEncoderClsid = [&filename](const WCHAR* format, CLSID* pClsid) -> void
+	const auto format = ImageCodec::FormatFromFilename(filename);
+	if (format == ImageCodec::Format::Unknown)
 	{
-		UINT  num = 0;          // number of image encoders
-		UINT  size = 0;         // size of the image encoder array in bytes
+		std::stringstream ss;
+		ss << "Saving surface to [" << filename << "]: unsupported file extension (expected .bmp, .png or .qoi).";
+		throw Exception(__LINE__, __FILE__, ss.str());
+	}
 
-		Gdiplus::ImageCodecInfo* pImageCodecInfo = nullptr;
+	const auto data = ImageCodec::Encode(format, GetDwordPtr(), width, height);
+	if (!ImageCodec::WriteFile(filename, data))
+	{
+		std::stringstream ss;
+		ss << "Saving surface to [" << filename << "]: failed to save.";
+		throw Exception(__LINE__, __FILE__, ss.str());
+	}
+}
 
-		Gdiplus::GetImageEncodersSize(&num, &size);
-		if (size == 0)
-		{
-			std::stringstream ss;
-			ss << "Saving surface to [" << filename << "]: failed to get encoder; size == 0.";
-			throw Exception(__LINE__, __FILE__, ss.str());
-		}
+void Surface::Copy(const Surface& src) noexcept(!IS_DEBUG)
+{
+	assert(width == src.width);
+	assert(height == src.height);
+	SurfaceSimd::Copy(GetDwordPtr(), src.GetDwordPtr(), size_t(width) * height);
+}
 
-		pImageCodecInfo = (Gdiplus::ImageCodecInfo*)(malloc(size));
-		if (pImageCodecInfo == nullptr)
-		{
-			std::stringstream ss;
-			ss << "Saving surface to [" << filename << "]: failed to get encoder; failed to allocate memory.";
-			throw Exception(__LINE__, __FILE__, ss.str());
-		}
+void Surface::Blit(const Surface& src, int x, int y) noexcept
+{
+	Blit(src, src.GetRect(), x, y);
+}
 
-		GetImageEncoders(num, size, pImageCodecInfo);
+void Surface::Blit(const Surface& src, Rect srcRect, int x, int y) noexcept
+{
+	if (!ClipBlit(src, srcRect, x, y))
+	{
+		return;
+	}
+	SurfaceSimd::CopyRect(
+		GetDwordPtr() + size_t(y) * width + x, width,
+		src.GetDwordPtr() + size_t(srcRect.top) * src.width + srcRect.left, src.width,
+		srcRect.right - srcRect.left, srcRect.bottom - srcRect.top
+	);
+}
 
-		for (UINT j = 0; j < num; ++j)
-		{
-			if (wcscmp(pImageCodecInfo[j].MimeType, format) == 0)
-			{
-				*pClsid = pImageCodecInfo[j].Clsid;
-				free(pImageCodecInfo);
-				return;
-			}
-		}
+void Surface::BlitBlend(const Surface& src, int x, int y) noexcept(!IS_DEBUG)
+{
+	BlitBlend(src, src.GetRect(), x, y);
+}
 
-		free(pImageCodecInfo);
-		std::stringstream ss;
-		ss << "Saving surface to [" << filename <<
-			"]: failed to get encoder; failed to find matching encoder.";
-		throw Exception(__LINE__, __FILE__, ss.str());
-	};
+void Surface::BlitBlend(const Surface& src, Rect srcRect, int x, int y) noexcept(!IS_DEBUG)
+{
+	assert("Blending a surface onto itself" && &src != this);
+	if (!ClipBlit(src, srcRect, x, y))
+	{
+		return;
+	}
+	SurfaceSimd::BlendRect(
+		GetDwordPtr() + size_t(y) * width + x, width,
+		src.GetDwordPtr() + size_t(srcRect.top) * src.width + srcRect.left, src.width,
+		srcRect.right - srcRect.left, srcRect.bottom - srcRect.top
+	);
+}
 
-	CLSID bmpID;
-	GetEncoderClsid(L"image/bmp", &bmpID);
+Surface Surface::Resampled(unsigned int newWidth, unsigned int newHeight, SurfaceSimd::Filter filter) const
+{
+	Surface dst(newWidth, newHeight);
+	SurfaceSimd::Resample(dst.GetDwordPtr(), newWidth, newHeight, GetDwordPtr(), width, height, filter);
+	return dst;
+}
 
+void Surface::ToRGBA8(unsigned char* pDst) const noexcept
+{
+	SurfaceSimd::SwizzleRB(reinterpret_cast<unsigned int*>(pDst), GetDwordPtr(), size_t(width) * height);
+}
 
-	// convert filenam to wide string (for Gdiplus)
-	wchar_t wideName[512];
-	mbstowcs_s(nullptr, wideName, filename.c_str(), _TRUNCATE);
+void Surface::ToFloatRGBA(float* pDst) const noexcept
+{
+	SurfaceSimd::ToFloat(pDst, GetDwordPtr(), size_t(width) * height);
+}
 
-	Gdiplus::Bitmap bitmap(width, height, width * sizeof(Color), PixelFormat32bppARGB, (BYTE*)pBuffer.get());
-	if (bitmap.Save(wideName, &bmpID, nullptr) != Gdiplus::Status::Ok)
+Surface Surface::FromRGBA8(unsigned int width, unsigned int height, const unsigned char* pSrc)
+{
+	Surface s(width, height);
+	SurfaceSimd::SwizzleRB(s.GetDwordPtr(), reinterpret_cast<const unsigned int*>(pSrc), size_t(width) * height);
+	return s;
+}
+
+Surface Surface::FromFloatRGBA(unsigned int width, unsigned int height, const float* pSrc)
+{
+	Surface s(width, height);
+	SurfaceSimd::FromFloat(s.GetDwordPtr(), pSrc, size_t(width) * height);
+	return s;
+}
+
+Surface::Rect Surface::GetRect() const noexcept
+{
+	return { 0,0,int(width),int(height) };
+}
+
+bool Surface::ClipBlit(const Surface& src, Rect& srcRect, int& x, int& y) const noexcept
+{
+	// clip source rect against the source surface, shifting the destination along with it
+	if (srcRect.left < 0)
 	{
-		std::stringstream ss;
-		ss << "Saving surface to [" << filename << "]: failed to save.";
-		throw Exception(__LINE__, __FILE__, ss.str());
+		x -= srcRect.left;
+		srcRect.left = 0;
+	}
+	if (srcRect.top < 0)
+	{
+		y -= srcRect.top;
+		srcRect.top = 0;
+	}
+	srcRect.right = std::min(srcRect.right, int(src.width));
+	srcRect.bottom = std::min(srcRect.bottom, int(src.height));
+
+	// then against this surface
+	if (x < 0)
+	{
+		srcRect.left -= x;
+		x = 0;
+	}
+	if (y < 0)
+	{
+		srcRect.top -= y;
+		y = 0;
 	}
+	srcRect.right = std::min(srcRect.right, srcRect.left + int(width) - x);
+	srcRect.bottom = std::min(srcRect.bottom, srcRect.top + int(height) - y);
+
+	return srcRect.left < srcRect.right && srcRect.top < srcRect.bottom;
 }
 
-void Surface::Copy(const Surface& src) noexcept(!IS_DEBUG)
+unsigned int* Surface::GetDwordPtr() noexcept
 {
-	assert(width == src.width);
-	assert(height == src.height);
-	memcpy(pBuffer.get(), src.pBuffer.get(), width * height * sizeof(Color));
+	static_assert(sizeof(Color) == sizeof(unsigned int), "Surface::Color must stay a packed dword");
+	return reinterpret_cast<unsigned int*>(pBuffer.get());
+}
+
+const unsigned int* Surface::GetDwordPtr() const noexcept
+{
+	return reinterpret_cast<const unsigned int*>(pBuffer.get());
 }
 
 Surface::Surface(unsigned int width, unsigned int height, std::unique_ptr<Color[]> pBufferParam) noexcept
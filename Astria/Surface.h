@@ -1,6 +1,6 @@
 #pragma once
-#include "AstriaWin.h"
 #include "AstriaException.h"
+#include "SurfaceSimd.h"
 #include <string>
 #include <assert.h>
 #include <memory>
@@ -93,6 +93,15 @@ public:
 	private:
 		std::string note;
 	};
+public:
+	// pixel rectangle, right and bottom are exclusive
+	struct Rect
+	{
+		int left;
+		int top;
+		int right;
+		int bottom;
+	};
 public:
 	Surface(unsigned int width, unsigned int height) noexcept;
 	Surface(Surface&& source) noexcept;
@@ -101,6 +110,7 @@ public:
 	Surface& operator=(const Surface&) = delete;
 	~Surface();
 	void Clear(Color fillValue) noexcept;
+	void Fill(Rect rect, Color fillValue) noexcept;
 	void PutPixel(unsigned int x, unsigned int y, Color c) noexcept(!IS_DEBUG);
 	Color GetPixel(unsigned int x, unsigned int y) const noexcept(!IS_DEBUG);
 	unsigned int GetWidth() const noexcept;
@@ -111,6 +121,22 @@ public:
 	static Surface FromFile(const std::string& name);
 	void Save(const std::string& filename) const;
 	void Copy(const Surface& src) noexcept(!IS_DEBUG);
+	// blits clip against both surfaces, x/y is where the top left of the source rect lands
+	void Blit(const Surface& src, int x, int y) noexcept;
+	void Blit(const Surface& src, Rect srcRect, int x, int y) noexcept;
+	void BlitBlend(const Surface& src, int x, int y) noexcept(!IS_DEBUG);
+	void BlitBlend(const Surface& src, Rect srcRect, int x, int y) noexcept(!IS_DEBUG);
+	Surface Resampled(unsigned int newWidth, unsigned int newHeight, SurfaceSimd::Filter filter) const;
+	// RGBA8 is 4 bytes per pixel, float RGBA is 4 floats per pixel in [0,1]
+	void ToRGBA8(unsigned char* pDst) const noexcept;
+	void ToFloatRGBA(float* pDst) const noexcept;
+	static Surface FromRGBA8(unsigned int width, unsigned int height, const unsigned char* pSrc);
+	static Surface FromFloatRGBA(unsigned int width, unsigned int height, const float* pSrc);
+private:
+	Rect GetRect() const noexcept;
+	bool ClipBlit(const Surface& src, Rect& srcRect, int& x, int& y) const noexcept;
+	unsigned int* GetDwordPtr() noexcept;
+	const unsigned int* GetDwordPtr() const noexcept;
 private:
 	Surface(unsigned int width, unsigned int height, std::unique_ptr<Color[]> pBufferParam) noexcept;
 private:
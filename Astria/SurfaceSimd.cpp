@@ -0,0 +1,683 @@
+#include "SurfaceSimd.h"
+#include "AstriaMath.h"
+#include <algorithm>
+#include <vector>
+#include <cassert>
+#include <cstring>
+#include <cmath>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// msvc emits avx2 intrinsics without /arch, gcc/clang need the function to opt in
+#if defined(_MSC_VER)
+#define SURFACE_SIMD_AVX2
+#else
+#define SURFACE_SIMD_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+	void CpuId(int info[4], int leaf) noexcept
+	{
+#if defined(_MSC_VER)
+		__cpuidex(info, leaf, 0);
+#else
+		__cpuid_count(leaf, 0, info[0], info[1], info[2], info[3]);
+#endif
+	}
+
+	unsigned long long ReadXcr0() noexcept
+	{
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		unsigned int eax, edx;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((unsigned long long)edx << 32u) | eax;
+#endif
+	}
+
+	bool CpuSupportsAvx2() noexcept
+	{
+		int info[4];
+		CpuId(info, 0);
+		if (info[0] < 7)
+		{
+			return false;
+		}
+		CpuId(info, 1);
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+		// the os has to save ymm registers on context switch
+		if (!osxsave || !avx || (ReadXcr0() & 0x6u) != 0x6u)
+		{
+			return false;
+		}
+		CpuId(info, 7);
+		return (info[1] & (1 << 5)) != 0;
+	}
+
+	// exact round(x / 255) for x in [0, 255 * 255]
+	constexpr unsigned int Div255(unsigned int x) noexcept
+	{
+		return (x + 128u + ((x + 128u) >> 8u)) >> 8u;
+	}
+
+	unsigned char UnitToByte(float f) noexcept
+	{
+		// written so that NaN maps to 0 like the min/max sequence of the vector paths
+		f = f > 0.0f ? (f < 1.0f ? f : 1.0f) : 0.0f;
+		return (unsigned char)(int)(f * 255.0f + 0.5f);
+	}
+
+	// ---------------------------------------------------------------- scalar reference
+	void FillScalar(unsigned int* pDst, size_t count, unsigned int value) noexcept
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			pDst[i] = value;
+		}
+	}
+
+	void BlendOverScalar(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			const unsigned int s = pSrc[i];
+			const unsigned int d = pDst[i];
+			const unsigned int a = s >> 24u;
+			const unsigned int ia = 255u - a;
+			const unsigned int b = Div255((s & 0xFFu) * a + (d & 0xFFu) * ia);
+			const unsigned int g = Div255(((s >> 8u) & 0xFFu) * a + ((d >> 8u) & 0xFFu) * ia);
+			const unsigned int r = Div255(((s >> 16u) & 0xFFu) * a + ((d >> 16u) & 0xFFu) * ia);
+			const unsigned int outA = Div255(a * 255u + (d >> 24u) * ia);
+			pDst[i] = (outA << 24u) | (r << 16u) | (g << 8u) | b;
+		}
+	}
+
+	void SwizzleRBScalar(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			const unsigned int x = pSrc[i];
+			pDst[i] = (x & 0xFF00FF00u) | ((x >> 16u) & 0xFFu) | ((x & 0xFFu) << 16u);
+		}
+	}
+
+	void ToFloatScalar(float* pDst, const unsigned int* pSrc, size_t count) noexcept
+	{
+		constexpr float scale = 1.0f / 255.0f;
+		for (size_t i = 0; i < count; i++)
+		{
+			const unsigned int x = pSrc[i];
+			pDst[i * 4 + 0] = float((x >> 16u) & 0xFFu) * scale;
+			pDst[i * 4 + 1] = float((x >> 8u) & 0xFFu) * scale;
+			pDst[i * 4 + 2] = float(x & 0xFFu) * scale;
+			pDst[i * 4 + 3] = float(x >> 24u) * scale;
+		}
+	}
+
+	void FromFloatScalar(unsigned int* pDst, const float* pSrc, size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			const unsigned int r = UnitToByte(pSrc[i * 4 + 0]);
+			const unsigned int g = UnitToByte(pSrc[i * 4 + 1]);
+			const unsigned int b = UnitToByte(pSrc[i * 4 + 2]);
+			const unsigned int a = UnitToByte(pSrc[i * 4 + 3]);
+			pDst[i] = (a << 24u) | (r << 16u) | (g << 8u) | b;
+		}
+	}
+
+	// ---------------------------------------------------------------- sse2
+	void FillSSE2(unsigned int* pDst, size_t count, unsigned int value) noexcept
+	{
+		const __m128i v = _mm_set1_epi32((int)value);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), v);
+		}
+		FillScalar(pDst + i, count - i, value);
+	}
+
+	// blends 2 pixels held as 16-bit lanes
+	__m128i Blend2SSE2(__m128i s, __m128i d) noexcept
+	{
+		const __m128i c255 = _mm_set1_epi16(255);
+		const __m128i c128 = _mm_set1_epi16(128);
+		const __m128i alphaLanes = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+		__m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		const __m128i ia = _mm_sub_epi16(c255, a);
+		// src alpha lane is weighted by 255 so the result alpha is a_s + a_d * (1 - a_s)
+		a = _mm_or_si128(a, alphaLanes);
+		// the sums stay below 2^16 so the wrapping signed adds are exact when read unsigned
+		__m128i x = _mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, ia));
+		x = _mm_add_epi16(x, c128);
+		return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+	}
+
+	void BlendOverSSE2(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept
+	{
+		const __m128i zero = _mm_setzero_si128();
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+			const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pDst + i));
+			const __m128i lo = Blend2SSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+			const __m128i hi = Blend2SSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), _mm_packus_epi16(lo, hi));
+		}
+		BlendOverScalar(pDst + i, pSrc + i, count - i);
+	}
+
+	__m128i SwizzleRBSSE2(__m128i x) noexcept
+	{
+		const __m128i maskGA = _mm_set1_epi32((int)0xFF00FF00u);
+		const __m128i maskLow = _mm_set1_epi32(0xFF);
+		const __m128i r = _mm_and_si128(_mm_srli_epi32(x, 16), maskLow);
+		const __m128i b = _mm_slli_epi32(_mm_and_si128(x, maskLow), 16);
+		return _mm_or_si128(_mm_and_si128(x, maskGA), _mm_or_si128(r, b));
+	}
+
+	void SwizzleRBSSE2(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), SwizzleRBSSE2(x));
+		}
+		SwizzleRBScalar(pDst + i, pSrc + i, count - i);
+	}
+
+	void ToFloatSSE2(float* pDst, const unsigned int* pSrc, size_t count) noexcept
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i rgba = SwizzleRBSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i)));
+			const __m128i lo = _mm_unpacklo_epi8(rgba, zero);
+			const __m128i hi = _mm_unpackhi_epi8(rgba, zero);
+			float* pOut = pDst + i * 4;
+			_mm_storeu_ps(pOut + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+			_mm_storeu_ps(pOut + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+			_mm_storeu_ps(pOut + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+			_mm_storeu_ps(pOut + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+		}
+		ToFloatScalar(pDst + i * 4, pSrc + i, count - i);
+	}
+
+	__m128i UnitToIntSSE2(__m128 v) noexcept
+	{
+		v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+	}
+
+	void FromFloatSSE2(unsigned int* pDst, const float* pSrc, size_t count) noexcept
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const float* pIn = pSrc + i * 4;
+			const __m128i p01 = _mm_packs_epi32(UnitToIntSSE2(_mm_loadu_ps(pIn + 0)), UnitToIntSSE2(_mm_loadu_ps(pIn + 4)));
+			const __m128i p23 = _mm_packs_epi32(UnitToIntSSE2(_mm_loadu_ps(pIn + 8)), UnitToIntSSE2(_mm_loadu_ps(pIn + 12)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), SwizzleRBSSE2(_mm_packus_epi16(p01, p23)));
+		}
+		FromFloatScalar(pDst + i, pSrc + i * 4, count - i);
+	}
+
+	// ---------------------------------------------------------------- avx2
+	SURFACE_SIMD_AVX2 void FillAVX2(unsigned int* pDst, size_t count, unsigned int value) noexcept
+	{
+		const __m256i v = _mm256_set1_epi32((int)value);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), v);
+		}
+		FillScalar(pDst + i, count - i, value);
+	}
+
+	SURFACE_SIMD_AVX2 __m256i Blend4AVX2(__m256i s, __m256i d) noexcept
+	{
+		const __m256i c255 = _mm256_set1_epi16(255);
+		const __m256i c128 = _mm256_set1_epi16(128);
+		const __m256i alphaLanes = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+		__m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		const __m256i ia = _mm256_sub_epi16(c255, a);
+		a = _mm256_or_si256(a, alphaLanes);
+		__m256i x = _mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(d, ia));
+		x = _mm256_add_epi16(x, c128);
+		return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+	}
+
+	SURFACE_SIMD_AVX2 void BlendOverAVX2(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+			const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pDst + i));
+			// unpack and pack both work per 128-bit lane so pixel order is preserved
+			const __m256i lo = Blend4AVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero));
+			const __m256i hi = Blend4AVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), _mm256_packus_epi16(lo, hi));
+		}
+		BlendOverSSE2(pDst + i, pSrc + i, count - i);
+	}
+
+	SURFACE_SIMD_AVX2 __m256i SwizzleRBMaskAVX2() noexcept
+	{
+		return _mm256_setr_epi8(
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15
+		);
+	}
+
+	SURFACE_SIMD_AVX2 void SwizzleRBAVX2(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept
+	{
+		const __m256i mask = SwizzleRBMaskAVX2();
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), _mm256_shuffle_epi8(x, mask));
+		}
+		SwizzleRBSSE2(pDst + i, pSrc + i, count - i);
+	}
+
+	SURFACE_SIMD_AVX2 void ToFloatAVX2(float* pDst, const unsigned int* pSrc, size_t count) noexcept
+	{
+		const __m256i mask = SwizzleRBMaskAVX2();
+		const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i rgba = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i)), mask);
+			const __m128i p0123 = _mm256_castsi256_si128(rgba);
+			const __m128i p4567 = _mm256_extracti128_si256(rgba, 1);
+			float* pOut = pDst + i * 4;
+			_mm256_storeu_ps(pOut + 0, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(p0123)), scale));
+			_mm256_storeu_ps(pOut + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(p0123, 8))), scale));
+			_mm256_storeu_ps(pOut + 16, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(p4567)), scale));
+			_mm256_storeu_ps(pOut + 24, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(p4567, 8))), scale));
+		}
+		ToFloatSSE2(pDst + i * 4, pSrc + i, count - i);
+	}
+
+	SURFACE_SIMD_AVX2 __m256i UnitToIntAVX2(__m256 v) noexcept
+	{
+		v = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+		return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f)));
+	}
+
+	SURFACE_SIMD_AVX2 void FromFloatAVX2(unsigned int* pDst, const float* pSrc, size_t count) noexcept
+	{
+		const __m256i mask = SwizzleRBMaskAVX2();
+		const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const float* pIn = pSrc + i * 4;
+			// each register holds 2 pixels, the per-lane packs leave them as 0 2 4 6 | 1 3 5 7
+			const __m256i p02 = _mm256_packs_epi32(UnitToIntAVX2(_mm256_loadu_ps(pIn + 0)), UnitToIntAVX2(_mm256_loadu_ps(pIn + 8)));
+			const __m256i p46 = _mm256_packs_epi32(UnitToIntAVX2(_mm256_loadu_ps(pIn + 16)), UnitToIntAVX2(_mm256_loadu_ps(pIn + 24)));
+			const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(p02, p46), order);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), _mm256_shuffle_epi8(packed, mask));
+		}
+		FromFloatSSE2(pDst + i, pSrc + i * 4, count - i);
+	}
+
+	// ---------------------------------------------------------------- resampling
+	struct FilterTaps
+	{
+		std::vector<int> first;
+		std::vector<int> count;
+		std::vector<size_t> offset;
+		std::vector<float> weights;
+	};
+
+	float TentKernel(float x) noexcept
+	{
+		x = std::fabs(x);
+		return x < 1.0f ? 1.0f - x : 0.0f;
+	}
+
+	float Lanczos3Kernel(float x) noexcept
+	{
+		x = std::fabs(x);
+		if (x < 1e-6f)
+		{
+			return 1.0f;
+		}
+		if (x >= 3.0f)
+		{
+			return 0.0f;
+		}
+		const float px = PI * x;
+		return 3.0f * std::sin(px) * std::sin(px / 3.0f) / (px * px);
+	}
+
+	FilterTaps MakeTaps(unsigned int srcSize, unsigned int dstSize, SurfaceSimd::Filter filter)
+	{
+		const float scale = float(srcSize) / float(dstSize);
+		// lanczos widens when minifying so it keeps low-passing, bilinear stays a 2 tap filter
+		const float filterScale = filter == SurfaceSimd::Filter::Lanczos3 ? std::max(scale, 1.0f) : 1.0f;
+		const float radius = (filter == SurfaceSimd::Filter::Lanczos3 ? 3.0f : 1.0f) * filterScale;
+
+		FilterTaps taps;
+		taps.first.resize(dstSize);
+		taps.count.resize(dstSize);
+		taps.offset.resize(dstSize);
+		taps.weights.reserve(size_t(dstSize) * size_t(std::ceil(radius) * 2.0f + 1.0f));
+		for (unsigned int i = 0; i < dstSize; i++)
+		{
+			const float center = (float(i) + 0.5f) * scale - 0.5f;
+			const int lo = std::max(int(std::ceil(center - radius)), 0);
+			const int hi = std::min(int(std::floor(center + radius)), int(srcSize) - 1);
+			taps.first[i] = lo;
+			taps.offset[i] = taps.weights.size();
+			float sum = 0.0f;
+			for (int j = lo; j <= hi; j++)
+			{
+				const float x = (float(j) - center) / filterScale;
+				const float w = filter == SurfaceSimd::Filter::Lanczos3 ? Lanczos3Kernel(x) : TentKernel(x);
+				taps.weights.push_back(w);
+				sum += w;
+			}
+			taps.count[i] = std::max(hi - lo + 1, 0);
+			// renormalize so that taps cut off at the border still sum to one
+			if (sum != 0.0f)
+			{
+				for (int j = 0; j < taps.count[i]; j++)
+				{
+					taps.weights[taps.offset[i] + j] /= sum;
+				}
+			}
+		}
+		return taps;
+	}
+
+	void ResampleRowScalar(float* pDst, const float* pSrc, const FilterTaps& taps, unsigned int dstWidth) noexcept
+	{
+		for (unsigned int x = 0; x < dstWidth; x++)
+		{
+			float acc[4] = {};
+			const float* pW = taps.weights.data() + taps.offset[x];
+			const float* pIn = pSrc + size_t(taps.first[x]) * 4;
+			for (int t = 0; t < taps.count[x]; t++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					acc[c] += pIn[t * 4 + c] * pW[t];
+				}
+			}
+			std::copy(acc, acc + 4, pDst + size_t(x) * 4);
+		}
+	}
+
+	// one float4 pixel per register
+	void ResampleRowSSE2(float* pDst, const float* pSrc, const FilterTaps& taps, unsigned int dstWidth) noexcept
+	{
+		for (unsigned int x = 0; x < dstWidth; x++)
+		{
+			__m128 acc = _mm_setzero_ps();
+			const float* pW = taps.weights.data() + taps.offset[x];
+			const float* pIn = pSrc + size_t(taps.first[x]) * 4;
+			for (int t = 0; t < taps.count[x]; t++)
+			{
+				acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(pIn + t * 4), _mm_set1_ps(pW[t])));
+			}
+			_mm_storeu_ps(pDst + size_t(x) * 4, acc);
+		}
+	}
+
+	// the vertical pass is a weighted sum of whole rows
+	void AccumulateRowScalar(float* pDst, const float* pSrc, float w, size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			pDst[i] += pSrc[i] * w;
+		}
+	}
+
+	void AccumulateRowSSE2(float* pDst, const float* pSrc, float w, size_t count) noexcept
+	{
+		const __m128 vw = _mm_set1_ps(w);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			_mm_storeu_ps(pDst + i, _mm_add_ps(_mm_loadu_ps(pDst + i), _mm_mul_ps(_mm_loadu_ps(pSrc + i), vw)));
+		}
+		AccumulateRowScalar(pDst + i, pSrc + i, w, count - i);
+	}
+
+	SURFACE_SIMD_AVX2 void AccumulateRowAVX2(float* pDst, const float* pSrc, float w, size_t count) noexcept
+	{
+		const __m256 vw = _mm256_set1_ps(w);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			_mm256_storeu_ps(pDst + i, _mm256_add_ps(_mm256_loadu_ps(pDst + i), _mm256_mul_ps(_mm256_loadu_ps(pSrc + i), vw)));
+		}
+		AccumulateRowSSE2(pDst + i, pSrc + i, w, count - i);
+	}
+}
+
+SurfaceSimd::Path SurfaceSimd::path = SurfaceSimd::GetBestSupportedPath();
+
+SurfaceSimd::Path SurfaceSimd::GetBestSupportedPath() noexcept
+{
+	static const Path best = CpuSupportsAvx2() ? Path::AVX2 : Path::SSE2;
+	return best;
+}
+
+SurfaceSimd::Path SurfaceSimd::GetPath() noexcept
+{
+	return path;
+}
+
+void SurfaceSimd::SetPath(Path path_in) noexcept
+{
+	path = std::min(path_in, GetBestSupportedPath());
+}
+
+const char* SurfaceSimd::GetPathName(Path path_in) noexcept
+{
+	switch (path_in)
+	{
+	case Path::Scalar:
+		return "Scalar";
+	case Path::SSE2:
+		return "SSE2";
+	case Path::AVX2:
+		return "AVX2";
+	}
+	return "Unknown";
+}
+
+void SurfaceSimd::Fill(unsigned int* pDst, size_t count, unsigned int value) noexcept
+{
+	switch (path)
+	{
+	case Path::AVX2:
+		FillAVX2(pDst, count, value);
+		break;
+	case Path::SSE2:
+		FillSSE2(pDst, count, value);
+		break;
+	default:
+		FillScalar(pDst, count, value);
+	}
+}
+
+void SurfaceSimd::Copy(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept
+{
+	// the crt memmove is already vectorized and handles overlap
+	memmove(pDst, pSrc, count * sizeof(unsigned int));
+}
+
+void SurfaceSimd::BlendOver(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept
+{
+	switch (path)
+	{
+	case Path::AVX2:
+		BlendOverAVX2(pDst, pSrc, count);
+		break;
+	case Path::SSE2:
+		BlendOverSSE2(pDst, pSrc, count);
+		break;
+	default:
+		BlendOverScalar(pDst, pSrc, count);
+	}
+}
+
+void SurfaceSimd::SwizzleRB(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept
+{
+	switch (path)
+	{
+	case Path::AVX2:
+		SwizzleRBAVX2(pDst, pSrc, count);
+		break;
+	case Path::SSE2:
+		SwizzleRBSSE2(pDst, pSrc, count);
+		break;
+	default:
+		SwizzleRBScalar(pDst, pSrc, count);
+	}
+}
+
+void SurfaceSimd::ToFloat(float* pDst, const unsigned int* pSrc, size_t count) noexcept
+{
+	switch (path)
+	{
+	case Path::AVX2:
+		ToFloatAVX2(pDst, pSrc, count);
+		break;
+	case Path::SSE2:
+		ToFloatSSE2(pDst, pSrc, count);
+		break;
+	default:
+		ToFloatScalar(pDst, pSrc, count);
+	}
+}
+
+void SurfaceSimd::FromFloat(unsigned int* pDst, const float* pSrc, size_t count) noexcept
+{
+	switch (path)
+	{
+	case Path::AVX2:
+		FromFloatAVX2(pDst, pSrc, count);
+		break;
+	case Path::SSE2:
+		FromFloatSSE2(pDst, pSrc, count);
+		break;
+	default:
+		FromFloatScalar(pDst, pSrc, count);
+	}
+}
+
+void SurfaceSimd::FillRect(unsigned int* pDst, size_t dstPitch, unsigned int width, unsigned int height, unsigned int value) noexcept
+{
+	if (dstPitch == width)
+	{
+		Fill(pDst, size_t(width) * height, value);
+		return;
+	}
+	for (unsigned int y = 0; y < height; y++)
+	{
+		Fill(pDst + y * dstPitch, width, value);
+	}
+}
+
+void SurfaceSimd::CopyRect(unsigned int* pDst, size_t dstPitch, const unsigned int* pSrc, size_t srcPitch,
+	unsigned int width, unsigned int height) noexcept
+{
+	// walk bottom up when the destination rows lie after the source rows in memory
+	if (pDst > pSrc)
+	{
+		for (unsigned int y = height; y-- > 0;)
+		{
+			Copy(pDst + y * dstPitch, pSrc + y * srcPitch, width);
+		}
+	}
+	else
+	{
+		for (unsigned int y = 0; y < height; y++)
+		{
+			Copy(pDst + y * dstPitch, pSrc + y * srcPitch, width);
+		}
+	}
+}
+
+void SurfaceSimd::BlendRect(unsigned int* pDst, size_t dstPitch, const unsigned int* pSrc, size_t srcPitch,
+	unsigned int width, unsigned int height) noexcept
+{
+	for (unsigned int y = 0; y < height; y++)
+	{
+		BlendOver(pDst + y * dstPitch, pSrc + y * srcPitch, width);
+	}
+}
+
+void SurfaceSimd::Resample(unsigned int* pDst, unsigned int dstWidth, unsigned int dstHeight,
+	const unsigned int* pSrc, unsigned int srcWidth, unsigned int srcHeight, Filter filter)
+{
+	assert(srcWidth > 0 && srcHeight > 0);
+	if (dstWidth == 0 || dstHeight == 0)
+	{
+		return;
+	}
+
+	const auto hTaps = MakeTaps(srcWidth, dstWidth, filter);
+	const auto vTaps = MakeTaps(srcHeight, dstHeight, filter);
+
+	std::vector<float> srcRow(size_t(srcWidth) * 4);
+	// horizontal pass into a dstWidth x srcHeight float buffer
+	std::vector<float> horizontal(size_t(dstWidth) * srcHeight * 4);
+	const size_t hPitch = size_t(dstWidth) * 4;
+	for (unsigned int y = 0; y < srcHeight; y++)
+	{
+		ToFloat(srcRow.data(), pSrc + size_t(y) * srcWidth, srcWidth);
+		if (path == Path::Scalar)
+		{
+			ResampleRowScalar(horizontal.data() + y * hPitch, srcRow.data(), hTaps, dstWidth);
+		}
+		else
+		{
+			ResampleRowSSE2(horizontal.data() + y * hPitch, srcRow.data(), hTaps, dstWidth);
+		}
+	}
+
+	// vertical pass, one destination row at a time
+	std::vector<float> dstRow(hPitch);
+	for (unsigned int y = 0; y < dstHeight; y++)
+	{
+		std::fill(dstRow.begin(), dstRow.end(), 0.0f);
+		const float* pW = vTaps.weights.data() + vTaps.offset[y];
+		for (int t = 0; t < vTaps.count[y]; t++)
+		{
+			const float* pIn = horizontal.data() + size_t(vTaps.first[y] + t) * hPitch;
+			switch (path)
+			{
+			case Path::AVX2:
+				AccumulateRowAVX2(dstRow.data(), pIn, pW[t], hPitch);
+				break;
+			case Path::SSE2:
+				AccumulateRowSSE2(dstRow.data(), pIn, pW[t], hPitch);
+				break;
+			default:
+				AccumulateRowScalar(dstRow.data(), pIn, pW[t], hPitch);
+			}
+		}
+		FromFloat(pDst + size_t(y) * dstWidth, dstRow.data(), dstWidth);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+
+// raw pixel kernels backing the Surface operations
+// pixels are 32-bit 0xAARRGGBB (BGRA in memory), float pixels are RGBA in [0,1]
+// every kernel has a scalar reference path, the widest path the cpu supports is picked at startup
+class SurfaceSimd
+{
+public:
+	enum class Path
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+	};
+	enum class Filter
+	{
+		Bilinear,
+		Lanczos3,
+	};
+public:
+	static Path GetBestSupportedPath() noexcept;
+	static Path GetPath() noexcept;
+	// forcing a path is meant for comparing against the scalar reference, it is clamped to what the cpu supports
+	static void SetPath(Path path) noexcept;
+	static const char* GetPathName(Path path) noexcept;
+
+	static void Fill(unsigned int* pDst, size_t count, unsigned int value) noexcept;
+	static void Copy(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept;
+	// straight alpha src-over-dst, dst alpha becomes a_s + a_d * (1 - a_s)
+	static void BlendOver(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept;
+	// swaps the r and b channels, converts between BGRA8 and RGBA8 (pDst may equal pSrc)
+	static void SwizzleRB(unsigned int* pDst, const unsigned int* pSrc, size_t count) noexcept;
+	// BGRA8 <-> float RGBA (4 floats per pixel)
+	static void ToFloat(float* pDst, const unsigned int* pSrc, size_t count) noexcept;
+	static void FromFloat(unsigned int* pDst, const float* pSrc, size_t count) noexcept;
+
+	// 2d helpers, pitches are in pixels
+	static void FillRect(unsigned int* pDst, size_t dstPitch, unsigned int width, unsigned int height, unsigned int value) noexcept;
+	static void CopyRect(unsigned int* pDst, size_t dstPitch, const unsigned int* pSrc, size_t srcPitch,
+		unsigned int width, unsigned int height) noexcept;
+	static void BlendRect(unsigned int* pDst, size_t dstPitch, const unsigned int* pSrc, size_t srcPitch,
+		unsigned int width, unsigned int height) noexcept;
+	// separable resampler, dst must hold dstWidth * dstHeight pixels
+	static void Resample(unsigned int* pDst, unsigned int dstWidth, unsigned int dstHeight,
+		const unsigned int* pSrc, unsigned int srcWidth, unsigned int srcHeight, Filter filter);
+private:
+	static Path path;
+};
@@ -28,6 +28,7 @@ Texture::Texture(Graphics& gfx, const Surface& s)
 	GFX_THROW_INFO(GetDevice(gfx)->CreateTexture2D(
 		&textureDesc, &sd, &pTexture
 	));
+	gpuMemory.Set(size_t(s.GetWidth()) * s.GetHeight() * sizeof(Surface::Color));
 
 	// create the resource view on the texture
 	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
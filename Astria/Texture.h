@@ -1,5 +1,6 @@
 #pragma once
 #include "Bindable.h"
+#include "MemoryTracker.h"
 
 class Texture : public Bindable
 {
@@ -8,4 +9,5 @@ public:
 	void Bind(Graphics& gfx) noexcept override;
 protected:
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> pTextureView;
+	MemoryTracker::GpuAllocation gpuMemory{ MemoryTracker::Subsystem::Textures };
 };
@@ -1,5 +1,7 @@
 #include "TexturedCone.h"
 #include "BindableBase.h"
+#include "PhongPermutation.h"
+#include "GeometryCache.h"
 #include "GraphicsThrowMacros.h"
 #include "Surface.h"
 #include "Texture.h"
@@ -22,13 +24,7 @@ TexturedCone::TexturedCone(Graphics& gfx,
 	{
 		AddStaticBind(std::make_unique<Texture>(gfx, Surface::FromFile("Images\\storm.jpg")));
 
-		AddStaticBind(std::make_unique<Sampler>(gfx));
-
-		auto pvs = std::make_unique<VertexShader>(gfx, L"TexturedPhongVS.cso");
-		auto pvsbc = pvs->GetBytecode();
-		AddStaticBind(std::move(pvs));
-
-		AddStaticBind(std::make_unique<PixelShader>(gfx, L"TexturedPhongPS.cso"));
+		AddStaticBind(Codex::Resolve<Sampler>(gfx));
 
 		const std::vector<D3D11_INPUT_ELEMENT_DESC> ied =
 		{
@@ -36,9 +32,12 @@ TexturedCone::TexturedCone(Graphics& gfx,
 			{ "Normal",0,DXGI_FORMAT_R32G32B32_FLOAT,0,12,D3D11_INPUT_PER_VERTEX_DATA,0 },
 			{ "TexCoord",0,DXGI_FORMAT_R32G32_FLOAT,0,24,D3D11_INPUT_PER_VERTEX_DATA,0 },
 		};
-		AddStaticBind(std::make_unique<InputLayout>(gfx, ied, pvsbc));
+		const auto& phong = PhongPermutation::Resolve(gfx, PhongPermutation::FeaturesFromLayout(ied));
+		AddStaticBind(phong.pVertexShader);
+		AddStaticBind(phong.pPixelShader);
+		AddStaticBind(Codex::Resolve<InputLayout>(gfx, ied, phong.pVertexShader->GetBytecode()));
 
-		AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		AddStaticBind(Codex::Resolve<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
 
 		struct PSMaterialConstant
 		{
@@ -55,12 +54,12 @@ TexturedCone::TexturedCone(Graphics& gfx,
 		dx::XMFLOAT3 n;
 		dx::XMFLOAT2 tc;
 	};
-	auto model = ConeVertices::MakeTesselatedIndependentTextureFaces<Vertex>(longDist(rng));
+	const auto mesh = GeometryCache::Resolve<Vertex>(gfx, "Cone.IndependentTextureFaces", ConeVertices::MakeTesselatedIndependentTextureFaces<Vertex>, longDist(rng));
 
-	AddBind(std::make_unique<VertexBuffer>(gfx, model.vertices));
+	AddBind(mesh.pVertexBuffer);
 
 
-	AddIndexBuffer(std::make_unique<IndexBuffer>(gfx, model.indices));
+	AddIndexBuffer(mesh.pIndexBuffer);
 
 
 	AddBind(std::make_unique<TransformCbuf>(gfx, *this));
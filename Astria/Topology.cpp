@@ -9,3 +9,8 @@ void Topology::Bind(Graphics& gfx) noexcept
 {
 	GetContext(gfx)->IASetPrimitiveTopology(type);
 }
+
+std::string Topology::GenerateUID(D3D11_PRIMITIVE_TOPOLOGY type)
+{
+	return std::to_string(type);
+}
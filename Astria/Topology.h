@@ -6,6 +6,7 @@ class Topology : public Bindable
 public:
 	Topology(Graphics& gfx, D3D11_PRIMITIVE_TOPOLOGY type);
 	void Bind(Graphics& gfx)  noexcept override;
+	static std::string GenerateUID(D3D11_PRIMITIVE_TOPOLOGY type);
 protected:
 	D3D11_PRIMITIVE_TOPOLOGY type;
 };
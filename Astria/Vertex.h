@@ -1,7 +1,14 @@
 #pragma once
 #include <vector>
+#include <algorithm>
+#include <array>
+#include <execution>
+#include <memory_resource>
+#include <cstring>
 #include <type_traits>
+#include <utility>
 #include "Graphics.h"
+#include <DirectXPackedVector.h>
 
 namespace as3dexp
 {
@@ -25,6 +32,13 @@ namespace as3dexp
 			Float3Color,
 			Float4Color,
 			BGRAColor,
+			Tangent,
+			Bitangent,
+			// packed formats, see VertexQuantizer
+			Position3DHalf,
+			Position3DSnorm16,
+			Texture2DHalf,
+			NormalPacked,
 			Count,
 		};
 		template<ElementType> struct Map;
@@ -70,14 +84,54 @@ namespace as3dexp
 			static constexpr DXGI_FORMAT dxgiFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
 			static constexpr const char* semantic = "Color";
 		};
+		template<> struct Map<Tangent>
+		{
+			using SysType = DirectX::XMFLOAT3;
+			static constexpr DXGI_FORMAT dxgiFormat = DXGI_FORMAT_R32G32B32_FLOAT;
+			static constexpr const char* semantic = "Tangent";
+		};
+		template<> struct Map<Bitangent>
+		{
+			using SysType = DirectX::XMFLOAT3;
+			static constexpr DXGI_FORMAT dxgiFormat = DXGI_FORMAT_R32G32B32_FLOAT;
+			static constexpr const char* semantic = "Bitangent";
+		};
+		// no 3 component 16-bit formats exist, w rides along as 1
+		template<> struct Map<Position3DHalf>
+		{
+			using SysType = DirectX::PackedVector::XMHALF4;
+			static constexpr DXGI_FORMAT dxgiFormat = DXGI_FORMAT_R16G16B16A16_FLOAT;
+			static constexpr const char* semantic = "Position";
+		};
+		// [-1,1] within the mesh bounds, the vertex shader applies the per-mesh scale and offset
+		template<> struct Map<Position3DSnorm16>
+		{
+			using SysType = DirectX::PackedVector::XMSHORTN4;
+			static constexpr DXGI_FORMAT dxgiFormat = DXGI_FORMAT_R16G16B16A16_SNORM;
+			static constexpr const char* semantic = "Position";
+		};
+		template<> struct Map<Texture2DHalf>
+		{
+			using SysType = DirectX::PackedVector::XMHALF2;
+			static constexpr DXGI_FORMAT dxgiFormat = DXGI_FORMAT_R16G16_FLOAT;
+			static constexpr const char* semantic = "Texcoord";
+		};
+		// xyz mapped from [-1,1] to 10-bit unorm, the vertex shader expands with n * 2 - 1
+		template<> struct Map<NormalPacked>
+		{
+			using SysType = DirectX::PackedVector::XMUDECN4;
+			static constexpr DXGI_FORMAT dxgiFormat = DXGI_FORMAT_R10G10B10A2_UNORM;
+			static constexpr const char* semantic = "Normal";
+		};
 
 		class Element
 		{
 		public:
-			Element(ElementType type, size_t offset)
+			Element(ElementType type, size_t offset, UINT slot = 0u)
 				:
 				type(type),
-				offset(offset)
+				offset(offset),
+				slot(slot)
 			{}
 			size_t GetOffsetAfter() const noexcept(!IS_DEBUG)
 			{
@@ -109,6 +163,18 @@ namespace as3dexp
 					return sizeof(Map<Float4Color>::SysType);
 				case BGRAColor:
 					return sizeof(Map<BGRAColor>::SysType);
+				case Tangent:
+					return sizeof(Map<Tangent>::SysType);
+				case Bitangent:
+					return sizeof(Map<Bitangent>::SysType);
+				case Position3DHalf:
+					return sizeof(Map<Position3DHalf>::SysType);
+				case Position3DSnorm16:
+					return sizeof(Map<Position3DSnorm16>::SysType);
+				case Texture2DHalf:
+					return sizeof(Map<Texture2DHalf>::SysType);
+				case NormalPacked:
+					return sizeof(Map<NormalPacked>::SysType);
 				}
 				assert("Invalid element type" && false);
 				return 0u;
@@ -117,37 +183,55 @@ namespace as3dexp
 			{
 				return type;
 			}
+			// input assembler slot of the stream this element lives in, the offset is relative to that stream
+			UINT GetSlot() const noexcept
+			{
+				return slot;
+			}
 			D3D11_INPUT_ELEMENT_DESC GetDesc() const noexcept(!IS_DEBUG)
 			{
 				switch (type)
 				{
 				case Position2D:
-					return GenerateDesc<Position2D>(GetOffset());
+					return GenerateDesc<Position2D>(GetOffset(), slot);
 				case Position3D:
-					return GenerateDesc<Position3D>(GetOffset());
+					return GenerateDesc<Position3D>(GetOffset(), slot);
 				case Texture2D:
-					return GenerateDesc<Texture2D>(GetOffset());
+					return GenerateDesc<Texture2D>(GetOffset(), slot);
 				case Normal:
-					return GenerateDesc<Normal>(GetOffset());
+					return GenerateDesc<Normal>(GetOffset(), slot);
 				case Float3Color:
-					return GenerateDesc<Float3Color>(GetOffset());
+					return GenerateDesc<Float3Color>(GetOffset(), slot);
 				case Float4Color:
-					return GenerateDesc<Float4Color>(GetOffset());
+					return GenerateDesc<Float4Color>(GetOffset(), slot);
 				case BGRAColor:
-					return GenerateDesc<BGRAColor>(GetOffset());
+					return GenerateDesc<BGRAColor>(GetOffset(), slot);
+				case Tangent:
+					return GenerateDesc<Tangent>(GetOffset(), slot);
+				case Bitangent:
+					return GenerateDesc<Bitangent>(GetOffset(), slot);
+				case Position3DHalf:
+					return GenerateDesc<Position3DHalf>(GetOffset(), slot);
+				case Position3DSnorm16:
+					return GenerateDesc<Position3DSnorm16>(GetOffset(), slot);
+				case Texture2DHalf:
+					return GenerateDesc<Texture2DHalf>(GetOffset(), slot);
+				case NormalPacked:
+					return GenerateDesc<NormalPacked>(GetOffset(), slot);
 				}
 				assert("Invalid element type" && false);
 				return { "INVALID",0,DXGI_FORMAT_UNKNOWN,0,0,D3D11_INPUT_PER_VERTEX_DATA,0 };
 			}
 		private:
 			template<ElementType type>
-			static constexpr D3D11_INPUT_ELEMENT_DESC GenerateDesc(size_t offset) noexcept(!IS_DEBUG)
+			static constexpr D3D11_INPUT_ELEMENT_DESC GenerateDesc(size_t offset, UINT slot) noexcept(!IS_DEBUG)
 			{
-				return { Map<type>::semantic,0,Map<type>::dxgiFormat,0,(UINT)offset,D3D11_INPUT_PER_VERTEX_DATA,0 };
+				return { Map<type>::semantic,0,Map<type>::dxgiFormat,slot,(UINT)offset,D3D11_INPUT_PER_VERTEX_DATA,0 };
 			}
 		private:
 			ElementType type;
 			size_t offset;
+			UINT slot;
 		};
 	public:
 		template<ElementType Type>
@@ -169,9 +253,35 @@ namespace as3dexp
 		}
 		VertexLayout& Append(ElementType type) noexcept(!IS_DEBUG)
 		{
-			elements.emplace_back(type, Size());
+			elements.emplace_back(type, Size(), slot);
+			return *this;
+		}
+		// moves the whole layout to another input slot, used when it describes one stream of several
+		VertexLayout& SetSlot(UINT slot) noexcept(!IS_DEBUG)
+		{
+			this->slot = slot;
+			for (auto& e : elements)
+			{
+				e = Element{ e.GetType(),e.GetOffset(),slot };
+			}
 			return *this;
 		}
+		UINT GetSlot() const noexcept
+		{
+			return slot;
+		}
+		// index of the first element of type, GetElementCount() when the layout has none
+		size_t IndexOf(ElementType type) const noexcept
+		{
+			for (size_t i = 0u; i < elements.size(); i++)
+			{
+				if (elements[i].GetType() == type)
+				{
+					return i;
+				}
+			}
+			return elements.size();
+		}
 		size_t Size() const noexcept(!IS_DEBUG)
 		{
 			return elements.empty() ? 0u : elements.back().GetOffsetAfter();
@@ -180,9 +290,10 @@ namespace as3dexp
 		{
 			return elements.size();
 		}
-		std::vector<D3D11_INPUT_ELEMENT_DESC> GetD3DLayout() const noexcept(!IS_DEBUG)
+		// pass FrameAllocator::Get() for a description that is only looked at right away
+		std::pmr::vector<D3D11_INPUT_ELEMENT_DESC> GetD3DLayout(std::pmr::memory_resource* pResource = std::pmr::get_default_resource()) const noexcept(!IS_DEBUG)
 		{
-			std::vector<D3D11_INPUT_ELEMENT_DESC> desc;
+			std::pmr::vector<D3D11_INPUT_ELEMENT_DESC> desc(pResource);
 			desc.reserve(GetElementCount());
 			for (const auto& e : elements)
 			{
@@ -192,6 +303,7 @@ namespace as3dexp
 		}
 	private:
 		std::vector<Element> elements;
+		UINT slot = 0u;
 	};
 
 	class Vertex
@@ -232,6 +344,24 @@ namespace as3dexp
 			case VertexLayout::BGRAColor:
 				SetAttribute<VertexLayout::BGRAColor>(pAttribute, std::forward<T>(val));
 				break;
+			case VertexLayout::Tangent:
+				SetAttribute<VertexLayout::Tangent>(pAttribute, std::forward<T>(val));
+				break;
+			case VertexLayout::Bitangent:
+				SetAttribute<VertexLayout::Bitangent>(pAttribute, std::forward<T>(val));
+				break;
+			case VertexLayout::Position3DHalf:
+				SetAttribute<VertexLayout::Position3DHalf>(pAttribute, std::forward<T>(val));
+				break;
+			case VertexLayout::Position3DSnorm16:
+				SetAttribute<VertexLayout::Position3DSnorm16>(pAttribute, std::forward<T>(val));
+				break;
+			case VertexLayout::Texture2DHalf:
+				SetAttribute<VertexLayout::Texture2DHalf>(pAttribute, std::forward<T>(val));
+				break;
+			case VertexLayout::NormalPacked:
+				SetAttribute<VertexLayout::NormalPacked>(pAttribute, std::forward<T>(val));
+				break;
 			default:
 				assert("Bad element type" && false);
 			}
@@ -294,6 +424,14 @@ namespace as3dexp
 			:
 			layout(std::move(layout))
 		{}
+		// adopts already packed vertex data, size must be a multiple of the layout size
+		VertexBuffer(VertexLayout layout, std::vector<char> data) noexcept(!IS_DEBUG)
+			:
+			buffer(std::move(data)),
+			layout(std::move(layout))
+		{
+			assert(this->layout.Size() != 0u && buffer.size() % this->layout.Size() == 0u);
+		}
 		const char* GetData() const noexcept(!IS_DEBUG)
 		{
 			return buffer.data();
@@ -314,9 +452,95 @@ namespace as3dexp
 		void EmplaceBack(Params&&... params) noexcept(!IS_DEBUG)
 		{
 			assert(sizeof...(params) == layout.GetElementCount() && "Param count doesn't match number of vertex elements");
+			const auto capacity = buffer.capacity();
 			buffer.resize(buffer.size() + layout.Size());
+			reallocations += buffer.capacity() != capacity ? 1u : 0u;
 			Back().SetAttributeByIndex(0u, std::forward<Params>(params)...);
 		}
+		void Reserve(size_t count)
+		{
+			const auto capacity = buffer.capacity();
+			buffer.reserve(count * layout.Size());
+			reallocations += buffer.capacity() != capacity ? 1u : 0u;
+		}
+		// grows or shrinks to count vertices, new vertices are zeroed and meant to be filled by the stream writers
+		void Resize(size_t count)
+		{
+			const auto capacity = buffer.capacity();
+			buffer.resize(count * layout.Size());
+			reallocations += buffer.capacity() != capacity ? 1u : 0u;
+		}
+		// times the storage moved to a new allocation, a fill that reserved up front stays at 1
+		size_t GetReallocationCount() const noexcept
+		{
+			return reallocations;
+		}
+		// copies a whole attribute array into the strided slots of vertices [first, first + count)
+		template<VertexLayout::ElementType Type>
+		void WriteStream(const typename VertexLayout::Map<Type>::SysType* pSrc, size_t count, size_t first = 0u) noexcept(!IS_DEBUG)
+		{
+			using SysType = typename VertexLayout::Map<Type>::SysType;
+			assert("Stream write out of range" && first + count <= Size());
+			const size_t stride = layout.Size();
+			char* const pDst = buffer.data() + first * stride + layout.Resolve<Type>().GetOffset();
+			ForChunks(count, [=](size_t begin, size_t end)
+			{
+				// fixed size copies compile down to plain moves
+				for (size_t i = begin; i < end; i++)
+				{
+					std::memcpy(pDst + i * stride, pSrc + i, sizeof(SysType));
+				}
+			});
+		}
+		// streams gen(i) into the attribute of vertex first + i, gen may run on several threads at once
+		template<VertexLayout::ElementType Type, typename F>
+		void GenerateStream(size_t count, F&& gen, size_t first = 0u) noexcept(!IS_DEBUG)
+		{
+			using SysType = typename VertexLayout::Map<Type>::SysType;
+			assert("Stream write out of range" && first + count <= Size());
+			const size_t stride = layout.Size();
+			char* const pDst = buffer.data() + first * stride + layout.Resolve<Type>().GetOffset();
+			ForChunks(count, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const SysType value = gen(i);
+					std::memcpy(pDst + i * stride, &value, sizeof(SysType));
+				}
+			});
+		}
+		// copies element srcIndex of every vertex in src into element dstIndex of the same vertex here
+		void CopyAttribute(const VertexBuffer& src, size_t srcIndex, size_t dstIndex) noexcept(!IS_DEBUG)
+		{
+			const auto& s = src.layout.ResolveByIndex(srcIndex);
+			const auto& d = layout.ResolveByIndex(dstIndex);
+			assert("Attribute type mismatch" && s.GetType() == d.GetType());
+			assert("Vertex count mismatch" && src.Size() == Size());
+			const size_t size = d.Size();
+			const size_t srcStride = src.layout.Size();
+			const size_t dstStride = layout.Size();
+			const char* const pSrc = src.buffer.data() + s.GetOffset();
+			char* const pDst = buffer.data() + d.GetOffset();
+			ForChunks(Size(), [=](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					std::memcpy(pDst + i * dstStride, pSrc + i * srcStride, size);
+				}
+			});
+		}
+		// calls fill(vertex, i) for every vertex, large buffers are split across threads
+		template<typename F>
+		void ParallelFill(F&& fill) noexcept(!IS_DEBUG)
+		{
+			ForChunks(Size(), [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					fill((*this)[i], i);
+				}
+			});
+		}
 		Vertex Back() noexcept(!IS_DEBUG)
 		{
 			assert(buffer.size() != 0u);
@@ -345,7 +569,323 @@ namespace as3dexp
 			return const_cast<VertexBuffer&>(*this)[i];
 		}
 	private:
+		// runs f(begin, end) over [0, count), in parallel chunks once the range is big enough to pay for it
+		template<typename F>
+		static void ForChunks(size_t count, F&& f)
+		{
+			if (count < parallelThreshold)
+			{
+				f(size_t(0u), count);
+				return;
+			}
+			std::vector<size_t> chunks((count + chunkSize - 1u) / chunkSize);
+			for (size_t i = 0u; i < chunks.size(); i++)
+			{
+				chunks[i] = i * chunkSize;
+			}
+			std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](size_t begin)
+			{
+				f(begin, std::min(begin + chunkSize, count));
+			});
+		}
+	private:
+		static constexpr size_t parallelThreshold = 1u << 18u;
+		static constexpr size_t chunkSize = 1u << 15u;
 		std::vector<char> buffer;
 		VertexLayout layout;
+		size_t reallocations = 0u;
+	};
+
+	// one vertex buffer per input slot, stream i holds a subset of the elements for the same vertices
+	// passes that only read positions bind the first stream and skip fetching the rest
+	class VertexStreams
+	{
+	public:
+		using Group = std::vector<VertexLayout::ElementType>;
+	public:
+		// every element of vbuf has to land in exactly one group, group i becomes the stream in slot i
+		static VertexStreams Deinterleave(const VertexBuffer& vbuf, const std::vector<Group>& groups) noexcept(!IS_DEBUG)
+		{
+			const auto& src = vbuf.GetLayout();
+			VertexStreams out;
+			size_t assigned = 0u;
+			for (size_t s = 0u; s < groups.size(); s++)
+			{
+				VertexLayout layout;
+				layout.SetSlot(UINT(s));
+				for (const auto type : groups[s])
+				{
+					layout.Append(type);
+				}
+				VertexBuffer stream(std::move(layout));
+				stream.Resize(vbuf.Size());
+				for (size_t e = 0u; e < groups[s].size(); e++)
+				{
+					const size_t i = src.IndexOf(groups[s][e]);
+					assert("Stream element not in source layout" && i < src.GetElementCount());
+					stream.CopyAttribute(vbuf, i, e);
+				}
+				assigned += groups[s].size();
+				out.streams.push_back(std::move(stream));
+			}
+			assert("Every element needs exactly one stream" && assigned == src.GetElementCount());
+			return out;
+		}
+		// positions in slot 0, all other elements in slot 1
+		static VertexStreams SplitPositions(const VertexBuffer& vbuf) noexcept(!IS_DEBUG)
+		{
+			Group positions;
+			Group attributes;
+			const auto& layout = vbuf.GetLayout();
+			for (size_t i = 0u; i < layout.GetElementCount(); i++)
+			{
+				const auto type = layout.ResolveByIndex(i).GetType();
+				const bool isPosition = type == VertexLayout::Position2D || type == VertexLayout::Position3D ||
+					type == VertexLayout::Position3DHalf || type == VertexLayout::Position3DSnorm16;
+				(isPosition ? positions : attributes).push_back(type);
+			}
+			if (attributes.empty())
+			{
+				return Deinterleave(vbuf, { positions });
+			}
+			return Deinterleave(vbuf, { positions,attributes });
+		}
+		// single interleaved stream, elements in stream order
+		VertexBuffer Interleave() const noexcept(!IS_DEBUG)
+		{
+			VertexLayout layout;
+			for (const auto& stream : streams)
+			{
+				for (size_t i = 0u; i < stream.GetLayout().GetElementCount(); i++)
+				{
+					layout.Append(stream.GetLayout().ResolveByIndex(i).GetType());
+				}
+			}
+			return Interleave(layout);
+		}
+		// single interleaved stream in the element order of layout, e.g. the layout the streams were split from
+		VertexBuffer Interleave(const VertexLayout& layout) const noexcept(!IS_DEBUG)
+		{
+			auto interleaved = layout;
+			VertexBuffer out(std::move(interleaved.SetSlot(0u)));
+			out.Resize(Size());
+			for (size_t e = 0u; e < layout.GetElementCount(); e++)
+			{
+				const auto type = layout.ResolveByIndex(e).GetType();
+				bool found = false;
+				for (const auto& stream : streams)
+				{
+					if (const size_t i = stream.GetLayout().IndexOf(type); i < stream.GetLayout().GetElementCount())
+					{
+						out.CopyAttribute(stream, i, e);
+						found = true;
+						break;
+					}
+				}
+				assert("Element not present in any stream" && found);
+			}
+			return out;
+		}
+		size_t GetStreamCount() const noexcept
+		{
+			return streams.size();
+		}
+		const VertexBuffer& GetStream(size_t i) const noexcept(!IS_DEBUG)
+		{
+			assert(i < streams.size());
+			return streams[i];
+		}
+		size_t Size() const noexcept(!IS_DEBUG)
+		{
+			return streams.empty() ? 0u : streams.front().Size();
+		}
+		size_t SizeBytes() const noexcept(!IS_DEBUG)
+		{
+			size_t bytes = 0u;
+			for (const auto& stream : streams)
+			{
+				bytes += stream.SizeBytes();
+			}
+			return bytes;
+		}
+		// input layout over the first streamCount streams, a position only pass asks for 1
+		std::pmr::vector<D3D11_INPUT_ELEMENT_DESC> GetD3DLayout(size_t streamCount = ~size_t(0u),
+			std::pmr::memory_resource* pResource = std::pmr::get_default_resource()) const noexcept(!IS_DEBUG)
+		{
+			std::pmr::vector<D3D11_INPUT_ELEMENT_DESC> desc(pResource);
+			for (size_t s = 0u; s < std::min(streamCount, streams.size()); s++)
+			{
+				const auto streamDesc = streams[s].GetLayout().GetD3DLayout(pResource);
+				desc.insert(desc.end(), streamDesc.begin(), streamDesc.end());
+			}
+			return desc;
+		}
+	private:
+		std::vector<VertexBuffer> streams;
+	};
+
+	// layout fixed at compile time, offsets/stride/input desc are constants and attribute writes need no lookup
+	// use it where the vertex format is known up front, convert to VertexLayout where a dynamic one is expected
+	template<VertexLayout::ElementType...Types>
+	class StaticVertexLayout
+	{
+	public:
+		static constexpr size_t count = sizeof...(Types);
+		static constexpr std::array<VertexLayout::ElementType, count> types = { Types... };
+		static constexpr std::array<size_t, count> offsets = []()
+		{
+			std::array<size_t, count> o = {};
+			size_t offset = 0u;
+			for (size_t i = 0u; i < count; i++)
+			{
+				o[i] = offset;
+				offset += VertexLayout::Element::SizeOf(types[i]);
+			}
+			return o;
+		}();
+		static constexpr size_t stride = (VertexLayout::Element::SizeOf(Types) + ... + 0u);
+		static_assert(count > 0u, "Static vertex layout needs at least one element");
+	public:
+		template<VertexLayout::ElementType Type>
+		static constexpr size_t IndexOf() noexcept
+		{
+			constexpr size_t index = []()
+			{
+				for (size_t i = 0u; i < count; i++)
+				{
+					if (types[i] == Type)
+					{
+						return i;
+					}
+				}
+				return count;
+			}();
+			static_assert(index < count, "Element type not in static vertex layout");
+			return index;
+		}
+		template<VertexLayout::ElementType Type>
+		static constexpr size_t OffsetOf() noexcept
+		{
+			return offsets[IndexOf<Type>()];
+		}
+		static constexpr size_t Size() noexcept
+		{
+			return stride;
+		}
+		static constexpr std::array<D3D11_INPUT_ELEMENT_DESC, count> GetD3DDescs() noexcept
+		{
+			std::array<D3D11_INPUT_ELEMENT_DESC, count> desc = {};
+			size_t i = 0u;
+			((desc[i] = { VertexLayout::Map<Types>::semantic,0,VertexLayout::Map<Types>::dxgiFormat,0,(UINT)offsets[i],D3D11_INPUT_PER_VERTEX_DATA,0 }, i++), ...);
+			return desc;
+		}
+		static std::pmr::vector<D3D11_INPUT_ELEMENT_DESC> GetD3DLayout(std::pmr::memory_resource* pResource = std::pmr::get_default_resource())
+		{
+			const auto desc = GetD3DDescs();
+			return { desc.begin(),desc.end(),pResource };
+		}
+		static VertexLayout GetDynamic() noexcept(!IS_DEBUG)
+		{
+			VertexLayout layout;
+			(layout.Append(Types), ...);
+			return layout;
+		}
+		static bool Matches(const VertexLayout& layout) noexcept(!IS_DEBUG)
+		{
+			if (layout.GetElementCount() != count)
+			{
+				return false;
+			}
+			for (size_t i = 0u; i < count; i++)
+			{
+				if (layout.ResolveByIndex(i).GetType() != types[i])
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	// vertex storage for a StaticVertexLayout, attributes are written straight to their constant offsets
+	template<class Layout>
+	class StaticVertexBuffer
+	{
+	private:
+		// one packed vertex, constructed in place from the attributes so appending does not zero fill
+		struct Storage
+		{
+			Storage() = default;
+			template<typename...Params>
+			Storage(std::in_place_t, Params&&...params) noexcept
+			{
+				Write<0u>(bytes, std::forward<Params>(params)...);
+			}
+			char bytes[Layout::stride];
+		};
+	public:
+		StaticVertexBuffer() = default;
+		const char* GetData() const noexcept
+		{
+			return reinterpret_cast<const char*>(vertices.data());
+		}
+		size_t Size() const noexcept
+		{
+			return vertices.size();
+		}
+		size_t SizeBytes() const noexcept
+		{
+			return vertices.size() * Layout::stride;
+		}
+		void Reserve(size_t count)
+		{
+			vertices.reserve(count);
+		}
+		template<typename...Params>
+		void EmplaceBack(Params&&...params)
+		{
+			static_assert(sizeof...(Params) == Layout::count, "Param count doesn't match number of vertex elements");
+			vertices.emplace_back(std::in_place, std::forward<Params>(params)...);
+		}
+		template<VertexLayout::ElementType Type>
+		auto& Attr(size_t i) noexcept(!IS_DEBUG)
+		{
+			assert(i < Size());
+			using SysType = typename VertexLayout::Map<Type>::SysType;
+			return *reinterpret_cast<SysType*>(vertices[i].bytes + Layout::template OffsetOf<Type>());
+		}
+		template<VertexLayout::ElementType Type>
+		const auto& Attr(size_t i) const noexcept(!IS_DEBUG)
+		{
+			return const_cast<StaticVertexBuffer*>(this)->template Attr<Type>(i);
+		}
+		// copies into a dynamic buffer for code paths that take as3dexp::VertexBuffer
+		VertexBuffer ToDynamic() const
+		{
+			return { Layout::GetDynamic(),std::vector<char>(GetData(),GetData() + SizeBytes()) };
+		}
+		static StaticVertexBuffer FromDynamic(const VertexBuffer& vbuf) noexcept(!IS_DEBUG)
+		{
+			assert("Dynamic layout does not match static layout" && Layout::Matches(vbuf.GetLayout()));
+			StaticVertexBuffer out;
+			out.vertices.resize(vbuf.Size());
+			std::memcpy(out.vertices.data(), vbuf.GetData(), vbuf.SizeBytes());
+			return out;
+		}
+	private:
+		template<size_t I>
+		static void Write(char*) noexcept
+		{}
+		template<size_t I, typename First, typename...Rest>
+		static void Write(char* pVertex, First&& first, Rest&&...rest) noexcept
+		{
+			using Dest = typename VertexLayout::Map<Layout::types[I]>::SysType;
+			static_assert(std::is_convertible<First, Dest>::value, "Parameter attribute type mismatch");
+			const Dest value = std::forward<First>(first);
+			std::memcpy(pVertex + Layout::offsets[I], &value, sizeof(Dest));
+			Write<I + 1u>(pVertex, std::forward<Rest>(rest)...);
+		}
+	private:
+		std::vector<Storage> vertices;
 	};
 }
\ No newline at end of file
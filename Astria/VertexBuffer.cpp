@@ -2,6 +2,38 @@
 
 void VertexBuffer::Bind(Graphics& gfx) noexcept
 {
-	const UINT offset = 0u;
-	GetContext(gfx)->IASetVertexBuffers(0u, 1u, pVertexBuffer.GetAddressOf(), &stride, &offset);
+	BindStreams(gfx, GetStreamCount());
+}
+
+void VertexBuffer::BindStreams(Graphics& gfx, UINT count) noexcept
+{
+	GetContext(gfx)->IASetVertexBuffers(0u, std::min(count, GetStreamCount()), pBindBuffers.data(), strides.data(), offsets.data());
+}
+
+UINT VertexBuffer::GetStreamCount() const noexcept
+{
+	return (UINT)pBindBuffers.size();
+}
+
+void VertexBuffer::AddStream(Graphics& gfx, const void* pData, size_t sizeBytes, UINT stride)
+{
+	INFOMAN(gfx);
+
+	D3D11_BUFFER_DESC bd = {};
+	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	bd.Usage = D3D11_USAGE_DEFAULT;
+	bd.CPUAccessFlags = 0u;
+	bd.MiscFlags = 0u;
+	bd.ByteWidth = UINT(sizeBytes);
+	bd.StructureByteStride = stride;
+	D3D11_SUBRESOURCE_DATA sd = {};
+	sd.pSysMem = pData;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> pVertexBuffer;
+	GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&bd, &sd, &pVertexBuffer));
+	gpuMemory.Set(gpuMemory.GetBytes() + sizeBytes);
+
+	pBindBuffers.push_back(pVertexBuffer.Get());
+	pVertexBuffers.push_back(std::move(pVertexBuffer));
+	strides.push_back(stride);
+	offsets.push_back(0u);
 }
@@ -2,50 +2,52 @@
 #include "Bindable.h"
 #include "GraphicsThrowMacros.h"
 #include "Vertex.h"
+#include "MemoryTracker.h"
 
 class VertexBuffer : public Bindable
 {
 public:
 	template<class V>
 	VertexBuffer(Graphics& gfx, const std::vector<V>& vertices)
-		:
-		stride(sizeof(V))
 	{
-		INFOMAN(gfx);
-
-		D3D11_BUFFER_DESC bd = {};
-		bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		bd.Usage = D3D11_USAGE_DEFAULT;
-		bd.CPUAccessFlags = 0u;
-		bd.MiscFlags = 0u;
-		bd.ByteWidth = UINT(sizeof(V) * vertices.size());
-		bd.StructureByteStride = sizeof(V);
-		D3D11_SUBRESOURCE_DATA sd = {};
-		sd.pSysMem = vertices.data();
-		GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&bd, &sd, &pVertexBuffer));
+		AddStream(gfx, vertices.data(), sizeof(V) * vertices.size(), sizeof(V));
 	}
 
 	VertexBuffer(Graphics& gfx, const as3dexp::VertexBuffer& vbuf)
-		:
-		stride((UINT)vbuf.GetLayout().Size())
 	{
-		INFOMAN(gfx);
+		AddStream(gfx, vbuf.GetData(), vbuf.SizeBytes(), (UINT)vbuf.GetLayout().Size());
+	}
 
-		D3D11_BUFFER_DESC bd = {};
-		bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		bd.Usage = D3D11_USAGE_DEFAULT;
-		bd.CPUAccessFlags = 0u;
-		bd.MiscFlags = 0u;
-		bd.ByteWidth = UINT(vbuf.SizeBytes());
-		bd.StructureByteStride = stride;
-		D3D11_SUBRESOURCE_DATA sd = {};
-		sd.pSysMem = vbuf.GetData();
-		GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&bd, &sd, &pVertexBuffer));
+	// one d3d buffer per stream, stream i goes to input slot i
+	VertexBuffer(Graphics& gfx, const as3dexp::VertexStreams& streams)
+	{
+		for (size_t i = 0u; i < streams.GetStreamCount(); i++)
+		{
+			const auto& stream = streams.GetStream(i);
+			assert("Stream slot does not match its index" && stream.GetLayout().GetSlot() == i);
+			AddStream(gfx, stream.GetData(), stream.SizeBytes(), (UINT)stream.GetLayout().Size());
+		}
+	}
+
+	template<class Layout>
+	VertexBuffer(Graphics& gfx, const as3dexp::StaticVertexBuffer<Layout>& vbuf)
+	{
+		AddStream(gfx, vbuf.GetData(), vbuf.SizeBytes(), (UINT)Layout::Size());
 	}
 
 	void Bind(Graphics& gfx) noexcept override;
+	// binds only the first count streams, e.g. just the positions for a depth only pass
+	void BindStreams(Graphics& gfx, UINT count) noexcept;
+	UINT GetStreamCount() const noexcept;
+
+private:
+	void AddStream(Graphics& gfx, const void* pData, size_t sizeBytes, UINT stride);
 
 protected:
-	UINT stride;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> pVertexBuffer;
-};
\ No newline at end of file
+	std::vector<Microsoft::WRL::ComPtr<ID3D11Buffer>> pVertexBuffers;
+	// raw pointers, strides and offsets laid out the way IASetVertexBuffers takes them
+	std::vector<ID3D11Buffer*> pBindBuffers;
+	std::vector<UINT> strides;
+	std::vector<UINT> offsets;
+	MemoryTracker::GpuAllocation gpuMemory{ MemoryTracker::Subsystem::Geometry };
+};
@@ -0,0 +1,203 @@
+#include "VertexQuantizer.h"
+#include <cmath>
+
+namespace dx = DirectX;
+namespace dxp = DirectX::PackedVector;
+using as3dexp::VertexLayout;
+
+VertexQuantizer::Result VertexQuantizer::Quantize(const as3dexp::VertexBuffer& vbuf)
+{
+	return Quantize(vbuf, Options{});
+}
+
+VertexQuantizer::Result VertexQuantizer::Quantize(const as3dexp::VertexBuffer& vbuf, const Options& options)
+{
+	const auto& srcLayout = vbuf.GetLayout();
+	VertexLayout layout;
+	for (size_t i = 0u; i < srcLayout.GetElementCount(); i++)
+	{
+		layout.Append(QuantizedType(srcLayout.ResolveByIndex(i).GetType(), options));
+	}
+	Result result = { as3dexp::VertexBuffer(std::move(layout)) };
+	auto& dst = result.vertices;
+	const size_t count = vbuf.Size();
+	dst.Resize(count);
+	result.report.vertices = count;
+	result.report.strideBefore = srcLayout.Size();
+	result.report.strideAfter = dst.GetLayout().Size();
+
+	for (size_t e = 0u; e < srcLayout.GetElementCount(); e++)
+	{
+		const auto srcType = srcLayout.ResolveByIndex(e).GetType();
+		const auto dstType = dst.GetLayout().ResolveByIndex(e).GetType();
+		if (srcType == dstType)
+		{
+			dst.CopyAttribute(vbuf, e, e);
+			continue;
+		}
+		switch (dstType)
+		{
+		case VertexLayout::Position3DHalf:
+		{
+			dst.GenerateStream<VertexLayout::Position3DHalf>(count, [&vbuf](size_t i)
+			{
+				const auto& p = vbuf[i].Attr<VertexLayout::Position3D>();
+				return dxp::XMHALF4{ p.x,p.y,p.z,1.0f };
+			});
+			float maxError = 0.0f;
+			for (size_t i = 0u; i < count; i++)
+			{
+				const auto& p = vbuf[i].Attr<VertexLayout::Position3D>();
+				const auto& q = dst[i].Attr<VertexLayout::Position3DHalf>();
+				maxError = std::max({ maxError,
+					std::abs(dxp::XMConvertHalfToFloat(q.x) - p.x),
+					std::abs(dxp::XMConvertHalfToFloat(q.y) - p.y),
+					std::abs(dxp::XMConvertHalfToFloat(q.z) - p.z) });
+			}
+			result.report.maxPositionError = maxError;
+			break;
+		}
+		case VertexLayout::Position3DSnorm16:
+		{
+			// center and half extent of the bounds map the mesh onto [-1,1]
+			dx::XMFLOAT3 lo = { INFINITY,INFINITY,INFINITY };
+			dx::XMFLOAT3 hi = { -INFINITY,-INFINITY,-INFINITY };
+			for (size_t i = 0u; i < count; i++)
+			{
+				const auto& p = vbuf[i].Attr<VertexLayout::Position3D>();
+				lo = { std::min(lo.x,p.x),std::min(lo.y,p.y),std::min(lo.z,p.z) };
+				hi = { std::max(hi.x,p.x),std::max(hi.y,p.y),std::max(hi.z,p.z) };
+			}
+			auto& dq = result.dequantization;
+			if (count != 0u)
+			{
+				// flat axes keep a nonzero scale so the encode does not divide by zero
+				dq.scale = {
+					std::max((hi.x - lo.x) * 0.5f,1e-6f),
+					std::max((hi.y - lo.y) * 0.5f,1e-6f),
+					std::max((hi.z - lo.z) * 0.5f,1e-6f)
+				};
+				dq.offset = { (hi.x + lo.x) * 0.5f,(hi.y + lo.y) * 0.5f,(hi.z + lo.z) * 0.5f };
+			}
+			dst.GenerateStream<VertexLayout::Position3DSnorm16>(count, [&vbuf, dq](size_t i)
+			{
+				const auto& p = vbuf[i].Attr<VertexLayout::Position3D>();
+				return dxp::XMSHORTN4{
+					ToSnorm16((p.x - dq.offset.x) / dq.scale.x),
+					ToSnorm16((p.y - dq.offset.y) / dq.scale.y),
+					ToSnorm16((p.z - dq.offset.z) / dq.scale.z),
+					short(0)
+				};
+			});
+			float maxError = 0.0f;
+			for (size_t i = 0u; i < count; i++)
+			{
+				const auto& p = vbuf[i].Attr<VertexLayout::Position3D>();
+				const auto& q = dst[i].Attr<VertexLayout::Position3DSnorm16>();
+				maxError = std::max({ maxError,
+					std::abs(FromSnorm16(q.x) * dq.scale.x + dq.offset.x - p.x),
+					std::abs(FromSnorm16(q.y) * dq.scale.y + dq.offset.y - p.y),
+					std::abs(FromSnorm16(q.z) * dq.scale.z + dq.offset.z - p.z) });
+			}
+			result.report.maxPositionError = maxError;
+			break;
+		}
+		case VertexLayout::NormalPacked:
+		{
+			dst.GenerateStream<VertexLayout::NormalPacked>(count, [&vbuf](size_t i)
+			{
+				return PackNormal(vbuf[i].Attr<VertexLayout::Normal>());
+			});
+			// angle between the source normal and the renormalized decoded one
+			float minCos = 1.0f;
+			for (size_t i = 0u; i < count; i++)
+			{
+				const auto& n = vbuf[i].Attr<VertexLayout::Normal>();
+				const auto d = UnpackNormal(dst[i].Attr<VertexLayout::NormalPacked>());
+				const float lenN = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+				const float lenD = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+				if (lenN > 0.0f && lenD > 0.0f)
+				{
+					minCos = std::min(minCos, (n.x * d.x + n.y * d.y + n.z * d.z) / (lenN * lenD));
+				}
+			}
+			result.report.maxNormalErrorDegrees = std::acos(std::clamp(minCos, -1.0f, 1.0f)) * 57.29578f;
+			break;
+		}
+		case VertexLayout::Texture2DHalf:
+		{
+			dst.GenerateStream<VertexLayout::Texture2DHalf>(count, [&vbuf](size_t i)
+			{
+				const auto& tc = vbuf[i].Attr<VertexLayout::Texture2D>();
+				return dxp::XMHALF2{ tc.x,tc.y };
+			});
+			float maxError = 0.0f;
+			for (size_t i = 0u; i < count; i++)
+			{
+				const auto& tc = vbuf[i].Attr<VertexLayout::Texture2D>();
+				const auto& q = dst[i].Attr<VertexLayout::Texture2DHalf>();
+				maxError = std::max({ maxError,
+					std::abs(dxp::XMConvertHalfToFloat(q.x) - tc.x),
+					std::abs(dxp::XMConvertHalfToFloat(q.y) - tc.y) });
+			}
+			result.report.maxTexcoordError = maxError;
+			break;
+		}
+		default:
+			assert("Element type has no quantized form" && false);
+		}
+	}
+	return result;
+}
+
+VertexLayout::ElementType VertexQuantizer::QuantizedType(VertexLayout::ElementType type, const Options& options) noexcept
+{
+	switch (type)
+	{
+	case VertexLayout::Position3D:
+		switch (options.position)
+		{
+		case PositionFormat::Half:
+			return VertexLayout::Position3DHalf;
+		case PositionFormat::Snorm16:
+			return VertexLayout::Position3DSnorm16;
+		default:
+			return type;
+		}
+	case VertexLayout::Normal:
+		return options.packNormals ? VertexLayout::NormalPacked : type;
+	case VertexLayout::Texture2D:
+		return options.halfTexcoords ? VertexLayout::Texture2DHalf : type;
+	default:
+		return type;
+	}
+}
+
+short VertexQuantizer::ToSnorm16(float v) noexcept
+{
+	return short(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+}
+
+float VertexQuantizer::FromSnorm16(short v) noexcept
+{
+	// -32768 and -32767 both decode to -1
+	return std::max(float(v) / 32767.0f, -1.0f);
+}
+
+dxp::XMUDECN4 VertexQuantizer::PackNormal(const dx::XMFLOAT3& n) noexcept
+{
+	const auto unorm10 = [](float v)
+	{
+		return uint32_t(std::lround(std::clamp(v * 0.5f + 0.5f, 0.0f, 1.0f) * 1023.0f));
+	};
+	return dxp::XMUDECN4{ unorm10(n.x) | (unorm10(n.y) << 10u) | (unorm10(n.z) << 20u) };
+}
+
+dx::XMFLOAT3 VertexQuantizer::UnpackNormal(const dxp::XMUDECN4& n) noexcept
+{
+	const auto snorm = [&n](uint32_t shift)
+	{
+		return float((n.v >> shift) & 0x3FFu) / 1023.0f * 2.0f - 1.0f;
+	};
+	return { snorm(0u),snorm(10u),snorm(20u) };
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Vertex.h"
+
+// converts a float vertex buffer to the packed element types and reports what the packing cost
+// positions go to half or to snorm16 relative to the mesh bounds, normals to 10:10:10:2, texcoords to half
+// elements without a packed form are copied as they are
+class VertexQuantizer
+{
+public:
+	enum class PositionFormat
+	{
+		Float,
+		Half,
+		Snorm16,
+	};
+	struct Options
+	{
+		PositionFormat position = PositionFormat::Snorm16;
+		bool packNormals = true;
+		bool halfTexcoords = true;
+	};
+	// vertex constant buffer layout for Phong.hlsl, position = stored * scale + offset
+	struct Dequantization
+	{
+		DirectX::XMFLOAT3 scale = { 1.0f,1.0f,1.0f };
+		float padding0 = 0.0f;
+		DirectX::XMFLOAT3 offset = { 0.0f,0.0f,0.0f };
+		float padding1 = 0.0f;
+	};
+	// errors are the worst case over all vertices, measured by decoding the packed values again
+	struct Report
+	{
+		size_t vertices = 0u;
+		size_t strideBefore = 0u;
+		size_t strideAfter = 0u;
+		// largest per-component position error in model units
+		float maxPositionError = 0.0f;
+		float maxNormalErrorDegrees = 0.0f;
+		float maxTexcoordError = 0.0f;
+	};
+	struct Result
+	{
+		as3dexp::VertexBuffer vertices;
+		Dequantization dequantization;
+		Report report;
+	};
+public:
+	static Result Quantize(const as3dexp::VertexBuffer& vbuf);
+	static Result Quantize(const as3dexp::VertexBuffer& vbuf, const Options& options);
+	static as3dexp::VertexLayout::ElementType QuantizedType(as3dexp::VertexLayout::ElementType type, const Options& options) noexcept;
+	// scalar codecs, decoding follows the d3d conversion rules the input assembler applies
+	static short ToSnorm16(float v) noexcept;
+	static float FromSnorm16(short v) noexcept;
+	static DirectX::PackedVector::XMUDECN4 PackNormal(const DirectX::XMFLOAT3& n) noexcept;
+	static DirectX::XMFLOAT3 UnpackNormal(const DirectX::PackedVector::XMUDECN4& n) noexcept;
+};
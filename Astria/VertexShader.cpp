@@ -1,5 +1,6 @@
 #include "VertexShader.h"
 #include "GraphicsThrowMacros.h"
+#include "Codex.h"
 #include <d3dcompiler.h>
 
 #pragma comment(lib, "D3DCompiler.lib")
@@ -10,6 +11,18 @@ VertexShader::VertexShader(Graphics& gfx, const std::wstring& path)
 
 	GFX_THROW_INFO(D3DReadFileToBlob(path.c_str(), &pBytecodeBlob));
 	GFX_THROW_INFO(GetDevice(gfx)->CreateVertexShader(pBytecodeBlob->GetBufferPointer(), pBytecodeBlob->GetBufferSize(), nullptr, pVertexShader.GetAddressOf()));
+
+	WatchSource(gfx, ShaderManager::SourceFromObject(path), {});
+}
+
+VertexShader::VertexShader(Graphics& gfx, const std::wstring& sourcePath, const std::vector<ShaderManager::Define>& defines)
+{
+	INFOMAN(gfx);
+
+	pBytecodeBlob = gfx.GetShaderManager().Compile(sourcePath, ShaderManager::Stage::Vertex, defines);
+	GFX_THROW_INFO(GetDevice(gfx)->CreateVertexShader(pBytecodeBlob->GetBufferPointer(), pBytecodeBlob->GetBufferSize(), nullptr, pVertexShader.GetAddressOf()));
+
+	WatchSource(gfx, sourcePath, defines);
 }
 
 void VertexShader::Bind(Graphics& gfx) noexcept
@@ -21,3 +34,30 @@ ID3DBlob* VertexShader::GetBytecode() const noexcept
 {
     return pBytecodeBlob.Get();
 }
+
+std::string VertexShader::GenerateUID(const std::wstring& path)
+{
+	return Codex::Narrow(path);
+}
+
+std::string VertexShader::GenerateUID(const std::wstring& sourcePath, const std::vector<ShaderManager::Define>& defines)
+{
+	return Codex::Narrow(sourcePath) + "|" + ShaderManager::DefinesString(defines);
+}
+
+void VertexShader::WatchSource(Graphics& gfx, std::wstring sourcePath, std::vector<ShaderManager::Define> defines)
+{
+	gpuMemory.Set(pBytecodeBlob->GetBufferSize());
+	pWatch = gfx.GetShaderManager().WatchSource(std::move(sourcePath), ShaderManager::Stage::Vertex, std::move(defines),
+		[this](Graphics& gfx, ID3DBlob* pBlob)
+		{
+			INFOMAN(gfx);
+
+			Microsoft::WRL::ComPtr<ID3D11VertexShader> pNewShader;
+			GFX_THROW_INFO(GetDevice(gfx)->CreateVertexShader(pBlob->GetBufferPointer(), pBlob->GetBufferSize(), nullptr, &pNewShader));
+			pVertexShader = std::move(pNewShader);
+			pBytecodeBlob = pBlob;
+			gpuMemory.Set(pBytecodeBlob->GetBufferSize());
+		}
+	);
+}
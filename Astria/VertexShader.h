@@ -1,13 +1,24 @@
 #pragma once
 #include "Bindable.h"
+#include "MemoryTracker.h"
 
 class VertexShader : public Bindable
 {
 public:
 	VertexShader(Graphics& gfx, const std::wstring& path);
+	// compiles an hlsl source with defines through the shader manager's bytecode cache
+	VertexShader(Graphics& gfx, const std::wstring& sourcePath, const std::vector<ShaderManager::Define>& defines);
 	void Bind(Graphics& gfx) noexcept override;
 	ID3DBlob* GetBytecode() const noexcept;
+	static std::string GenerateUID(const std::wstring& path);
+	static std::string GenerateUID(const std::wstring& sourcePath, const std::vector<ShaderManager::Define>& defines);
+private:
+	void WatchSource(Graphics& gfx, std::wstring sourcePath, std::vector<ShaderManager::Define> defines);
 protected:
+	// recompiles must keep the input signature, layouts were validated against the original
+	std::shared_ptr<ShaderManager::Watch> pWatch;
 	Microsoft::WRL::ComPtr<ID3DBlob> pBytecodeBlob;
 	Microsoft::WRL::ComPtr<ID3D11VertexShader> pVertexShader;
+	// the driver keeps its own copy of the bytecode, about as large
+	MemoryTracker::GpuAllocation gpuMemory{ MemoryTracker::Subsystem::Shaders };
 };
\ No newline at end of file
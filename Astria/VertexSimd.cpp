@@ -0,0 +1,153 @@
+#include "VertexSimd.h"
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+// msvc emits avx2 intrinsics without /arch, gcc/clang need the function to opt in
+#if defined(_MSC_VER)
+#define VERTEX_SIMD_AVX2
+#else
+#define VERTEX_SIMD_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+	float* Attribute(void* pFirst, size_t stride, size_t i) noexcept
+	{
+		return reinterpret_cast<float*>(static_cast<char*>(pFirst) + i * stride);
+	}
+
+	// ---------------------------------------------------------------- scalar reference
+	void TransformScalar(void* pFirst, size_t stride, size_t count, const DirectX::XMFLOAT4X4& m, bool normals) noexcept
+	{
+		const float w = normals ? 0.0f : 1.0f;
+		for (size_t i = 0; i < count; i++)
+		{
+			float* p = Attribute(pFirst, stride, i);
+			const float x = p[0] * m._11 + p[1] * m._21 + p[2] * m._31 + w * m._41;
+			const float y = p[0] * m._12 + p[1] * m._22 + p[2] * m._32 + w * m._42;
+			const float z = p[0] * m._13 + p[1] * m._23 + p[2] * m._33 + w * m._43;
+			const float lengthSq = x * x + y * y + z * z;
+			const float scale = !normals ? 1.0f : lengthSq > 0.0f ? 1.0f / std::sqrt(lengthSq) : 0.0f;
+			p[0] = x * scale;
+			p[1] = y * scale;
+			p[2] = z * scale;
+		}
+	}
+
+	// ---------------------------------------------------------------- sse2 (DirectXMath per vertex)
+	void TransformSSE2(void* pFirst, size_t stride, size_t count, const DirectX::XMFLOAT4X4& matrix, bool normals) noexcept
+	{
+		using namespace DirectX;
+		const XMMATRIX m = XMLoadFloat4x4(&matrix);
+		for (size_t i = 0; i < count; i++)
+		{
+			auto p = reinterpret_cast<XMFLOAT3*>(Attribute(pFirst, stride, i));
+			const XMVECTOR v = XMLoadFloat3(p);
+			XMStoreFloat3(p, normals ? XMVector3Normalize(XMVector3TransformNormal(v, m)) : XMVector3Transform(v, m));
+		}
+	}
+
+	// ---------------------------------------------------------------- avx2
+	VERTEX_SIMD_AVX2 void TransformAVX2(void* pFirst, size_t stride, size_t count, const DirectX::XMFLOAT4X4& m, bool normals) noexcept
+	{
+		// the masked loads and stores touch exactly the 12 bytes of the attribute, whatever follows it in the vertex
+		const __m128i xyz = _mm_set_epi32(0, -1, -1, -1);
+		const __m256 m11 = _mm256_set1_ps(m._11), m12 = _mm256_set1_ps(m._12), m13 = _mm256_set1_ps(m._13);
+		const __m256 m21 = _mm256_set1_ps(m._21), m22 = _mm256_set1_ps(m._22), m23 = _mm256_set1_ps(m._23);
+		const __m256 m31 = _mm256_set1_ps(m._31), m32 = _mm256_set1_ps(m._32), m33 = _mm256_set1_ps(m._33);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 m41 = normals ? zero : _mm256_set1_ps(m._41);
+		const __m256 m42 = normals ? zero : _mm256_set1_ps(m._42);
+		const __m256 m43 = normals ? zero : _mm256_set1_ps(m._43);
+		const __m256 one = _mm256_set1_ps(1.0f);
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			// vertex k goes to the low lane, vertex k + 4 to the high lane of row k
+			__m256 r[4];
+			for (size_t k = 0; k < 4; k++)
+			{
+				const __m128 lo = _mm_maskload_ps(Attribute(pFirst, stride, i + k), xyz);
+				const __m128 hi = _mm_maskload_ps(Attribute(pFirst, stride, i + k + 4), xyz);
+				r[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+			}
+			// 4x4 transpose per lane into x0..x3|x4..x7 and so on, w is zero
+			const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+			const __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+			const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+			const __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+			const __m256 x = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+			const __m256 y = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+			const __m256 z = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+
+			__m256 ox = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m11), _mm256_mul_ps(y, m21)), _mm256_add_ps(_mm256_mul_ps(z, m31), m41));
+			__m256 oy = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m12), _mm256_mul_ps(y, m22)), _mm256_add_ps(_mm256_mul_ps(z, m32), m42));
+			__m256 oz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m13), _mm256_mul_ps(y, m23)), _mm256_add_ps(_mm256_mul_ps(z, m33), m43));
+			if (normals)
+			{
+				const __m256 lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ox, ox), _mm256_mul_ps(oy, oy)), _mm256_mul_ps(oz, oz));
+				// zero length normals stay zero like XMVector3Normalize leaves them
+				const __m256 scale = _mm256_and_ps(_mm256_div_ps(one, _mm256_sqrt_ps(lengthSq)), _mm256_cmp_ps(lengthSq, zero, _CMP_GT_OQ));
+				ox = _mm256_mul_ps(ox, scale);
+				oy = _mm256_mul_ps(oy, scale);
+				oz = _mm256_mul_ps(oz, scale);
+			}
+
+			// transpose back into one xyz0 row per vertex
+			const __m256 u0 = _mm256_unpacklo_ps(ox, oy);
+			const __m256 u1 = _mm256_unpackhi_ps(ox, oy);
+			const __m256 u2 = _mm256_unpacklo_ps(oz, zero);
+			const __m256 u3 = _mm256_unpackhi_ps(oz, zero);
+			r[0] = _mm256_shuffle_ps(u0, u2, _MM_SHUFFLE(1, 0, 1, 0));
+			r[1] = _mm256_shuffle_ps(u0, u2, _MM_SHUFFLE(3, 2, 3, 2));
+			r[2] = _mm256_shuffle_ps(u1, u3, _MM_SHUFFLE(1, 0, 1, 0));
+			r[3] = _mm256_shuffle_ps(u1, u3, _MM_SHUFFLE(3, 2, 3, 2));
+			for (size_t k = 0; k < 4; k++)
+			{
+				_mm_maskstore_ps(Attribute(pFirst, stride, i + k), xyz, _mm256_castps256_ps128(r[k]));
+				_mm_maskstore_ps(Attribute(pFirst, stride, i + k + 4), xyz, _mm256_extractf128_ps(r[k], 1));
+			}
+		}
+		TransformSSE2(Attribute(pFirst, stride, i), stride, count - i, m, normals);
+	}
+
+	void Transform(void* pFirst, size_t stride, size_t count, const DirectX::XMFLOAT4X4& matrix, bool normals) noexcept
+	{
+		switch (VertexSimd::GetPath())
+		{
+		case VertexSimd::Path::AVX2:
+			TransformAVX2(pFirst, stride, count, matrix, normals);
+			break;
+		case VertexSimd::Path::SSE2:
+			TransformSSE2(pFirst, stride, count, matrix, normals);
+			break;
+		default:
+			TransformScalar(pFirst, stride, count, matrix, normals);
+			break;
+		}
+	}
+}
+
+VertexSimd::Path VertexSimd::path = SurfaceSimd::GetBestSupportedPath();
+
+VertexSimd::Path VertexSimd::GetPath() noexcept
+{
+	return path;
+}
+
+void VertexSimd::SetPath(Path path_in) noexcept
+{
+	path = std::min(path_in, SurfaceSimd::GetBestSupportedPath());
+}
+
+void VertexSimd::TransformPoints(void* pFirst, size_t stride, size_t count, const DirectX::XMFLOAT4X4& matrix) noexcept
+{
+	Transform(pFirst, stride, count, matrix, false);
+}
+
+void VertexSimd::TransformNormals(void* pFirst, size_t stride, size_t count, const DirectX::XMFLOAT4X4& matrix) noexcept
+{
+	Transform(pFirst, stride, count, matrix, true);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "SurfaceSimd.h"
+#include <DirectXMath.h>
+#include <cstddef>
+
+// batched transforms of a float3 attribute embedded in an array of vertices
+// pFirst points at the attribute of the first vertex, stride is the vertex size in bytes, data is modified in place
+// the AVX2 path transposes blocks of 8 vertices into x/y/z registers, transforms them and scatters the results back
+class VertexSimd
+{
+public:
+	// same cpu probe and path ordering as the Surface kernels
+	using Path = SurfaceSimd::Path;
+public:
+	static Path GetPath() noexcept;
+	static void SetPath(Path path) noexcept;
+
+	// p' = (p, 1) * matrix, w is dropped like XMVector3Transform does
+	static void TransformPoints(void* pFirst, size_t stride, size_t count, const DirectX::XMFLOAT4X4& matrix) noexcept;
+	// n' = normalize((n, 0) * matrix), pass the inverse-transpose of the point transform
+	static void TransformNormals(void* pFirst, size_t stride, size_t count, const DirectX::XMFLOAT4X4& matrix) noexcept;
+private:
+	static Path path;
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include "FrameAllocator.h"
+#include "Profiler.h"
+#include <DirectXMath.h>
+
+// vertex formats the geometry generators are instantiated with, as the drawables declare them
+struct PositionVertex
+{
+	DirectX::XMFLOAT3 pos;
+};
+struct NormalVertex
+{
+	DirectX::XMFLOAT3 pos;
+	DirectX::XMFLOAT3 n;
+};
+struct TexturedVertex
+{
+	DirectX::XMFLOAT3 pos;
+	DirectX::XMFLOAT3 n;
+	DirectX::XMFLOAT2 tc;
+};
+
+// the cpu side of Graphics::BeginFrame, run once per iteration by benchmarks of code that takes frame scratch
+// memory or opens profiler zones, so the scratch arenas get reclaimed and the zone buffers stay one frame long
+inline void AdvanceFrame() noexcept
+{
+	FrameAllocator::NextFrame();
+	Profiler::NextFrame();
+}
@@ -0,0 +1,109 @@
+#include "BenchmarkCommon.h"
+#include "BindableSet.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+namespace
+{
+	// bindables that bind nothing, so drawable bookkeeping can be measured without a device
+	// the sizes are those of a per instance constant buffer, a transform cbuf and a topology
+	template<size_t Size>
+	class Probe : public Bindable
+	{
+	public:
+		void Bind(Graphics&) noexcept override
+		{}
+	private:
+		char payload[Size] = {};
+	};
+	using Cbuf = Probe<48>;
+	using Transform = Probe<64>;
+	using Topo = Probe<16>;
+
+	// the bindables of one drawable, as Drawable::AddBind stores them, the topology is shared like a static bind
+	BindableSet MakeSet()
+	{
+		static const auto pTopo = std::make_shared<Topo>();
+		BindableSet set;
+		set.Add(pTopo);
+		set.Add(std::shared_ptr<Cbuf>(new Cbuf));
+		set.Add(std::shared_ptr<Transform>(new Transform));
+		return set;
+	}
+
+	// the lookup BindableSet replaced, a scan over the bindables
+	template<class T>
+	T* Scan(const std::vector<std::shared_ptr<Bindable>>& binds) noexcept
+	{
+		for (const auto& pb : binds)
+		{
+			if (const auto pt = dynamic_cast<T*>(pb.get()))
+			{
+				return pt;
+			}
+		}
+		return nullptr;
+	}
+}
+
+// per frame lookups over a drawable population, the last added bindable is the worst case of the scan
+static void BM_BindableSetGet(benchmark::State& state)
+{
+	std::vector<BindableSet> drawables;
+	drawables.reserve(size_t(state.range(0)));
+	for (int64_t i = 0; i < state.range(0); i++)
+	{
+		drawables.push_back(MakeSet());
+	}
+	for (auto _ : state)
+	{
+		for (const auto& set : drawables)
+		{
+			benchmark::DoNotOptimize(set.Get<Transform>());
+		}
+		AdvanceFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BindableSetGet)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_BindableScan(benchmark::State& state)
+{
+	std::vector<std::vector<std::shared_ptr<Bindable>>> drawables(size_t(state.range(0)));
+	const auto pTopo = std::make_shared<Topo>();
+	for (auto& binds : drawables)
+	{
+		binds.push_back(pTopo);
+		binds.push_back(std::shared_ptr<Cbuf>(new Cbuf));
+		binds.push_back(std::shared_ptr<Transform>(new Transform));
+	}
+	for (auto _ : state)
+	{
+		for (const auto& binds : drawables)
+		{
+			benchmark::DoNotOptimize(Scan<Transform>(binds));
+		}
+		AdvanceFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BindableScan)->RangeMultiplier(10)->Range(1000, 100000);
+
+// what spawning and tearing down drawables costs on the bindable side, the per instance bindables come from pools
+static void BM_BindableSpawnTeardown(benchmark::State& state)
+{
+	std::vector<BindableSet> drawables;
+	drawables.reserve(size_t(state.range(0)));
+	for (auto _ : state)
+	{
+		for (int64_t i = 0; i < state.range(0); i++)
+		{
+			drawables.push_back(MakeSet());
+		}
+		drawables.clear();
+		AdvanceFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BindableSpawnTeardown)->RangeMultiplier(10)->Range(1000, 100000);
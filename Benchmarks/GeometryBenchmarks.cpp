@@ -0,0 +1,564 @@
+#include "BenchmarkCommon.h"
+#include "AstriaMath.h"
+#include "ConeVertices.h"
+#include "Cube.h"
+#include "CylinderVertices.h"
+#include "IndexedTriangleList.h"
+#include "MeshWelder.h"
+#include "MeshletBuilder.h"
+#include "Plane.h"
+#include "SphereVertices.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace dx = DirectX;
+
+namespace
+{
+	// the generators as they were before the closed form rewrite, two rotation matrices per vertex and
+	// unreserved vectors, kept so the current ones can be measured against them
+	namespace Reference
+	{
+		std::vector<unsigned short> SphereIndices(int longDiv, int latDiv, unsigned short ilCenter, unsigned short iuCenter)
+		{
+			// l tip indices
+			std::vector<unsigned short> indices;
+			for (unsigned short iLong = 0; iLong < longDiv; iLong++)
+			{
+				indices.push_back(ilCenter);
+				indices.push_back((iLong + 1) % longDiv);
+				indices.push_back(iLong);
+			}
+
+			unsigned short end = longDiv * (latDiv - 2);
+			unsigned short n = 0;
+
+			// sphere indices
+			for (unsigned short iLong = 0; iLong < end; iLong++)
+			{
+				if (iLong != 0 && iLong % longDiv == 0) {
+					n += 1;
+				}
+
+				unsigned short factor = n * longDiv;
+
+				indices.push_back(iLong);
+				indices.push_back(((iLong + 1) % longDiv) + factor);
+				indices.push_back(iLong + longDiv);
+
+				indices.push_back(((iLong + 1) % longDiv) + factor);
+				indices.push_back(((iLong + 1) % longDiv) + longDiv + factor);
+				indices.push_back(iLong + longDiv);
+			}
+
+			// u tip indices
+			for (unsigned short iLong = end; iLong < longDiv + end; iLong++)
+			{
+				indices.push_back(iuCenter);
+				indices.push_back(iLong);
+				indices.push_back(((iLong + 1) % longDiv) + end);
+			}
+			return indices;
+		}
+
+		template<class V>
+		IndexedTriangleList<V> SphereTesselated(int longDiv, int latDiv)
+		{
+			const float longitudeAngle = 2.0f * PI / longDiv;
+			const float latitudeAngle = PI / latDiv;
+
+			auto base = dx::XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f);
+
+			std::vector<V> vertices;
+
+			for (int iLat = 1; iLat < latDiv; iLat++) {
+
+				base = dx::XMVector3Transform(base, dx::XMMatrixRotationY(latitudeAngle));
+
+				for (int iLong = 0; iLong < longDiv; iLong++)
+				{
+					vertices.emplace_back();
+					auto v = dx::XMVector3Transform(
+						base,
+						dx::XMMatrixRotationZ(longitudeAngle * iLong)
+					);
+					dx::XMStoreFloat3(&vertices.back().pos, v);
+				}
+			}
+
+			// the l tip
+			vertices.emplace_back();
+			vertices.back().pos = { 0.0f, 0.0f, -1.0f };
+			const auto ilCenter = (unsigned short)(vertices.size() - 1);
+
+			// the u tip
+			vertices.emplace_back();
+			vertices.back().pos = { 0.0f,0.0f, 1.0f };
+			const auto iuCenter = (unsigned short)(vertices.size() - 1);
+
+			return { std::move(vertices),SphereIndices(longDiv, latDiv, ilCenter, iuCenter) };
+		}
+
+		template<class V>
+		IndexedTriangleList<V> SphereTesselatedIndependentTextureCapNormals(int longDiv, int latDiv)
+		{
+			const float longitudeAngle = 2.0f * PI / longDiv;
+			const float latitudeAngle = PI / latDiv;
+
+			auto base = dx::XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f);
+
+			const auto txc_center = dx::XMVectorSet(0.5f, 0.5f, 0.0f, 0.0f);
+			const auto txc_base = dx::XMVectorSet(1, 0.5f, 0.0f, 0.0f);
+
+			std::vector<V> vertices;
+
+			// ring around the l tip and ring around the u tip, texture coordinates laid out as discs
+			const auto capRing = [&]()
+			{
+				base = dx::XMVector3Transform(base, dx::XMMatrixRotationY(latitudeAngle));
+
+				for (int iLong = 0; iLong < longDiv; iLong++)
+				{
+					vertices.emplace_back();
+					auto v = dx::XMVector3Transform(
+						base,
+						dx::XMMatrixRotationZ(longitudeAngle * iLong)
+					);
+					dx::XMStoreFloat3(&vertices.back().pos, v);
+
+					vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,vertices.back().pos.z };
+
+					auto t = dx::XMVectorAdd(
+						dx::XMVector2Transform(dx::XMVectorSubtract(txc_base, txc_center), dx::XMMatrixRotationZ(longitudeAngle * iLong)),
+						txc_center);
+
+					dx::XMStoreFloat2(&vertices.back().tc, t);
+				}
+			};
+
+			capRing();
+
+			for (int iLat = 2; iLat < latDiv - 1; iLat++) {
+
+				base = dx::XMVector3Transform(base, dx::XMMatrixRotationY(latitudeAngle));
+
+				for (int iLong = 0; iLong < longDiv; iLong++)
+				{
+					vertices.emplace_back();
+					auto v = dx::XMVector3Transform(
+						base,
+						dx::XMMatrixRotationZ(longitudeAngle * iLong)
+					);
+					dx::XMStoreFloat3(&vertices.back().pos, v);
+					vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,vertices.back().pos.z };
+					vertices.back().tc = { iLong / (longDiv * 1.0f), iLat / (longDiv * 1.0f) };
+				}
+			}
+
+			capRing();
+
+			// the l tip
+			vertices.emplace_back();
+			vertices.back().pos = { 0.0f, 0.0f, -1.0f };
+			vertices.back().n = { 0.0f,0.0f, -1.0f };
+			vertices.back().tc = { 0.5f, 0.5f };
+			const auto ilCenter = (unsigned short)(vertices.size() - 1);
+
+			// the u tip
+			vertices.emplace_back();
+			vertices.back().pos = { 0.0f,0.0f, 1.0f };
+			vertices.back().n = { 0.0f,0.0f, 1.0f };
+			vertices.back().tc = { 0.5f, 0.5f };
+			const auto iuCenter = (unsigned short)(vertices.size() - 1);
+
+			return { std::move(vertices),SphereIndices(longDiv, latDiv, ilCenter, iuCenter) };
+		}
+
+		template<class V>
+		IndexedTriangleList<V> CylinderTesselatedIndependentCapNormals(int longDiv, int latDiv)
+		{
+			const auto l_base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
+			const auto u_base = dx::XMVectorSet(1.0f, 0.0f, 1.0f, 0.0f);
+
+			const float longitudeAngle = 2.0f * PI / longDiv;
+
+			// l_base vertices
+			std::vector<V> vertices;
+			for (int iLong = 0; iLong < longDiv; iLong++)
+			{
+				vertices.emplace_back();
+				auto v = dx::XMVector3Transform(
+					l_base,
+					dx::XMMatrixRotationZ(longitudeAngle * iLong)
+				);
+				dx::XMStoreFloat3(&vertices.back().pos, v);
+				vertices.back().n = { 0.0f,0.0f,-1.0f };
+			}
+
+			// center rings
+			auto base = l_base;
+
+			for (int iLat = 0; iLat < latDiv - 2; iLat++) {
+				base = dx::XMVector3Transform(base, dx::XMMatrixTranslation(0.0f, 0.0f, 2.0f / (latDiv - 1)));
+				for (int iLong = 0; iLong < longDiv; iLong++) {
+					vertices.emplace_back();
+					auto v = dx::XMVector3Transform(
+						base,
+						dx::XMMatrixRotationZ(longitudeAngle * iLong)
+					);
+					dx::XMStoreFloat3(&vertices.back().pos, v);
+					vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,0.0f };
+				}
+			}
+
+			// u_base vertices
+			for (int iLong = 0; iLong < longDiv; iLong++)
+			{
+				vertices.emplace_back();
+				auto v = dx::XMVector3Transform(
+					u_base,
+					dx::XMMatrixRotationZ(longitudeAngle * iLong)
+				);
+				dx::XMStoreFloat3(&vertices.back().pos, v);
+				vertices.back().n = { 0.0f,0.0f, 1.0f };
+			}
+
+			// the l center
+			vertices.emplace_back();
+			vertices.back().pos = { 0.0f,0.0f,-1.0f };
+			vertices.back().n = { 0.0f,0.0f,-1.0f };
+			const auto ilCenter = (unsigned short)(vertices.size() - 1);
+
+			// the u center
+			vertices.emplace_back();
+			vertices.back().pos = { 0.0f,0.0f,1.0f };
+			vertices.back().n = { 0.0f,0.0f,1.0f };
+			const auto iuCenter = (unsigned short)(vertices.size() - 1);
+
+			// l base indices
+			std::vector<unsigned short> indices;
+			for (unsigned short iLong = 0; iLong < longDiv; iLong++)
+			{
+				indices.push_back(ilCenter);
+				indices.push_back((iLong + 1) % longDiv);
+				indices.push_back(iLong);
+			}
+
+			unsigned short end = longDiv + (latDiv - 2) * longDiv;
+
+			unsigned short n = 0;
+
+			// cylinder indices
+			for (unsigned short iLong = 0; iLong < end; iLong++)
+			{
+				if (iLong != 0 && iLong % longDiv == 0) {
+					n += 1;
+				}
+
+				unsigned short factor = n * longDiv;
+
+				indices.push_back(iLong);
+				indices.push_back(((iLong + 1) % longDiv) + factor);
+				indices.push_back(iLong + longDiv);
+
+				indices.push_back(((iLong + 1) % longDiv) + factor);
+				indices.push_back(((iLong + 1) % longDiv) + longDiv + factor);
+				indices.push_back(iLong + longDiv);
+			}
+
+			// u base indices
+			for (unsigned short iLong = end; iLong < longDiv + end; iLong++)
+			{
+				indices.push_back(iuCenter);
+				indices.push_back(iLong);
+				indices.push_back(((iLong + 1) % longDiv) + end);
+			}
+
+			return { std::move(vertices),std::move(indices) };
+		}
+
+		template<class V>
+		IndexedTriangleList<V> ConeTesselatedIndependentFaces(int longDiv)
+		{
+			const auto base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
+			const float longitudeAngle = 2.0f * PI / longDiv;
+
+			// base vertices
+			std::vector<V> vertices;
+			for (int iLong = 0; iLong < longDiv; iLong++)
+			{
+				vertices.emplace_back();
+				auto v = dx::XMVector3Transform(
+					base,
+					dx::XMMatrixRotationZ(longitudeAngle * iLong)
+				);
+				dx::XMStoreFloat3(&vertices.back().pos, v);
+				vertices.back().n = { 0.0f,0.0f,-1.0f };
+			}
+
+			// duplicate base for outwards normals
+			const auto iBase2 = (unsigned short)(vertices.size());
+			for (int iLong = 0; iLong < longDiv; iLong++)
+			{
+				vertices.emplace_back();
+				auto v = dx::XMVector3Transform(
+					base,
+					dx::XMMatrixRotationZ(longitudeAngle * iLong)
+				);
+				dx::XMStoreFloat3(&vertices.back().pos, v);
+				vertices.back().n = { vertices.back().pos.x,vertices.back().pos.y,0.0f };
+			}
+
+			// the center
+			vertices.emplace_back();
+			vertices.back().pos = { 0.0f,0.0f,-1.0f };
+			vertices.back().n = { 0.0f,0.0f,-1.0f };
+			const auto iCenter = (unsigned short)(vertices.size() - 1);
+			// the tip
+			vertices.emplace_back();
+			vertices.back().pos = { 0.0f,0.0f,1.0f };
+			vertices.back().n = { 0.0f,0.0f,1.0f };
+			const auto iTip = (unsigned short)(vertices.size() - 1);
+
+			// base indices
+			std::vector<unsigned short> indices;
+			for (unsigned short iLong = 0; iLong < longDiv; iLong++)
+			{
+				indices.push_back(iCenter);
+				indices.push_back((iLong + 1) % longDiv);
+				indices.push_back(iLong);
+			}
+
+			// cone indices
+			for (unsigned short iLong = iBase2; iLong < longDiv + iBase2; iLong++)
+			{
+				indices.push_back(iLong);
+				indices.push_back(((iLong + 1) % longDiv) + iBase2);
+				indices.push_back(iTip);
+			}
+
+			return { std::move(vertices),std::move(indices) };
+		}
+	}
+}
+
+// generators, the argument is the number of divisions around (and along) the shape
+// reference:1 runs the generator the closed form one replaced, on the same arguments
+static void BM_SphereMake(benchmark::State& state)
+{
+	const auto divisions = int(state.range(0));
+	const bool reference = state.range(1) != 0;
+	for (auto _ : state)
+	{
+		auto sphere = reference ?
+			Reference::SphereTesselated<NormalVertex>(divisions, divisions) :
+			SphereVertices::MakeTesselated<NormalVertex>(divisions, divisions);
+		benchmark::DoNotOptimize(sphere.vertices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * SphereVertices::TesselatedVertexCount(divisions, divisions));
+}
+BENCHMARK(BM_SphereMake)->ArgsProduct({ { 12,24,96,180 },{ 0,1 } })->ArgNames({ "divisions","reference" });
+
+static void BM_SphereTexturedMake(benchmark::State& state)
+{
+	const auto divisions = int(state.range(0));
+	const bool reference = state.range(1) != 0;
+	for (auto _ : state)
+	{
+		auto sphere = reference ?
+			Reference::SphereTesselatedIndependentTextureCapNormals<TexturedVertex>(divisions, divisions) :
+			SphereVertices::MakeTesselatedIndependentTextureCapNormals<TexturedVertex>(divisions, divisions);
+		benchmark::DoNotOptimize(sphere.vertices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * SphereVertices::TesselatedVertexCount(divisions, divisions));
+}
+BENCHMARK(BM_SphereTexturedMake)->ArgsProduct({ { 12,24,96,180 },{ 0,1 } })->ArgNames({ "divisions","reference" });
+
+// into storage that is reused, the generator alone without the allocations
+static void BM_SphereFill(benchmark::State& state)
+{
+	const auto divisions = int(state.range(0));
+	std::vector<TexturedVertex> vertices(SphereVertices::TesselatedVertexCount(divisions, divisions));
+	std::vector<unsigned short> indices(SphereVertices::TesselatedIndexCount(divisions, divisions));
+	for (auto _ : state)
+	{
+		SphereVertices::FillTesselatedIndependentTextureCapNormals<TexturedVertex>(divisions, divisions, vertices, indices);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * vertices.size());
+}
+BENCHMARK(BM_SphereFill)->Arg(12)->Arg(24)->Arg(96)->Arg(180);
+
+static void BM_CylinderMake(benchmark::State& state)
+{
+	const auto divisions = int(state.range(0));
+	const bool reference = state.range(1) != 0;
+	for (auto _ : state)
+	{
+		auto cylinder = reference ?
+			Reference::CylinderTesselatedIndependentCapNormals<NormalVertex>(divisions, divisions) :
+			CylinderVertices::MakeTesselatedIndependentCapNormals<NormalVertex>(divisions, divisions);
+		benchmark::DoNotOptimize(cylinder.vertices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * CylinderVertices::TesselatedVertexCount(divisions, divisions));
+}
+BENCHMARK(BM_CylinderMake)->ArgsProduct({ { 12,24,96,180 },{ 0,1 } })->ArgNames({ "divisions","reference" });
+
+static void BM_ConeMake(benchmark::State& state)
+{
+	const auto divisions = int(state.range(0));
+	const bool reference = state.range(1) != 0;
+	for (auto _ : state)
+	{
+		auto cone = reference ?
+			Reference::ConeTesselatedIndependentFaces<NormalVertex>(divisions) :
+			ConeVertices::MakeTesselatedIndependentFaces<NormalVertex>(divisions);
+		benchmark::DoNotOptimize(cone.vertices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * ConeVertices::TesselatedIndependentVertexCount(divisions));
+}
+BENCHMARK(BM_ConeMake)->ArgsProduct({ { 12,24,96,1024 },{ 0,1 } })->ArgNames({ "divisions","reference" });
+
+static void BM_PlaneMake(benchmark::State& state)
+{
+	const auto divisions = int(state.range(0));
+	for (auto _ : state)
+	{
+		auto plane = Plane::MakeTesselated<PositionVertex>(divisions, divisions);
+		benchmark::DoNotOptimize(plane.vertices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * (divisions + 1) * (divisions + 1));
+}
+BENCHMARK(BM_PlaneMake)->Arg(1)->Arg(16)->Arg(64)->Arg(255);
+
+static void BM_CubeMake(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		auto cube = Cube::MakeIndependent<NormalVertex>();
+		cube.SetNormalsIndependentFlat();
+		benchmark::DoNotOptimize(cube.vertices.data());
+	}
+}
+BENCHMARK(BM_CubeMake);
+
+// transforms, the argument is the vertex count, large enough to reach the parallel chunked path
+static void BM_TransformPositions(benchmark::State& state)
+{
+	// Transform never reads the indices, one triangle keeps the list valid at any vertex count
+	IndexedTriangleList<PositionVertex> mesh(std::vector<PositionVertex>(size_t(state.range(0)), { { 1.0f,2.0f,3.0f } }), { 0,1,2 });
+	const auto matrix = dx::XMMatrixRotationRollPitchYaw(0.1f, 0.2f, 0.3f) * dx::XMMatrixTranslation(1.0f, 2.0f, 3.0f);
+	for (auto _ : state)
+	{
+		mesh.Transform(matrix);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(PositionVertex));
+}
+BENCHMARK(BM_TransformPositions)->RangeMultiplier(10)->Range(1000, 10000000)->UseRealTime();
+
+static void BM_TransformPositionsNormals(benchmark::State& state)
+{
+	IndexedTriangleList<NormalVertex> mesh(std::vector<NormalVertex>(size_t(state.range(0)), { { 1.0f,2.0f,3.0f },{ 0.0f,1.0f,0.0f } }), { 0,1,2 });
+	const auto matrix = dx::XMMatrixRotationRollPitchYaw(0.1f, 0.2f, 0.3f) * dx::XMMatrixScaling(1.0f, 2.0f, 3.0f);
+	for (auto _ : state)
+	{
+		mesh.Transform(matrix);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(NormalVertex));
+}
+BENCHMARK(BM_TransformPositionsNormals)->RangeMultiplier(10)->Range(1000, 10000000)->UseRealTime();
+
+// normals of a welded sphere, the argument is the tessellation
+static void BM_NormalsSmooth(benchmark::State& state)
+{
+	const auto divisions = int(state.range(0));
+	auto sphere = SphereVertices::MakeTesselated<NormalVertex>(divisions, divisions);
+	const auto weighting = state.range(1) != 0 ?
+		IndexedTriangleList<NormalVertex>::NormalWeighting::Angle :
+		IndexedTriangleList<NormalVertex>::NormalWeighting::Area;
+	for (auto _ : state)
+	{
+		sphere.SetNormalsSmooth(weighting);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * sphere.indices.size() / 3u);
+}
+BENCHMARK(BM_NormalsSmooth)->ArgsProduct({ { 24,96,180 },{ 0,1 } })->ArgNames({ "divisions","angle" })->UseRealTime();
+
+static void BM_NormalsFlat(benchmark::State& state)
+{
+	const auto divisions = int(state.range(0));
+	auto sphere = SphereVertices::MakeTesselatedIndependentCapNormals<NormalVertex>(divisions, divisions);
+	for (auto _ : state)
+	{
+		sphere.SetNormalsIndependentFlat();
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * sphere.indices.size() / 3u);
+}
+BENCHMARK(BM_NormalsFlat)->Arg(24)->Arg(96)->Arg(180);
+
+// welding an unindexed triangle soup back into shared vertices, argument 1 selects epsilon welding
+static void BM_Weld(benchmark::State& state)
+{
+	const auto divisions = int(state.range(0));
+	const auto sphere = SphereVertices::MakeTesselated<NormalVertex>(divisions, divisions);
+	std::vector<NormalVertex> soup;
+	soup.reserve(sphere.indices.size());
+	for (const auto i : sphere.indices)
+	{
+		soup.push_back(sphere.vertices[i]);
+	}
+	std::vector<unsigned short> indices(soup.size());
+	for (size_t i = 0u; i < indices.size(); i++)
+	{
+		indices[i] = (unsigned short)i;
+	}
+	MeshWelder::Options options;
+	options.mode = state.range(1) != 0 ? MeshWelder::Mode::Epsilon : MeshWelder::Mode::Bitwise;
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		IndexedTriangleList<NormalVertex> mesh(soup, indices);
+		state.ResumeTiming();
+		benchmark::DoNotOptimize(MeshWelder::Weld(mesh, options));
+	}
+	state.SetItemsProcessed(state.iterations() * soup.size());
+}
+// the soup of a 96 x 96 sphere is the largest that still fits 16-bit indices
+BENCHMARK(BM_Weld)->ArgsProduct({ { 24,96 },{ 0,1 } })->ArgNames({ "divisions","epsilon" });
+
+static void BM_MeshletBuild(benchmark::State& state)
+{
+	const auto divisions = int(state.range(0));
+	const auto sphere = SphereVertices::MakeTesselated<PositionVertex>(divisions, divisions);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(MeshletBuilder::Build(sphere));
+	}
+	state.SetItemsProcessed(state.iterations() * sphere.indices.size() / 3u);
+}
+BENCHMARK(BM_MeshletBuild)->Arg(24)->Arg(96)->Arg(180);
+
+// culls the meshlets of a dense sphere seen from outside, about half of it faces away
+static void BM_MeshletCull(benchmark::State& state)
+{
+	const auto divisions = int(state.range(0));
+	const auto sphere = SphereVertices::MakeTesselated<PositionVertex>(divisions, divisions);
+	const auto meshlets = MeshletBuilder::Build(sphere);
+	const dx::XMFLOAT3 camera = { 0.0f,0.0f,-4.0f };
+	const auto view = dx::XMMatrixLookAtLH(dx::XMLoadFloat3(&camera), dx::XMVectorZero(), dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	const auto frustum = MeshletBuilder::ExtractFrustum(view * dx::XMMatrixPerspectiveFovLH(0.6f, 4.0f / 3.0f, 0.5f, 40.0f));
+	std::vector<unsigned int> visible;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(MeshletBuilder::Cull(meshlets, frustum, camera, visible));
+		AdvanceFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * meshlets.meshlets.size());
+}
+BENCHMARK(BM_MeshletCull)->Arg(24)->Arg(96)->Arg(180);
@@ -0,0 +1,113 @@
+#include "BenchmarkCommon.h"
+#include "PoolAllocator.h"
+#include <benchmark/benchmark.h>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+namespace
+{
+	// about the size of a drawable with its bindable set and orbit
+	struct Payload
+	{
+		char bytes[256];
+	};
+}
+
+// spawning and tearing down a population of objects, from the pool of their type and from the heap
+// argument 1 frees in reverse order of allocation, 0 in allocation order
+static void BM_PoolSpawnTeardown(benchmark::State& state)
+{
+	auto& pool = PoolAllocator::For<Payload>();
+	std::vector<void*> objects(size_t(state.range(0)));
+	const bool reverse = state.range(1) != 0;
+	for (auto _ : state)
+	{
+		for (auto& p : objects)
+		{
+			p = pool.Allocate();
+		}
+		benchmark::ClobberMemory();
+		if (reverse)
+		{
+			for (auto i = objects.rbegin(); i != objects.rend(); ++i)
+			{
+				pool.Free(*i);
+			}
+		}
+		else
+		{
+			for (const auto p : objects)
+			{
+				pool.Free(p);
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PoolSpawnTeardown)->ArgsProduct({ { 1000,100000 },{ 0,1 } })->ArgNames({ "objects","reverse" });
+
+static void BM_HeapSpawnTeardown(benchmark::State& state)
+{
+	std::vector<void*> objects(size_t(state.range(0)));
+	const bool reverse = state.range(1) != 0;
+	for (auto _ : state)
+	{
+		for (auto& p : objects)
+		{
+			p = ::operator new(sizeof(Payload));
+		}
+		benchmark::ClobberMemory();
+		if (reverse)
+		{
+			for (auto i = objects.rbegin(); i != objects.rend(); ++i)
+			{
+				::operator delete(*i, sizeof(Payload));
+			}
+		}
+		else
+		{
+			for (const auto p : objects)
+			{
+				::operator delete(p, sizeof(Payload));
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HeapSpawnTeardown)->ArgsProduct({ { 1000,100000 },{ 0,1 } })->ArgNames({ "objects","reverse" });
+
+// per frame temporaries, a container filled and dropped every frame, from frame scratch memory and from the heap
+static void BM_ScratchVector(benchmark::State& state)
+{
+	const auto count = size_t(state.range(0));
+	for (auto _ : state)
+	{
+		std::pmr::vector<unsigned int> values(FrameAllocator::Get());
+		for (size_t i = 0u; i < count; i++)
+		{
+			values.push_back((unsigned int)i);
+		}
+		benchmark::DoNotOptimize(values.data());
+		AdvanceFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ScratchVector)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void BM_HeapVector(benchmark::State& state)
+{
+	const auto count = size_t(state.range(0));
+	for (auto _ : state)
+	{
+		std::vector<unsigned int> values;
+		for (size_t i = 0u; i < count; i++)
+		{
+			values.push_back((unsigned int)i);
+		}
+		benchmark::DoNotOptimize(values.data());
+		AdvanceFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HeapVector)->RangeMultiplier(16)->Range(16, 1 << 20);
@@ -0,0 +1,110 @@
+#include "BenchmarkCommon.h"
+#include "IndexedTriangleList.h"
+#include "MeshWelder.h"
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+	// the meshes of a model with every face corner its own vertex, the joining Model::Import asks assimp for is
+	// left to the welder; meshes that would not fit 16-bit indices are skipped as the importer rejects them
+	std::vector<IndexedTriangleList<NormalVertex>> LoadSoup(const std::string& path)
+	{
+		std::vector<IndexedTriangleList<NormalVertex>> meshes;
+		Assimp::Importer imp;
+		const auto pModel = imp.ReadFile(path, aiProcess_Triangulate | aiProcess_GenNormals);
+		if (pModel == nullptr)
+		{
+			return meshes;
+		}
+		for (unsigned int m = 0u; m < pModel->mNumMeshes; m++)
+		{
+			const auto& mesh = *pModel->mMeshes[m];
+			if (mesh.mNumVertices < 3u || mesh.mNumVertices > 0x10000u)
+			{
+				continue;
+			}
+			std::vector<NormalVertex> vertices(mesh.mNumVertices);
+			for (unsigned int i = 0u; i < mesh.mNumVertices; i++)
+			{
+				vertices[i].pos = { mesh.mVertices[i].x,mesh.mVertices[i].y,mesh.mVertices[i].z };
+				if (mesh.HasNormals())
+				{
+					vertices[i].n = { mesh.mNormals[i].x,mesh.mNormals[i].y,mesh.mNormals[i].z };
+				}
+			}
+			std::vector<unsigned short> indices;
+			indices.reserve(size_t(mesh.mNumFaces) * 3u);
+			for (unsigned int f = 0u; f < mesh.mNumFaces; f++)
+			{
+				const auto& face = mesh.mFaces[f];
+				// points and lines left over by aiProcess_Triangulate carry no surface
+				if (face.mNumIndices == 3u)
+				{
+					indices.push_back((unsigned short)face.mIndices[0]);
+					indices.push_back((unsigned short)face.mIndices[1]);
+					indices.push_back((unsigned short)face.mIndices[2]);
+				}
+			}
+			meshes.emplace_back(std::move(vertices), std::move(indices));
+		}
+		return meshes;
+	}
+
+	// welds every mesh of a model, the counters are the MeshWelder::Stats summed over the meshes
+	void WeldModel(benchmark::State& state, const std::vector<IndexedTriangleList<NormalVertex>>& meshes, MeshWelder::Mode mode)
+	{
+		MeshWelder::Options options;
+		options.mode = mode;
+		MeshWelder::Stats total;
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			auto copies = meshes;
+			total = {};
+			state.ResumeTiming();
+			for (auto& mesh : copies)
+			{
+				const auto stats = MeshWelder::Weld(mesh, options);
+				total.verticesBefore += stats.verticesBefore;
+				total.verticesAfter += stats.verticesAfter;
+				total.degenerateTriangles += stats.degenerateTriangles;
+				total.bytesSaved += stats.bytesSaved;
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * int64_t(total.verticesBefore));
+		state.counters["meshes"] = double(meshes.size());
+		state.counters["verticesBefore"] = double(total.verticesBefore);
+		state.counters["verticesAfter"] = double(total.verticesAfter);
+		state.counters["degenerateTriangles"] = double(total.degenerateTriangles);
+		state.counters["bytesSaved"] = double(total.bytesSaved);
+	}
+
+	// one benchmark per shipped model and weld mode, registered before main runs them
+	const bool modelsRegistered = []()
+	{
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(ASTRIA_MODELS_DIR, error))
+		{
+			if (entry.path().extension() != ".obj")
+			{
+				continue;
+			}
+			const auto meshes = LoadSoup(entry.path().string());
+			if (meshes.empty())
+			{
+				continue;
+			}
+			const auto name = "BM_WeldModel/" + entry.path().stem().string();
+			benchmark::RegisterBenchmark((name + "/bitwise").c_str(), WeldModel, meshes, MeshWelder::Mode::Bitwise);
+			benchmark::RegisterBenchmark((name + "/epsilon").c_str(), WeldModel, meshes, MeshWelder::Mode::Epsilon);
+		}
+		return true;
+	}();
+}
@@ -0,0 +1,245 @@
+#include "BenchmarkCommon.h"
+#include "EntityWorld.h"
+#include "ObjectComponents.h"
+#include "SceneGraph.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+namespace dx = DirectX;
+
+namespace
+{
+	// orbits drawn from the same distributions App gives its objects
+	std::vector<Orbit> MakeOrbits(size_t count)
+	{
+		std::mt19937 rng(1337u);
+		std::uniform_real_distribution<float> adist{ 0.0f,3.1415f * 2.0f };
+		std::uniform_real_distribution<float> ddist{ 0.0f,3.1415f * 2.0f };
+		std::uniform_real_distribution<float> odist{ 0.0f,3.1415f * 0.3f };
+		std::uniform_real_distribution<float> rdist{ 6.0f,20.0f };
+		std::vector<Orbit> orbits(count);
+		for (auto& orbit : orbits)
+		{
+			orbit.r = rdist(rng);
+			orbit.theta = adist(rng);
+			orbit.phi = adist(rng);
+			orbit.chi = adist(rng);
+			orbit.droll = ddist(rng);
+			orbit.dpitch = ddist(rng);
+			orbit.dyaw = ddist(rng);
+			orbit.dtheta = odist(rng);
+			orbit.dphi = odist(rng);
+			orbit.dchi = odist(rng);
+		}
+		return orbits;
+	}
+
+	// a tag component for the structural change benchmarks
+	struct Selected
+	{
+		unsigned int group;
+	};
+}
+
+// what ObjectBase::Update does for an object not attached to a world, one object after the other
+static void BM_OrbitAdvance(benchmark::State& state)
+{
+	auto orbits = MakeOrbits(size_t(state.range(0)));
+	for (auto _ : state)
+	{
+		for (auto& orbit : orbits)
+		{
+			orbit.Advance(1.0f / 60.0f);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OrbitAdvance)->RangeMultiplier(10)->Range(100, 100000);
+
+// the matrices built per object and frame: the orbit transform, then the transposed model-view-projection of TransformCbuf
+static void BM_MatrixBuild(benchmark::State& state)
+{
+	const auto orbits = MakeOrbits(size_t(state.range(0)));
+	std::vector<dx::XMFLOAT4X4> results(orbits.size());
+	const auto camera = dx::XMMatrixTranslation(0.0f, 0.0f, 20.0f);
+	const auto projection = dx::XMMatrixPerspectiveLH(1.0f, 3.0f / 4.0f, 0.5f, 40.0f);
+	for (auto _ : state)
+	{
+		for (size_t i = 0u; i < orbits.size(); i++)
+		{
+			dx::XMStoreFloat4x4(&results[i], dx::XMMatrixTranspose(orbits[i].GetTransformXM() * camera * projection));
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MatrixBuild)->RangeMultiplier(10)->Range(100, 100000);
+
+// the scene graph under a changed root, every node is recomputed
+// wide: every node is a child of the root, a single level
+static void BM_SceneGraphWide(benchmark::State& state)
+{
+	SceneGraph graph;
+	const auto root = graph.AddNode(SceneGraph::none, dx::XMMatrixIdentity());
+	for (int64_t i = 1; i < state.range(0); i++)
+	{
+		graph.AddNode(root, dx::XMMatrixTranslation(float(i), 0.0f, 0.0f));
+	}
+	float angle = 0.0f;
+	for (auto _ : state)
+	{
+		graph.SetLocalTransform(root, dx::XMMatrixRotationY(angle += 0.01f));
+		benchmark::DoNotOptimize(graph.Update());
+		AdvanceFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneGraphWide)->RangeMultiplier(10)->Range(1000, 1000000)->UseRealTime();
+
+// deep: a full binary tree, the argument is its depth
+static void BM_SceneGraphDeep(benchmark::State& state)
+{
+	SceneGraph graph;
+	const auto root = graph.AddNode(SceneGraph::none, dx::XMMatrixIdentity());
+	std::vector<SceneGraph::Handle> level = { root };
+	for (int64_t depth = 1; depth < state.range(0); depth++)
+	{
+		std::vector<SceneGraph::Handle> next;
+		next.reserve(level.size() * 2u);
+		for (const auto parent : level)
+		{
+			next.push_back(graph.AddNode(parent, dx::XMMatrixTranslation(-1.0f, 1.0f, 0.0f)));
+			next.push_back(graph.AddNode(parent, dx::XMMatrixTranslation(1.0f, 1.0f, 0.0f)));
+		}
+		level = std::move(next);
+	}
+	float angle = 0.0f;
+	for (auto _ : state)
+	{
+		graph.SetLocalTransform(root, dx::XMMatrixRotationY(angle += 0.01f));
+		benchmark::DoNotOptimize(graph.Update());
+		AdvanceFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * int64_t(graph.GetNodeCount()));
+	state.counters["nodes"] = double(graph.GetNodeCount());
+}
+BENCHMARK(BM_SceneGraphDeep)->DenseRange(11, 20, 3)->UseRealTime();
+
+// a chain, one node per level, nothing to split across threads
+static void BM_SceneGraphChain(benchmark::State& state)
+{
+	SceneGraph graph;
+	auto node = graph.AddNode(SceneGraph::none, dx::XMMatrixIdentity());
+	const auto root = node;
+	for (int64_t i = 1; i < state.range(0); i++)
+	{
+		node = graph.AddNode(node, dx::XMMatrixTranslation(0.0f, 0.001f, 0.0f));
+	}
+	float angle = 0.0f;
+	for (auto _ : state)
+	{
+		graph.SetLocalTransform(root, dx::XMMatrixRotationY(angle += 0.01f));
+		benchmark::DoNotOptimize(graph.Update());
+		AdvanceFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneGraphChain)->RangeMultiplier(10)->Range(1000, 100000)->UseRealTime();
+
+// a single changed leaf in a wide graph, what is left is the cost of finding nothing else to do
+static void BM_SceneGraphOneDirty(benchmark::State& state)
+{
+	SceneGraph graph;
+	const auto root = graph.AddNode(SceneGraph::none, dx::XMMatrixIdentity());
+	SceneGraph::Handle leaf = root;
+	for (int64_t i = 1; i < state.range(0); i++)
+	{
+		leaf = graph.AddNode(root, dx::XMMatrixTranslation(float(i), 0.0f, 0.0f));
+	}
+	graph.Update();
+	float x = 0.0f;
+	for (auto _ : state)
+	{
+		graph.SetLocalTransform(leaf, dx::XMMatrixTranslation(x += 0.01f, 0.0f, 0.0f));
+		benchmark::DoNotOptimize(graph.Update());
+		AdvanceFrame();
+	}
+}
+BENCHMARK(BM_SceneGraphOneDirty)->RangeMultiplier(10)->Range(1000, 1000000)->UseRealTime();
+
+// the orbit update as ObjectSystems::Animate runs it, over the chunks of the entity world
+static void BM_EntityAnimate(benchmark::State& state)
+{
+	EntityWorld world;
+	for (const auto& orbit : MakeOrbits(size_t(state.range(0))))
+	{
+		world.Create(orbit, WorldTransform{});
+	}
+	const bool parallel = state.range(1) != 0;
+	const auto animate = [](Orbit& orbit, WorldTransform& placement)
+	{
+		orbit.Advance(1.0f / 60.0f);
+		dx::XMStoreFloat4x4(&placement.transform, orbit.GetTransformXM());
+	};
+	for (auto _ : state)
+	{
+		if (parallel)
+		{
+			world.ParallelForEach<Orbit, WorldTransform>(animate);
+		}
+		else
+		{
+			world.ForEach<Orbit, WorldTransform>(animate);
+		}
+		AdvanceFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntityAnimate)->ArgsProduct({ { 1000,10000,100000,1000000 },{ 0,1 } })->ArgNames({ "entities","parallel" })->UseRealTime();
+
+// adds and then removes a component on every entity, two archetype moves each
+static void BM_EntityStructuralChange(benchmark::State& state)
+{
+	EntityWorld world;
+	std::vector<Entity> entities;
+	for (const auto& orbit : MakeOrbits(size_t(state.range(0))))
+	{
+		entities.push_back(world.Create(orbit, WorldTransform{}));
+	}
+	for (auto _ : state)
+	{
+		for (const auto entity : entities)
+		{
+			world.Add(entity, Selected{ 1u });
+		}
+		for (const auto entity : entities)
+		{
+			world.Remove<Selected>(entity);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_EntityStructuralChange)->RangeMultiplier(10)->Range(1000, 100000);
+
+// spawns a population and tears it down again, the world is reused so freed indices and chunks come back
+static void BM_EntitySpawnTeardown(benchmark::State& state)
+{
+	EntityWorld world;
+	const auto orbits = MakeOrbits(size_t(state.range(0)));
+	std::vector<Entity> entities(orbits.size());
+	for (auto _ : state)
+	{
+		for (size_t i = 0u; i < orbits.size(); i++)
+		{
+			entities[i] = world.Create(orbits[i], WorldTransform{});
+		}
+		for (const auto entity : entities)
+		{
+			world.Destroy(entity);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntitySpawnTeardown)->RangeMultiplier(10)->Range(1000, 100000);
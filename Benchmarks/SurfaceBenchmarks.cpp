@@ -0,0 +1,186 @@
+#include "BenchmarkCommon.h"
+#include "ImageCodec.h"
+#include "Surface.h"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	// every kernel runs on each path the cpu supports, the first argument of a benchmark picks it
+	bool UsePath(benchmark::State& state)
+	{
+		const auto path = SurfaceSimd::Path(state.range(0));
+		if (path > SurfaceSimd::GetBestSupportedPath())
+		{
+			state.SkipWithError("path not supported by this cpu");
+			return false;
+		}
+		SurfaceSimd::SetPath(path);
+		state.SetLabel(SurfaceSimd::GetPathName(path));
+		return true;
+	}
+
+	// a gradient with varying alpha so blending and compression have something to chew on
+	Surface MakeGradient(unsigned int width, unsigned int height)
+	{
+		Surface s(width, height);
+		for (unsigned int y = 0u; y < height; y++)
+		{
+			for (unsigned int x = 0u; x < width; x++)
+			{
+				s.PutPixel(x, y, { (unsigned char)(x ^ y),(unsigned char)x,(unsigned char)y,(unsigned char)(x + y) });
+			}
+		}
+		return s;
+	}
+
+	void SetPixelsProcessed(benchmark::State& state, int64_t pixels)
+	{
+		state.SetItemsProcessed(state.iterations() * pixels);
+		state.SetBytesProcessed(state.iterations() * pixels * int64_t(sizeof(Surface::Color)));
+	}
+}
+
+static void BM_SurfaceClear(benchmark::State& state)
+{
+	if (!UsePath(state))
+	{
+		return;
+	}
+	const auto size = (unsigned int)state.range(1);
+	Surface s(size, size);
+	for (auto _ : state)
+	{
+		s.Clear({ 255,40,80,120 });
+		benchmark::ClobberMemory();
+	}
+	SetPixelsProcessed(state, int64_t(size) * size);
+}
+BENCHMARK(BM_SurfaceClear)->ArgsProduct({ { 0,1,2 },{ 256,2048 } })->ArgNames({ "path","size" });
+
+static void BM_SurfaceFill(benchmark::State& state)
+{
+	if (!UsePath(state))
+	{
+		return;
+	}
+	const auto size = (unsigned int)state.range(1);
+	Surface s(size, size);
+	// odd offsets so rows start unaligned
+	const Surface::Rect rect = { 3,5,int(size) - 7,int(size) - 2 };
+	for (auto _ : state)
+	{
+		s.Fill(rect, { 255,40,80,120 });
+		benchmark::ClobberMemory();
+	}
+	SetPixelsProcessed(state, int64_t(rect.right - rect.left) * (rect.bottom - rect.top));
+}
+BENCHMARK(BM_SurfaceFill)->ArgsProduct({ { 0,1,2 },{ 256,2048 } })->ArgNames({ "path","size" });
+
+static void BM_SurfaceBlit(benchmark::State& state)
+{
+	if (!UsePath(state))
+	{
+		return;
+	}
+	const auto size = (unsigned int)state.range(1);
+	Surface dst(size, size);
+	const auto src = MakeGradient(size / 2u, size / 2u);
+	for (auto _ : state)
+	{
+		dst.Blit(src, 3, 5);
+		benchmark::ClobberMemory();
+	}
+	SetPixelsProcessed(state, int64_t(src.GetWidth()) * src.GetHeight());
+}
+BENCHMARK(BM_SurfaceBlit)->ArgsProduct({ { 0,1,2 },{ 256,2048 } })->ArgNames({ "path","size" });
+
+static void BM_SurfaceBlitBlend(benchmark::State& state)
+{
+	if (!UsePath(state))
+	{
+		return;
+	}
+	const auto size = (unsigned int)state.range(1);
+	auto dst = MakeGradient(size, size);
+	const auto src = MakeGradient(size / 2u, size / 2u);
+	for (auto _ : state)
+	{
+		dst.BlitBlend(src, 3, 5);
+		benchmark::ClobberMemory();
+	}
+	SetPixelsProcessed(state, int64_t(src.GetWidth()) * src.GetHeight());
+}
+BENCHMARK(BM_SurfaceBlitBlend)->ArgsProduct({ { 0,1,2 },{ 256,2048 } })->ArgNames({ "path","size" });
+
+// halving and doubling a 1024 square, argument 2 is the filter
+static void BM_SurfaceResample(benchmark::State& state)
+{
+	if (!UsePath(state))
+	{
+		return;
+	}
+	const auto src = MakeGradient(1024u, 1024u);
+	const auto size = (unsigned int)state.range(1);
+	const auto filter = SurfaceSimd::Filter(state.range(2));
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(src.Resampled(size, size, filter));
+	}
+	SetPixelsProcessed(state, int64_t(size) * size);
+}
+BENCHMARK(BM_SurfaceResample)->ArgsProduct({ { 0,1,2 },{ 512,2048 },{ 0,1 } })->ArgNames({ "path","size","filter" })->UseRealTime();
+
+static void BM_SurfaceToRGBA8(benchmark::State& state)
+{
+	if (!UsePath(state))
+	{
+		return;
+	}
+	const auto src = MakeGradient(1024u, 1024u);
+	std::vector<unsigned char> rgba(size_t(1024u) * 1024u * 4u);
+	for (auto _ : state)
+	{
+		src.ToRGBA8(rgba.data());
+		benchmark::ClobberMemory();
+	}
+	SetPixelsProcessed(state, 1024 * 1024);
+}
+BENCHMARK(BM_SurfaceToRGBA8)->DenseRange(0, 2)->ArgName("path");
+
+static void BM_SurfaceToFloat(benchmark::State& state)
+{
+	if (!UsePath(state))
+	{
+		return;
+	}
+	const auto src = MakeGradient(1024u, 1024u);
+	std::vector<float> rgba(size_t(1024u) * 1024u * 4u);
+	for (auto _ : state)
+	{
+		src.ToFloatRGBA(rgba.data());
+		benchmark::ClobberMemory();
+	}
+	SetPixelsProcessed(state, 1024 * 1024);
+}
+BENCHMARK(BM_SurfaceToFloat)->DenseRange(0, 2)->ArgName("path");
+
+// encoders behind Surface::Save and frame captures, the argument is the format
+static void BM_ImageEncode(benchmark::State& state)
+{
+	const auto format = ImageCodec::Format(state.range(0));
+	const auto src = MakeGradient(1024u, 768u);
+	size_t bytes = 0u;
+	for (auto _ : state)
+	{
+		const auto data = ImageCodec::Encode(format, reinterpret_cast<const unsigned int*>(src.GetBufferPtr()), src.GetWidth(), src.GetHeight());
+		bytes = data.size();
+		benchmark::DoNotOptimize(data.data());
+	}
+	SetPixelsProcessed(state, 1024 * 768);
+	state.counters["encodedBytes"] = double(bytes);
+}
+BENCHMARK(BM_ImageEncode)
+	->Arg(int(ImageCodec::Format::BMP))
+	->Arg(int(ImageCodec::Format::PNG))
+	->Arg(int(ImageCodec::Format::QOI))
+	->ArgName("format");
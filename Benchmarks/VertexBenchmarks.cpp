@@ -0,0 +1,192 @@
+#include "BenchmarkCommon.h"
+#include "Vertex.h"
+#include "VertexQuantizer.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace dx = DirectX;
+using as3dexp::VertexLayout;
+
+namespace
+{
+	// the layout of the textured drawables
+	VertexLayout MakeLayout()
+	{
+		return VertexLayout{}
+			.Append(VertexLayout::Position3D)
+			.Append(VertexLayout::Normal)
+			.Append(VertexLayout::Texture2D);
+	}
+	using StaticLayout = as3dexp::StaticVertexLayout<VertexLayout::Position3D, VertexLayout::Normal, VertexLayout::Texture2D>;
+	// what the static layout is meant to match, a plain struct written member by member
+	struct RawVertex
+	{
+		dx::XMFLOAT3 pos;
+		dx::XMFLOAT3 n;
+		dx::XMFLOAT2 tc;
+	};
+
+	dx::XMFLOAT3 PositionOf(size_t i) noexcept
+	{
+		return { float(i % 1000u),float(i / 1000u),float(i & 7u) };
+	}
+	dx::XMFLOAT2 TexcoordOf(size_t i) noexcept
+	{
+		return { float(i % 1000u) / 1000.0f,float(i & 255u) / 256.0f };
+	}
+}
+
+// filling a dynamic buffer one vertex at a time, argument 1 reserves up front
+static void BM_VertexEmplaceBack(benchmark::State& state)
+{
+	const auto count = size_t(state.range(0));
+	const bool reserve = state.range(1) != 0;
+	for (auto _ : state)
+	{
+		as3dexp::VertexBuffer vbuf(MakeLayout());
+		if (reserve)
+		{
+			vbuf.Reserve(count);
+		}
+		for (size_t i = 0u; i < count; i++)
+		{
+			vbuf.EmplaceBack(PositionOf(i), dx::XMFLOAT3{ 0.0f,1.0f,0.0f }, TexcoordOf(i));
+		}
+		benchmark::DoNotOptimize(vbuf.GetData());
+		state.counters["reallocations"] = double(vbuf.GetReallocationCount());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VertexEmplaceBack)->ArgsProduct({ { 1000,100000,1000000,10000000 },{ 0,1 } })->ArgNames({ "vertices","reserve" });
+
+// the same fill as whole attribute streams, from arrays and from generators
+static void BM_VertexWriteStreams(benchmark::State& state)
+{
+	const auto count = size_t(state.range(0));
+	std::vector<dx::XMFLOAT3> positions(count);
+	std::vector<dx::XMFLOAT3> normals(count, { 0.0f,1.0f,0.0f });
+	for (size_t i = 0u; i < count; i++)
+	{
+		positions[i] = PositionOf(i);
+	}
+	for (auto _ : state)
+	{
+		as3dexp::VertexBuffer vbuf(MakeLayout());
+		vbuf.Resize(count);
+		vbuf.WriteStream<VertexLayout::Position3D>(positions.data(), count);
+		vbuf.WriteStream<VertexLayout::Normal>(normals.data(), count);
+		vbuf.GenerateStream<VertexLayout::Texture2D>(count, TexcoordOf);
+		benchmark::DoNotOptimize(vbuf.GetData());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VertexWriteStreams)->RangeMultiplier(10)->Range(1000, 1000000)->UseRealTime();
+
+static void BM_VertexParallelFill(benchmark::State& state)
+{
+	const auto count = size_t(state.range(0));
+	as3dexp::VertexBuffer vbuf(MakeLayout());
+	vbuf.Resize(count);
+	for (auto _ : state)
+	{
+		vbuf.ParallelFill([](as3dexp::Vertex v, size_t i)
+		{
+			v.Attr<VertexLayout::Position3D>() = PositionOf(i);
+			v.Attr<VertexLayout::Normal>() = { 0.0f,1.0f,0.0f };
+			v.Attr<VertexLayout::Texture2D>() = TexcoordOf(i);
+		});
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VertexParallelFill)->RangeMultiplier(10)->Range(1000, 1000000)->UseRealTime();
+
+// the compile time layout, attribute offsets are constants
+static void BM_StaticVertexEmplaceBack(benchmark::State& state)
+{
+	const auto count = size_t(state.range(0));
+	for (auto _ : state)
+	{
+		as3dexp::StaticVertexBuffer<StaticLayout> vbuf;
+		vbuf.Reserve(count);
+		for (size_t i = 0u; i < count; i++)
+		{
+			vbuf.EmplaceBack(PositionOf(i), dx::XMFLOAT3{ 0.0f,1.0f,0.0f }, TexcoordOf(i));
+		}
+		benchmark::DoNotOptimize(vbuf.GetData());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StaticVertexEmplaceBack)->RangeMultiplier(10)->Range(1000, 10000000);
+
+static void BM_RawVertexEmplaceBack(benchmark::State& state)
+{
+	const auto count = size_t(state.range(0));
+	for (auto _ : state)
+	{
+		std::vector<RawVertex> vertices;
+		vertices.reserve(count);
+		for (size_t i = 0u; i < count; i++)
+		{
+			vertices.push_back({ PositionOf(i),{ 0.0f,1.0f,0.0f },TexcoordOf(i) });
+		}
+		benchmark::DoNotOptimize(vertices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RawVertexEmplaceBack)->RangeMultiplier(10)->Range(1000, 10000000);
+
+// a position only pass, bounds over every position, reading the interleaved buffer or slot 0 of the split streams
+// argument 1 reads the position stream, 0 strides over the full vertices and drags the other attributes through the cache
+static void BM_PositionPass(benchmark::State& state)
+{
+	const auto count = size_t(state.range(0));
+	const bool split = state.range(1) != 0;
+	as3dexp::VertexBuffer vbuf(MakeLayout()
+		.Append(VertexLayout::Tangent)
+		.Append(VertexLayout::Bitangent));
+	vbuf.Resize(count);
+	vbuf.GenerateStream<VertexLayout::Position3D>(count, PositionOf);
+	const auto streams = as3dexp::VertexStreams::SplitPositions(vbuf);
+	const auto& source = split ? streams.GetStream(0u) : vbuf;
+	const size_t stride = source.GetLayout().Size();
+	const char* const pPositions = source.GetData() + source.GetLayout().Resolve<VertexLayout::Position3D>().GetOffset();
+	for (auto _ : state)
+	{
+		dx::XMFLOAT3 lo = { 1e30f,1e30f,1e30f };
+		dx::XMFLOAT3 hi = { -1e30f,-1e30f,-1e30f };
+		for (size_t i = 0u; i < count; i++)
+		{
+			dx::XMFLOAT3 p;
+			std::memcpy(&p, pPositions + i * stride, sizeof(p));
+			lo = { std::min(lo.x,p.x),std::min(lo.y,p.y),std::min(lo.z,p.z) };
+			hi = { std::max(hi.x,p.x),std::max(hi.y,p.y),std::max(hi.z,p.z) };
+		}
+		benchmark::DoNotOptimize(lo);
+		benchmark::DoNotOptimize(hi);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * state.range(0) * int64_t(stride));
+	state.counters["stride"] = double(stride);
+}
+// from cache resident to well past the last level cache, the largest keeps both copies under a gigabyte
+BENCHMARK(BM_PositionPass)->ArgsProduct({ { 10000,1000000,8000000 },{ 0,1 } })->ArgNames({ "vertices","split" })->UseRealTime();
+
+static void BM_VertexQuantize(benchmark::State& state)
+{
+	const auto count = size_t(state.range(0));
+	as3dexp::VertexBuffer vbuf(MakeLayout());
+	vbuf.Reserve(count);
+	for (size_t i = 0u; i < count; i++)
+	{
+		vbuf.EmplaceBack(PositionOf(i), dx::XMFLOAT3{ 0.0f,1.0f,0.0f }, TexcoordOf(i));
+	}
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(VertexQuantizer::Quantize(vbuf));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VertexQuantize)->RangeMultiplier(10)->Range(1000, 1000000);